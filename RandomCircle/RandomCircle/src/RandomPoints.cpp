@@ -43,11 +43,18 @@
 #include <maya/MDataHandle.h>
 
 #include <maya/MFnNumericAttribute.h>
+#include <maya/MFnEnumAttribute.h>
 #include <maya/MFnPlugin.h>
 #include <maya/MFnDependencyNode.h>
 
 #include <maya/MPoint.h>
+#include <maya/MPointArray.h>
 #include <maya/MMatrix.h>
+#include <maya/MThreadUtils.h>
+
+#include <maya/MGlobal.h>
+
+#include "TwistKernels.h"
 
 
 #define McheckErr(stat,msg)		\
@@ -78,6 +85,7 @@ public:
   // yTwist attributes
   //
   static  MObject     angle;  		// angle to twist
+  static  MObject     mode;   		// exact or fast sine and cosine
 
   static  MTypeId		id;
 
@@ -87,11 +95,23 @@ private:
 
 MTypeId     yTwist::id(0x001386c6);
 
+// below this many points the threads cost more than they save
+//
+static const int kParallelThreshold = 8192;
+
 ////////////////////////
 // yTwist attributes  //
 ////////////////////////
 
 MObject     yTwist::angle;
+MObject     yTwist::mode;
+
+// values of the mode attribute
+//
+enum TwistMode {
+  kExact = 0,		// C library sine and cosine; same result as the scalar loop
+  kFast = 1			// SIMD sine and cosine, see SinCos.h for the error
+};
 
 
 yTwist::yTwist()
@@ -118,6 +138,38 @@ void* yTwist::creator()
   return new yTwist();
 }
 
+static void twistPoints(MPointArray& points, double magnitude, double env, short twistMode)
+//
+//	Description:
+//		twists every point of the array, spreading the blocks over Maya's
+//		OpenMP threads
+//
+{
+  const int count = static_cast<int>(points.length());
+  if (0 == count) {
+    return;
+  }
+
+  // exact mode stays on the SSE2 kernels, see TwistKernels.h
+  //
+  const bool fast = kFast == twistMode;
+  void (*twistBlock)(double*, int, double, double, bool) =
+    fast ? twistKernels().twistBlock : kTwistKernelsSSE2.twistBlock;
+
+  MPoint* data = &points[0];
+  const int blockCount = (count + kTwistBlockSize - 1) / kTwistBlockSize;
+
+  MThreadUtils::syncNumOpenMPThreads();
+
+  int block;
+#pragma omp parallel for schedule(static) if (count >= kParallelThreshold)
+  for (block = 0; block < blockCount; block++) {
+    const int first = block * kTwistBlockSize;
+    const int size = count - first < kTwistBlockSize ? count - first : kTwistBlockSize;
+    twistBlock(&data[first].x, size, magnitude, env, fast);
+  }
+}
+
 MStatus yTwist::initialize()
 //
 //	Description:
@@ -132,9 +184,17 @@ MStatus yTwist::initialize()
   nAttr.setKeyable(true);
   addAttribute(angle);
 
+  MFnEnumAttribute eAttr;
+  mode = eAttr.create("mode", "md", kExact);
+  eAttr.addField("exact", kExact);
+  eAttr.addField("fast", kFast);
+  eAttr.setKeyable(false);
+  addAttribute(mode);
+
   // affects
   //
   attributeAffects(yTwist::angle, yTwist::outputGeom);
+  attributeAffects(yTwist::mode, yTwist::outputGeom);
 
   return MS::kSuccess;
 }
@@ -171,25 +231,23 @@ yTwist::deform(MDataBlock& block,
   McheckErr(status, "Error getting envelope data handle\n");
   float env = envData.asFloat();
 
-  // iterate through each point in the geometry
+  // determine whether sine and cosine may be approximated
   //
-  for (; !iter.isDone(); iter.next()) {
-
-    MPoint pt = iter.position();
-
-    // do the twist
-    //
-    double ff = magnitude * pt.y * env;
-    if (ff != 0.0) {
-      double cct = cos(ff);
-      double cst = sin(ff);
-      double tt = pt.x * cct - pt.z * cst;
-      pt.z = pt.x * cst + pt.z * cct;
-      pt.x = tt;;
-    }
-
-    iter.setPosition(pt);
-  }
+  MDataHandle modeData = block.inputValue(mode, &status);
+  McheckErr(status, "Error getting mode data handle\n");
+  short twistMode = modeData.asShort();
+
+  // fetch every point in one call, twist them all, and write them back in
+  // one call, rather than going through the iterator per point
+  //
+  MPointArray points;
+  status = iter.allPositions(points);
+  McheckErr(status, "Error getting positions\n");
+
+  twistPoints(points, magnitude, env, twistMode);
+
+  status = iter.setAllPositions(points);
+  McheckErr(status, "Error setting positions\n");
   return status;
 }
 
@@ -200,6 +258,15 @@ MStatus initializePlugin(MObject obj)
 {
   MStatus result;
   MFnPlugin plugin(obj, PLUGIN_COMPANY, "3.0", "Any");
+
+  // pick the kernels for the instruction sets of this machine, once
+  //
+  bool forced = false;
+  const CpuLevel level = chooseCpuLevel(forced);
+  selectTwistKernels(level);
+  MGlobal::displayInfo(MString("yTwist: using ") + cpuLevelName(level) +
+                       (forced ? " kernels (forced by XC_CPU_LEVEL)" : " kernels"));
+
   result = plugin.registerNode("yTwist", yTwist::id, yTwist::creator,
                                 yTwist::initialize, MPxNode::kDeformerNode);
   return result;
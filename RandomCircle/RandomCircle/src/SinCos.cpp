@@ -0,0 +1,37 @@
+////////////////////////////////////////////////////////////////////////
+// DESCRIPTION:
+//
+// Implementation of sinCosExact() and sinCosFast(), see SinCos.h.  The
+// fast version runs the kernel compiled for the instruction set chosen at
+// plug-in load, see TwistKernels.h.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "SinCos.h"
+#include "TwistKernels.h"
+
+#include <math.h>
+
+
+void sinCosExact(const double* angles, double* sines, double* cosines, int count)
+//
+//	Description:
+//		sine and cosine of every angle, from the C library
+//
+{
+  int i;
+  for (i = 0; i < count; i++) {
+    sines[i] = sin(angles[i]);
+    cosines[i] = cos(angles[i]);
+  }
+}
+
+void sinCosFast(const double* angles, double* sines, double* cosines, int count)
+//
+//	Description:
+//		sine and cosine of every angle, several at a time; see SinCos.h for
+//		the error bounds
+//
+{
+  twistKernels().sinCosFast(angles, sines, cosines, count);
+}
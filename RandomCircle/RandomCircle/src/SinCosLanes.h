@@ -0,0 +1,268 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+// DESCRIPTION:
+//
+// The sinCosFast() algorithm, written once in sinCosLanes() against a
+// small set of lane operations.  Lanes is the widest lane type of the
+// instruction set the including file is compiled for; Scalar, the one lane
+// version, handles the last few angles so that they get exactly the same
+// arithmetic as the rest.
+//
+// Only the TwistKernels<level>.cpp files include this.  Everything is in an
+// anonymous namespace so that the copies compiled for different
+// instruction sets never merge at link time.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <immintrin.h>
+
+namespace {
+
+// 2/pi, and pi/2 split into three parts; the first two have few enough
+// significant bits that multiplying them by a quadrant number below 2^20
+// is exact
+//
+const double kTwoOverPi = 6.36619772367581382433e-01;
+const double kPiOver2A = 1.57079625129699707031e+00;
+const double kPiOver2B = 7.54978941586159635335e-08;
+const double kPiOver2C = 5.39030285815811905290e-15;
+
+// adding this rounds a double below 2^51 to an integer, which then sits in
+// the low bits of the sum's mantissa
+//
+const double kRoundMagic = 6755399441055744.0;    // 1.5 * 2^52
+
+// largest angle handled by the reduction
+//
+const double kMaxAngle = 1048576.0;                // 2^20
+
+// fdlibm __kernel_sin and __kernel_cos coefficients
+//
+const double kS1 = -1.66666666666666324348e-01;
+const double kS2 = 8.33333333332248946124e-03;
+const double kS3 = -1.98412698298579493134e-04;
+const double kS4 = 2.75573137070700676789e-06;
+const double kS5 = -2.50507602534068634195e-08;
+const double kS6 = 1.58969099521155010221e-10;
+
+const double kC1 = 4.16666666666666019037e-02;
+const double kC2 = -1.38888888888741095749e-03;
+const double kC3 = 2.48015872894767294178e-05;
+const double kC4 = -2.75573143513906633035e-07;
+const double kC5 = 2.08757232129817482790e-09;
+const double kC6 = -1.13596475577881948265e-11;
+
+
+// Lane operations.  Every lane type offers
+//   kLanes, load, store, set, add, sub, mul,
+//   inRange(x)            - true if every lane is within kMaxAngle
+//   bitAnd/bitXor         - on the raw bits
+//   oddMask(q)            - all ones in lanes whose integer q is odd
+//   signOf2(q)            - the sign bit in lanes where q & 2 is set
+//   select(mask, a, b)    - a where mask is set, b elsewhere
+//
+struct Scalar {
+  typedef double Type;
+  static const int kLanes = 1;
+
+  static Type load(const double* p) { return *p; }
+  static void store(double* p, Type v) { *p = v; }
+  static Type set(double v) { return v; }
+  static Type add(Type a, Type b) { return a + b; }
+  static Type sub(Type a, Type b) { return a - b; }
+  static Type mul(Type a, Type b) { return a * b; }
+  static bool inRange(Type x) { return fabs(x) <= kMaxAngle; }
+
+  static uint64_t bits(Type v) { uint64_t b; memcpy(&b, &v, sizeof(b)); return b; }
+  static Type fromBits(uint64_t b) { Type v; memcpy(&v, &b, sizeof(v)); return v; }
+  static Type bitXor(Type a, Type b) { return fromBits(bits(a) ^ bits(b)); }
+  static Type oddMask(Type q) { return fromBits(0 - (bits(q) & 1)); }
+  static Type signOf2(Type q) { return fromBits((bits(q) & 2) << 62); }
+  static Type select(Type mask, Type a, Type b) { return 0 != bits(mask) ? a : b; }
+};
+
+#if defined(__AVX512F__)
+
+struct Lanes {
+  typedef __m512d Type;
+  static const int kLanes = 8;
+
+  static Type load(const double* p) { return _mm512_loadu_pd(p); }
+  static void store(double* p, Type v) { _mm512_storeu_pd(p, v); }
+  static Type set(double v) { return _mm512_set1_pd(v); }
+  static Type add(Type a, Type b) { return _mm512_add_pd(a, b); }
+  static Type sub(Type a, Type b) { return _mm512_sub_pd(a, b); }
+  static Type mul(Type a, Type b) { return _mm512_mul_pd(a, b); }
+  static bool inRange(Type x)
+  {
+    return 0xFF == _mm512_cmp_pd_mask(_mm512_abs_pd(x), set(kMaxAngle), _CMP_LE_OQ);
+  }
+
+  static Type bitXor(Type a, Type b)
+  {
+    return _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(a), _mm512_castpd_si512(b)));
+  }
+  static Type oddMask(Type q)
+  {
+    const __m512i odd = _mm512_and_si512(_mm512_castpd_si512(q), _mm512_set1_epi64(1));
+    return _mm512_castsi512_pd(_mm512_sub_epi64(_mm512_setzero_si512(), odd));
+  }
+  static Type signOf2(Type q)
+  {
+    const __m512i two = _mm512_and_si512(_mm512_castpd_si512(q), _mm512_set1_epi64(2));
+    return _mm512_castsi512_pd(_mm512_slli_epi64(two, 62));
+  }
+  static Type select(Type mask, Type a, Type b)
+  {
+    const __mmask8 m = _mm512_test_epi64_mask(_mm512_castpd_si512(mask), _mm512_castpd_si512(mask));
+    return _mm512_mask_blend_pd(m, b, a);
+  }
+};
+
+#elif defined(__AVX2__)
+
+struct Lanes {
+  typedef __m256d Type;
+  static const int kLanes = 4;
+
+  static Type load(const double* p) { return _mm256_loadu_pd(p); }
+  static void store(double* p, Type v) { _mm256_storeu_pd(p, v); }
+  static Type set(double v) { return _mm256_set1_pd(v); }
+  static Type add(Type a, Type b) { return _mm256_add_pd(a, b); }
+  static Type sub(Type a, Type b) { return _mm256_sub_pd(a, b); }
+  static Type mul(Type a, Type b) { return _mm256_mul_pd(a, b); }
+  static bool inRange(Type x)
+  {
+    const Type magnitude = _mm256_andnot_pd(set(-0.0), x);
+    return 0xF == _mm256_movemask_pd(_mm256_cmp_pd(magnitude, set(kMaxAngle), _CMP_LE_OQ));
+  }
+
+  static Type bitXor(Type a, Type b) { return _mm256_xor_pd(a, b); }
+  static Type oddMask(Type q)
+  {
+    const __m256i odd = _mm256_and_si256(_mm256_castpd_si256(q), _mm256_set1_epi64x(1));
+    return _mm256_castsi256_pd(_mm256_sub_epi64(_mm256_setzero_si256(), odd));
+  }
+  static Type signOf2(Type q)
+  {
+    const __m256i two = _mm256_and_si256(_mm256_castpd_si256(q), _mm256_set1_epi64x(2));
+    return _mm256_castsi256_pd(_mm256_slli_epi64(two, 62));
+  }
+  static Type select(Type mask, Type a, Type b) { return _mm256_blendv_pd(b, a, mask); }
+};
+
+#elif defined(__SSE2__) || defined(_M_X64)
+
+struct Lanes {
+  typedef __m128d Type;
+  static const int kLanes = 2;
+
+  static Type load(const double* p) { return _mm_loadu_pd(p); }
+  static void store(double* p, Type v) { _mm_storeu_pd(p, v); }
+  static Type set(double v) { return _mm_set1_pd(v); }
+  static Type add(Type a, Type b) { return _mm_add_pd(a, b); }
+  static Type sub(Type a, Type b) { return _mm_sub_pd(a, b); }
+  static Type mul(Type a, Type b) { return _mm_mul_pd(a, b); }
+  static bool inRange(Type x)
+  {
+    const Type magnitude = _mm_andnot_pd(set(-0.0), x);
+    return 0x3 == _mm_movemask_pd(_mm_cmple_pd(magnitude, set(kMaxAngle)));
+  }
+
+  static Type bitXor(Type a, Type b) { return _mm_xor_pd(a, b); }
+  static Type oddMask(Type q)
+  {
+    const __m128i odd = _mm_and_si128(_mm_castpd_si128(q), _mm_set1_epi64x(1));
+    return _mm_castsi128_pd(_mm_sub_epi64(_mm_setzero_si128(), odd));
+  }
+  static Type signOf2(Type q)
+  {
+    const __m128i two = _mm_and_si128(_mm_castpd_si128(q), _mm_set1_epi64x(2));
+    return _mm_castsi128_pd(_mm_slli_epi64(two, 62));
+  }
+  static Type select(Type mask, Type a, Type b)
+  {
+    return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+  }
+};
+
+#else
+
+typedef Scalar Lanes;
+
+#endif
+
+
+template <class V>
+void sinCosLanes(const double* angles, double* sines, double* cosines)
+//
+//	Description:
+//		sine and cosine of V::kLanes angles
+//
+{
+  typedef typename V::Type T;
+
+  // only the angles beyond kMaxAngle go to the C library; the others of
+  // the vector take the scalar path, which does the same arithmetic, so an
+  // angle gets the same result whatever the lane width
+  //
+  const T x = V::load(angles);
+  if (!V::inRange(x)) {
+    int i;
+    for (i = 0; i < V::kLanes; i++) {
+      if (fabs(angles[i]) <= kMaxAngle) {
+        sinCosLanes<Scalar>(angles + i, sines + i, cosines + i);
+      }
+      else {
+        sines[i] = sin(angles[i]);
+        cosines[i] = cos(angles[i]);
+      }
+    }
+    return;
+  }
+
+  // q is the nearest quadrant, as an integer in the low mantissa bits of
+  // qBits and as a double in q
+  //
+  const T qBits = V::add(V::mul(x, V::set(kTwoOverPi)), V::set(kRoundMagic));
+  const T q = V::sub(qBits, V::set(kRoundMagic));
+
+  // r = x - q * pi/2, in [-pi/4, pi/4]
+  //
+  T r = V::sub(x, V::mul(q, V::set(kPiOver2A)));
+  r = V::sub(r, V::mul(q, V::set(kPiOver2B)));
+  r = V::sub(r, V::mul(q, V::set(kPiOver2C)));
+
+  const T z = V::mul(r, r);
+
+  T ps = V::add(V::set(kS5), V::mul(z, V::set(kS6)));
+  ps = V::add(V::set(kS4), V::mul(z, ps));
+  ps = V::add(V::set(kS3), V::mul(z, ps));
+  ps = V::add(V::set(kS2), V::mul(z, ps));
+  ps = V::add(V::set(kS1), V::mul(z, ps));
+  const T s = V::add(r, V::mul(V::mul(z, r), ps));
+
+  T pc = V::add(V::set(kC5), V::mul(z, V::set(kC6)));
+  pc = V::add(V::set(kC4), V::mul(z, pc));
+  pc = V::add(V::set(kC3), V::mul(z, pc));
+  pc = V::add(V::set(kC2), V::mul(z, pc));
+  pc = V::add(V::set(kC1), V::mul(z, pc));
+  const T c = V::add(V::sub(V::set(1.0), V::mul(V::set(0.5), z)), V::mul(V::mul(z, z), pc));
+
+  // sin(r + q pi/2) and cos(r + q pi/2) by quadrant
+  //
+  const T odd = V::oddMask(qBits);
+  const T sine = V::bitXor(V::select(odd, c, s), V::signOf2(qBits));
+  const T cosine = V::bitXor(V::select(odd, s, c),
+    V::signOf2(V::add(qBits, V::set(1.0))));
+
+  V::store(sines, sine);
+  V::store(cosines, cosine);
+}
+
+}
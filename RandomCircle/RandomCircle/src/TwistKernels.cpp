@@ -0,0 +1,40 @@
+////////////////////////////////////////////////////////////////////////
+// DESCRIPTION:
+//
+// Selection of the yTwist kernels, see TwistKernels.h.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "TwistKernels.h"
+
+static const TwistKernels* gTwistKernels = &kTwistKernelsSSE2;
+
+const TwistKernels& twistKernels()
+//
+//	Description:
+//		the kernels installed by selectTwistKernels(), the SSE2 ones until
+//		then
+//
+{
+  return *gTwistKernels;
+}
+
+void selectTwistKernels(CpuLevel level)
+//
+//	Description:
+//		installs the kernels compiled for the given level; called once,
+//		when the plug-in is loaded
+//
+{
+  switch (level) {
+  case kCpuAVX512:
+    gTwistKernels = &kTwistKernelsAVX512;
+    break;
+  case kCpuAVX2:
+    gTwistKernels = &kTwistKernelsAVX2;
+    break;
+  default:
+    gTwistKernels = &kTwistKernelsSSE2;
+    break;
+  }
+}
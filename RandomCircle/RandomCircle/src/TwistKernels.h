@@ -0,0 +1,42 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+// DESCRIPTION:
+//
+// The yTwist hot loops, compiled once per instruction set level by
+// TwistKernelsSSE2.cpp, TwistKernelsAVX2.cpp and TwistKernelsAVX512.cpp
+// from the code in TwistKernelsImpl.h.  initializePlugin() installs the set
+// matching the machine with selectTwistKernels(), see CpuDispatch.h.
+//
+// Every level produces the same bytes: no level contracts multiplies and
+// adds into the fused multiply-adds AVX2 and AVX-512 offer, see
+// TwistKernelsImpl.h, and sinCosFast sends an angle to the C library or
+// through the polynomials whatever the lane width.
+//
+// twistBlock twists count points, at most kTwistBlockSize, stored in place
+// as (x, y, z, w) doubles, the layout of MPoint.  In exact mode it gives
+// the same result as the original per point loop only if it was compiled
+// without contracting multiplies and adds; exact mode always runs the SSE2
+// kernels, which cannot contract, so that it does not depend on that.
+//
+////////////////////////////////////////////////////////////////////////
+
+#include "CpuDispatch.h"
+
+// points are twisted in blocks: each block is copied into contiguous x, y
+// and z arrays so that the twist loop runs over unit-stride data the
+// compiler can vectorize, and then copied back
+//
+static const int kTwistBlockSize = 256;
+
+struct TwistKernels {
+  void (*sinCosFast)(const double* angles, double* sines, double* cosines, int count);
+  void (*twistBlock)(double* points, int count, double magnitude, double env, bool fast);
+};
+
+extern const TwistKernels kTwistKernelsSSE2;
+extern const TwistKernels kTwistKernelsAVX2;
+extern const TwistKernels kTwistKernelsAVX512;
+
+const TwistKernels& twistKernels();
+void                selectTwistKernels(CpuLevel level);
@@ -0,0 +1,14 @@
+////////////////////////////////////////////////////////////////////////
+// DESCRIPTION:
+//
+// The yTwist kernels, compiled for kCpuAVX2; see TwistKernels.h.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if !defined(__AVX2__)
+#error TwistKernelsAVX2.cpp must be compiled with AVX2 enabled
+#endif
+
+#include "TwistKernelsImpl.h"
+
+const TwistKernels kTwistKernelsAVX2 = TWIST_KERNELS;
@@ -0,0 +1,14 @@
+////////////////////////////////////////////////////////////////////////
+// DESCRIPTION:
+//
+// The yTwist kernels, compiled for kCpuAVX512; see TwistKernels.h.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if !defined(__AVX512F__)
+#error TwistKernelsAVX512.cpp must be compiled with AVX-512 enabled
+#endif
+
+#include "TwistKernelsImpl.h"
+
+const TwistKernels kTwistKernelsAVX512 = TWIST_KERNELS;
@@ -0,0 +1,90 @@
+#pragma once
+
+////////////////////////////////////////////////////////////////////////
+// DESCRIPTION:
+//
+// Bodies of the TwistKernels.  Only the TwistKernels<level>.cpp files
+// include this, each compiled for a different instruction set.
+//
+////////////////////////////////////////////////////////////////////////
+
+// every level must round like the SSE2 one, so multiplies and adds are
+// never contracted into fused multiply-adds, here nor in SinCosLanes.h;
+// GCC ignores these pragmas and is given -ffp-contract=off for the AVX2
+// and AVX-512 files instead
+//
+#if defined(_MSC_VER)
+#pragma fp_contract(off)
+#elif defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#endif
+
+#include "TwistKernels.h"
+#include "SinCos.h"
+#include "SinCosLanes.h"
+
+namespace {
+
+void sinCosBlock(const double* angles, double* sines, double* cosines, int count)
+//
+//	Description:
+//		sine and cosine of every angle, Lanes::kLanes at a time; see SinCos.h
+//		for the error bounds
+//
+{
+  int i = 0;
+  for (; i + Lanes::kLanes <= count; i += Lanes::kLanes) {
+    sinCosLanes<Lanes>(angles + i, sines + i, cosines + i);
+  }
+  for (; i < count; i++) {
+    sinCosLanes<Scalar>(angles + i, sines + i, cosines + i);
+  }
+}
+
+void twistBlock(double* points, int count, double magnitude, double env, bool fast)
+//
+//	Description:
+//		twists count points, at most kTwistBlockSize, in place.  In exact
+//		mode every point goes through exactly the operations of the original
+//		per point loop.
+//
+{
+  double x[kTwistBlockSize];
+  double z[kTwistBlockSize];
+  double ff[kTwistBlockSize];
+  double cst[kTwistBlockSize];
+  double cct[kTwistBlockSize];
+
+  int i;
+  for (i = 0; i < count; i++) {
+    x[i] = points[4 * i];
+    z[i] = points[4 * i + 2];
+    ff[i] = magnitude * points[4 * i + 1] * env;
+  }
+
+  if (fast) {
+    sinCosBlock(ff, cst, cct, count);
+  }
+  else {
+    sinCosExact(ff, cst, cct, count);
+  }
+
+  for (i = 0; i < count; i++) {
+    double tt = x[i] * cct[i] - z[i] * cst[i];
+    double tz = x[i] * cst[i] + z[i] * cct[i];
+
+    // a zero twist leaves the point untouched, as before
+    //
+    x[i] = ff[i] != 0.0 ? tt : x[i];
+    z[i] = ff[i] != 0.0 ? tz : z[i];
+  }
+
+  for (i = 0; i < count; i++) {
+    points[4 * i] = x[i];
+    points[4 * i + 2] = z[i];
+  }
+}
+
+}
+
+#define TWIST_KERNELS { sinCosBlock, twistBlock }
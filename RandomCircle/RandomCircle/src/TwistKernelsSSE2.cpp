@@ -0,0 +1,14 @@
+////////////////////////////////////////////////////////////////////////
+// DESCRIPTION:
+//
+// The yTwist kernels, compiled for kCpuSSE2; see TwistKernels.h.
+//
+////////////////////////////////////////////////////////////////////////
+
+#if defined(__AVX2__)
+#error TwistKernelsSSE2.cpp must be compiled for the SSE2 baseline
+#endif
+
+#include "TwistKernelsImpl.h"
+
+const TwistKernels kTwistKernelsSSE2 = TWIST_KERNELS;
@@ -0,0 +1,35 @@
+#pragma once
+
+// CpuDispatch.h
+
+//
+// *****************************************************************************
+//
+// CpuDispatch
+//
+// *****************************************************************************
+//
+// The plug-ins are built once for every machine, so their hot kernels are
+// compiled several times, once per instruction set level, in translation
+// units of their own (see ExportKernels.h and, for the deformer,
+// TwistKernels.h).  initializePlugin() asks chooseCpuLevel() for the best
+// level the machine and the OS support and installs the matching kernels.
+//
+// Setting the environment variable XC_CPU_LEVEL to "sse2", "avx2" or
+// "avx512" before the plug-in is loaded lowers the level, e.g. to test the
+// SSE2 kernels on an AVX-512 machine.  A level the machine cannot run is
+// never chosen.
+//
+// This file is shared by the exporter and the deformer plug-in.
+//
+// *****************************************************************************
+
+enum CpuLevel {
+  kCpuSSE2 = 0,     //baseline of every x64 CPU
+  kCpuAVX2 = 1,     //AVX2 with SSE4.2
+  kCpuAVX512 = 2    //AVX-512 Foundation
+};
+
+CpuLevel      detectCpuLevel();
+CpuLevel      chooseCpuLevel(bool& forced);
+const char*   cpuLevelName(CpuLevel level);
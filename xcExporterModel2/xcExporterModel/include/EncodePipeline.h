@@ -0,0 +1,86 @@
+#pragma once
+
+// EncodePipeline.h
+
+//
+// *****************************************************************************
+//
+// CLASS:    EncodePipeline
+//
+// *****************************************************************************
+//
+// CLASS DESCRIPTION (EncodePipeline)
+//
+// EncodePipeline overlaps the Maya side of an export with the formatting of
+// the output.  The main thread keeps walking the scene and extracting mesh
+// data; every extracted mesh is handed over as an EncodeJob, which a worker
+// thread encodes into a private memory buffer.  Finished buffers are
+// committed to the output stream strictly in submission order, so the file
+// is byte-identical to a serial export no matter which job finishes first.
+//
+// Committing, and the EncodeJob::committed() callback, always happen on the
+// thread calling submit()/finish(), i.e. the Maya main thread, so jobs may
+// talk to Maya there.  encode() runs on a worker thread and must not.
+//
+// With a thread count of 0 every job is encoded on the calling thread as it
+// is submitted, which is the old serial behaviour.
+//
+// *****************************************************************************
+
+#include "WorkerPool.h"
+
+#include <condition_variable>
+#include <deque>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+
+class EncodeJob {
+
+public:
+  virtual ~EncodeJob() {}
+
+  //formats the job's data; called once, possibly on a worker thread.  pool
+  //is the pipeline's WorkerPool, which the job may use to split its own
+  //work further, or NULL in serial mode
+  //
+  virtual bool  encode(std::ostream& os, WorkerPool* pool) = 0;
+
+  //called on the submitting thread once the job's output was committed (or
+  //dropped because an earlier job failed)
+  //
+  virtual void  committed(bool /*succeeded*/) {}
+};
+
+
+class EncodePipeline {
+
+public:
+  EncodePipeline(std::ostream& os, unsigned int threadCount);
+  ~EncodePipeline();
+
+  bool  submit(EncodeJob* job);
+  bool  finish();
+
+private:
+  EncodePipeline(const EncodePipeline&);
+  EncodePipeline& operator=(const EncodePipeline&);
+
+  struct Slot {
+    EncodeJob*  job;
+    std::string bytes;
+    bool        done;
+    bool        succeeded;
+  };
+
+  void        encodeSlot(Slot* slot);
+  bool        commit(bool waitForAll);
+
+  std::ostream&           fOut;
+  WorkerPool*             fPool;
+  size_t                  fMaxInFlight;
+  std::deque<Slot*>       fInFlight;
+  std::mutex              fMutex;
+  std::condition_variable fSlotDone;
+  bool                    fFailed;
+};
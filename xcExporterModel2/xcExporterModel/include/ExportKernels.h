@@ -0,0 +1,86 @@
+#pragma once
+
+// ExportKernels.h
+
+//
+// *****************************************************************************
+//
+// STRUCT:   ExportKernels
+//
+// *****************************************************************************
+//
+// STRUCT DESCRIPTION (ExportKernels)
+//
+// ExportKernels holds the exporter's hot loops as function pointers.  The
+// loops are written once, in ExportKernelsImpl.h, and compiled once per
+// CpuLevel by ExportKernelsSSE2.cpp, ExportKernelsAVX2.cpp and
+// ExportKernelsAVX512.cpp, each with its own instruction set enabled.
+// initializePlugin() installs the set matching the machine with
+// selectExportKernels(); everything else calls through exportKernels().
+//
+// Every level produces the same bytes.  The quantizing and transforming
+// kernels finish the last few elements by running their vector code once
+// more over a padded copy, so no element goes through different arithmetic.
+// hashFloats may return different values per level, which only changes
+// where VertexWelder stores a vertex, never the order of its vertex table.
+//
+// *****************************************************************************
+
+#include "CpuDispatch.h"
+
+#include <cstddef>
+#include <cstdint>
+
+struct ExportKernels {
+  //(x, y, z, w) double points to separate x, y and z float32 arrays
+  //
+  void      (*pointsToFloats)(const double* points, float* x, float* y, float* z, size_t count);
+
+  //(x, y, z) triples to separate x, y and z arrays, and back
+  //
+  void      (*splitFloat3)(const float* xyz, float* x, float* y, float* z, size_t count);
+  void      (*mergeFloat3)(const float* x, const float* y, const float* z, float* xyz, size_t count);
+
+  //separate u and v arrays to (u, v) pairs
+  //
+  void      (*interleaveUVs)(const float* u, const float* v, float* uv, size_t count);
+
+  //hash of the bit patterns of count floats
+  //
+  uint32_t  (*hashFloats)(const float* values, unsigned int count);
+
+  //positions to unorm16 (x, y, z, 0) quadruples: every component becomes
+  //round((value - low) * scale), clamped to [0, 65535]
+  //
+  void      (*quantizePositions)(const float* x, const float* y, const float* z, size_t count,
+                                 const float* low, const float* scale, uint16_t* xyzw);
+
+  //unit vectors to octahedral (u, v) pairs, as snorm16 or snorm8
+  //
+  void      (*octahedralSnorm16)(const float* x, const float* y, const float* z, size_t count,
+                                 int16_t* uv);
+  void      (*octahedralSnorm8)(const float* x, const float* y, const float* z, size_t count,
+                                int8_t* uv);
+
+  //floats to IEEE half floats, rounding to nearest even
+  //
+  void      (*floatsToHalves)(const float* values, uint16_t* halves, size_t count);
+  //(x, y, z, w) double points times a row-major 4x4 double matrix, in Maya's
+  //row vector convention, to separate x, y and z float32 arrays; the
+  //products are summed in double and rounded once
+  //
+  void      (*transformPoints)(const double* points, const double* matrix,
+                               float* x, float* y, float* z, size_t count);
+
+  //directions times a row-major 3x3 float matrix, renormalized, in place;
+  //zero vectors stay zero
+  //
+  void      (*transformVectors)(float* x, float* y, float* z, size_t count, const float* matrix);
+};
+
+extern const ExportKernels kExportKernelsSSE2;
+extern const ExportKernels kExportKernelsAVX2;
+extern const ExportKernels kExportKernelsAVX512;
+
+const ExportKernels&  exportKernels();
+void                  selectExportKernels(CpuLevel level);
@@ -0,0 +1,509 @@
+#pragma once
+
+// ExportKernelsImpl.h
+
+//
+// *****************************************************************************
+//
+// Bodies of the ExportKernels.  Only the ExportKernels<level>.cpp files
+// include this; each compiles it with a different instruction set, and the
+// code paths below are picked by the macros that instruction set defines.
+// Everything is in an anonymous namespace so that the copies never merge at
+// link time, and no library templates are used for the same reason.
+//
+// Products and sums are written as separate multiplies and adds so that
+// every level rounds the same way.  MSVC never fuses them; GCC and Clang
+// builds must compile the AVX-512 file with -ffp-contract=off, since that
+// instruction set brings FMA along.
+//
+// *****************************************************************************
+
+#include "ExportKernels.h"
+
+#include <float.h>
+#include <immintrin.h>
+#include <string.h>
+
+namespace {
+
+void pointsToFloats(const double* points, float* x, float* y, float* z, size_t count)
+{
+  size_t i = 0;
+  //four points become four (x, y, z, w) float vectors, and a transpose
+  //turns those into four x, four y and four z values
+  //
+  for (; i + 4 <= count; i += 4) {
+    const double* p = points + 4 * i;
+#if defined(__AVX2__)
+    __m128 p0 = _mm256_cvtpd_ps(_mm256_loadu_pd(p));
+    __m128 p1 = _mm256_cvtpd_ps(_mm256_loadu_pd(p + 4));
+    __m128 p2 = _mm256_cvtpd_ps(_mm256_loadu_pd(p + 8));
+    __m128 p3 = _mm256_cvtpd_ps(_mm256_loadu_pd(p + 12));
+#else
+    __m128 p0 = _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(p)), _mm_cvtpd_ps(_mm_loadu_pd(p + 2)));
+    __m128 p1 = _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(p + 4)), _mm_cvtpd_ps(_mm_loadu_pd(p + 6)));
+    __m128 p2 = _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(p + 8)), _mm_cvtpd_ps(_mm_loadu_pd(p + 10)));
+    __m128 p3 = _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(p + 12)), _mm_cvtpd_ps(_mm_loadu_pd(p + 14)));
+#endif
+    _MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+    _mm_storeu_ps(x + i, p0);
+    _mm_storeu_ps(y + i, p1);
+    _mm_storeu_ps(z + i, p2);
+  }
+  for (; i < count; i++) {
+    x[i] = static_cast<float>(points[4 * i]);
+    y[i] = static_cast<float>(points[4 * i + 1]);
+    z[i] = static_cast<float>(points[4 * i + 2]);
+  }
+}
+
+
+void splitFloat3(const float* xyz, float* x, float* y, float* z, size_t count)
+{
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    //a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3
+    //
+    const __m128 a = _mm_loadu_ps(xyz + 3 * i);
+    const __m128 b = _mm_loadu_ps(xyz + 3 * i + 4);
+    const __m128 c = _mm_loadu_ps(xyz + 3 * i + 8);
+
+    const __m128 xs = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)),
+                                     _MM_SHUFFLE(2, 0, 3, 0));
+    const __m128 ys = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)),
+                                     _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)),
+                                     _MM_SHUFFLE(2, 0, 2, 0));
+    const __m128 zs = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)),
+                                     _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)),
+                                     _MM_SHUFFLE(2, 0, 2, 0));
+    _mm_storeu_ps(x + i, xs);
+    _mm_storeu_ps(y + i, ys);
+    _mm_storeu_ps(z + i, zs);
+  }
+  for (; i < count; i++) {
+    x[i] = xyz[3 * i];
+    y[i] = xyz[3 * i + 1];
+    z[i] = xyz[3 * i + 2];
+  }
+}
+
+
+void mergeFloat3(const float* x, const float* y, const float* z, float* xyz, size_t count)
+{
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const __m128 xs = _mm_loadu_ps(x + i);
+    const __m128 ys = _mm_loadu_ps(y + i);
+    const __m128 zs = _mm_loadu_ps(z + i);
+    const __m128 xyLow = _mm_unpacklo_ps(xs, ys);     //x0 y0 x1 y1
+    const __m128 xyHigh = _mm_unpackhi_ps(xs, ys);    //x2 y2 x3 y3
+
+    const __m128 a = _mm_shuffle_ps(xyLow, _mm_shuffle_ps(zs, xs, _MM_SHUFFLE(1, 1, 0, 0)),
+                                    _MM_SHUFFLE(2, 0, 1, 0));
+    const __m128 b = _mm_shuffle_ps(_mm_shuffle_ps(ys, zs, _MM_SHUFFLE(1, 1, 1, 1)), xyHigh,
+                                    _MM_SHUFFLE(1, 0, 2, 0));
+    const __m128 c = _mm_shuffle_ps(_mm_shuffle_ps(zs, xyHigh, _MM_SHUFFLE(2, 2, 2, 2)),
+                                    _mm_shuffle_ps(xyHigh, zs, _MM_SHUFFLE(3, 3, 3, 3)),
+                                    _MM_SHUFFLE(2, 0, 2, 0));
+    _mm_storeu_ps(xyz + 3 * i, a);
+    _mm_storeu_ps(xyz + 3 * i + 4, b);
+    _mm_storeu_ps(xyz + 3 * i + 8, c);
+  }
+  for (; i < count; i++) {
+    xyz[3 * i] = x[i];
+    xyz[3 * i + 1] = y[i];
+    xyz[3 * i + 2] = z[i];
+  }
+}
+
+
+void interleaveUVs(const float* u, const float* v, float* uv, size_t count)
+{
+  size_t i = 0;
+#if defined(__AVX2__)
+  for (; i + 8 <= count; i += 8) {
+    const __m256 us = _mm256_loadu_ps(u + i);
+    const __m256 vs = _mm256_loadu_ps(v + i);
+    const __m256 low = _mm256_unpacklo_ps(us, vs);
+    const __m256 high = _mm256_unpackhi_ps(us, vs);
+    _mm256_storeu_ps(uv + 2 * i, _mm256_permute2f128_ps(low, high, 0x20));
+    _mm256_storeu_ps(uv + 2 * i + 8, _mm256_permute2f128_ps(low, high, 0x31));
+  }
+#endif
+  for (; i + 4 <= count; i += 4) {
+    const __m128 us = _mm_loadu_ps(u + i);
+    const __m128 vs = _mm_loadu_ps(v + i);
+    _mm_storeu_ps(uv + 2 * i, _mm_unpacklo_ps(us, vs));
+    _mm_storeu_ps(uv + 2 * i + 4, _mm_unpackhi_ps(us, vs));
+  }
+  for (; i < count; i++) {
+    uv[2 * i] = u[i];
+    uv[2 * i + 1] = v[i];
+  }
+}
+
+
+void quantizePositionBlock(const float* x, const float* y, const float* z,
+                           const __m128* low, const __m128* scale, uint16_t* xyzw)
+{
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 maximum = _mm_set1_ps(65535.0f);
+  __m128 qx = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(x), low[0]), scale[0]), zero), maximum);
+  __m128 qy = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(y), low[1]), scale[1]), zero), maximum);
+  __m128 qz = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(z), low[2]), scale[2]), zero), maximum);
+  __m128 qw = zero;
+  _MM_TRANSPOSE4_PS(qx, qy, qz, qw);
+
+  //SSE2 only packs to signed 16 bits, so pack around 32768 and flip the
+  //sign bit back
+  //
+  const __m128i bias = _mm_set1_epi32(32768);
+  const __m128i flip = _mm_set1_epi16(static_cast<short>(0x8000));
+  const __m128i v01 = _mm_packs_epi32(_mm_sub_epi32(_mm_cvtps_epi32(qx), bias),
+                                      _mm_sub_epi32(_mm_cvtps_epi32(qy), bias));
+  const __m128i v23 = _mm_packs_epi32(_mm_sub_epi32(_mm_cvtps_epi32(qz), bias),
+                                      _mm_sub_epi32(_mm_cvtps_epi32(qw), bias));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(xyzw), _mm_xor_si128(v01, flip));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(xyzw + 8), _mm_xor_si128(v23, flip));
+}
+
+
+void quantizePositions(const float* x, const float* y, const float* z, size_t count,
+                       const float* low, const float* scale, uint16_t* xyzw)
+{
+  const __m128 lows[3] = { _mm_set1_ps(low[0]), _mm_set1_ps(low[1]), _mm_set1_ps(low[2]) };
+  const __m128 scales[3] = { _mm_set1_ps(scale[0]), _mm_set1_ps(scale[1]), _mm_set1_ps(scale[2]) };
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    quantizePositionBlock(x + i, y + i, z + i, lows, scales, xyzw + 4 * i);
+  }
+  if (i < count) {
+    float tailX[4] = {}, tailY[4] = {}, tailZ[4] = {};
+    uint16_t tail[16];
+    memcpy(tailX, x + i, (count - i) * sizeof(float));
+    memcpy(tailY, y + i, (count - i) * sizeof(float));
+    memcpy(tailZ, z + i, (count - i) * sizeof(float));
+    quantizePositionBlock(tailX, tailY, tailZ, lows, scales, tail);
+    memcpy(xyzw + 4 * i, tail, 4 * (count - i) * sizeof(uint16_t));
+  }
+}
+
+
+void octahedralBlock(const float* x, const float* y, const float* z, float range,
+                     __m128i& u, __m128i& v)
+//Summary:	octahedral coordinates of 4 unit vectors, scaled to +-range and
+//			rounded
+{
+  const __m128 signBit = _mm_set1_ps(-0.0f);
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 xs = _mm_loadu_ps(x);
+  const __m128 ys = _mm_loadu_ps(y);
+  const __m128 zs = _mm_loadu_ps(z);
+
+  //project onto the octahedron |x| + |y| + |z| = 1; zero vectors end up at
+  //the center of the map
+  //
+  __m128 l1 = _mm_add_ps(_mm_add_ps(_mm_andnot_ps(signBit, xs), _mm_andnot_ps(signBit, ys)),
+                         _mm_andnot_ps(signBit, zs));
+  l1 = _mm_max_ps(l1, _mm_set1_ps(FLT_MIN));
+  const __m128 px = _mm_div_ps(xs, l1);
+  const __m128 py = _mm_div_ps(ys, l1);
+
+  //fold the lower half over the diagonals
+  //
+  const __m128 foldX = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(signBit, py)),
+                                  _mm_or_ps(_mm_and_ps(px, signBit), one));
+  const __m128 foldY = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(signBit, px)),
+                                  _mm_or_ps(_mm_and_ps(py, signBit), one));
+  const __m128 lower = _mm_cmplt_ps(zs, _mm_setzero_ps());
+  const __m128 ou = _mm_or_ps(_mm_and_ps(lower, foldX), _mm_andnot_ps(lower, px));
+  const __m128 ov = _mm_or_ps(_mm_and_ps(lower, foldY), _mm_andnot_ps(lower, py));
+
+  const __m128 minimum = _mm_set1_ps(-1.0f);
+  const __m128 scale = _mm_set1_ps(range);
+  u = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(ou, minimum), one), scale));
+  v = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(ov, minimum), one), scale));
+}
+
+
+void octahedral16Block(const float* x, const float* y, const float* z, int16_t* uv)
+{
+  __m128i u, v;
+  octahedralBlock(x, y, z, 32767.0f, u, v);
+  const __m128i packed = _mm_packs_epi32(u, v);
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(uv),
+                   _mm_unpacklo_epi16(packed, _mm_srli_si128(packed, 8)));
+}
+
+
+void octahedral8Block(const float* x, const float* y, const float* z, int8_t* uv)
+{
+  __m128i u, v;
+  octahedralBlock(x, y, z, 127.0f, u, v);
+  const __m128i words = _mm_packs_epi32(u, v);
+  const __m128i packed = _mm_packs_epi16(words, words);
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(uv),
+                   _mm_unpacklo_epi8(packed, _mm_srli_si128(packed, 4)));
+}
+
+
+void octahedralSnorm16(const float* x, const float* y, const float* z, size_t count, int16_t* uv)
+{
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    octahedral16Block(x + i, y + i, z + i, uv + 2 * i);
+  }
+  if (i < count) {
+    float tailX[4] = {}, tailY[4] = {}, tailZ[4] = {};
+    int16_t tail[8];
+    memcpy(tailX, x + i, (count - i) * sizeof(float));
+    memcpy(tailY, y + i, (count - i) * sizeof(float));
+    memcpy(tailZ, z + i, (count - i) * sizeof(float));
+    octahedral16Block(tailX, tailY, tailZ, tail);
+    memcpy(uv + 2 * i, tail, 2 * (count - i) * sizeof(int16_t));
+  }
+}
+
+
+void octahedralSnorm8(const float* x, const float* y, const float* z, size_t count, int8_t* uv)
+{
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    octahedral8Block(x + i, y + i, z + i, uv + 2 * i);
+  }
+  if (i < count) {
+    float tailX[4] = {}, tailY[4] = {}, tailZ[4] = {};
+    int8_t tail[8];
+    memcpy(tailX, x + i, (count - i) * sizeof(float));
+    memcpy(tailY, y + i, (count - i) * sizeof(float));
+    memcpy(tailZ, z + i, (count - i) * sizeof(float));
+    octahedral8Block(tailX, tailY, tailZ, tail);
+    memcpy(uv + 2 * i, tail, 2 * (count - i) * sizeof(int8_t));
+  }
+}
+
+
+void halvesBlock(const float* values, uint16_t* halves)
+//Summary:	4 floats to halves, rounding to nearest even like the F16C
+//			instructions do, NaN payloads included
+{
+  const __m128i bits = _mm_castps_si128(_mm_loadu_ps(values));
+  const __m128i sign = _mm_and_si128(bits, _mm_set1_epi32(static_cast<int>(0x80000000u)));
+  const __m128i magnitude = _mm_xor_si128(bits, sign);
+
+  //below the smallest normal half, let a float addition do the rounding
+  //
+  const __m128i denormalMagic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+  const __m128i denormal = _mm_sub_epi32(
+    _mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(magnitude), _mm_castsi128_ps(denormalMagic))),
+    denormalMagic);
+
+  //normal halves: rebias the exponent and round the mantissa to 10 bits;
+  //a carry out of the mantissa correctly bumps the exponent, up to infinity.
+  //The rebias of (15 - 127) << 23 wraps around as an unsigned constant.
+  //
+  const __m128i odd = _mm_and_si128(_mm_srli_epi32(magnitude, 13), _mm_set1_epi32(1));
+  __m128i normal = _mm_add_epi32(magnitude, _mm_set1_epi32(static_cast<int>(0xC8000000u + 0xFFF)));
+  normal = _mm_srli_epi32(_mm_add_epi32(normal, odd), 13);
+
+  //infinities, overflows and NaNs
+  //
+  const __m128i nan = _mm_or_si128(_mm_set1_epi32(0x7E00),
+                                   _mm_srli_epi32(_mm_and_si128(magnitude, _mm_set1_epi32(0x7FFFFF)), 13));
+  const __m128i isNan = _mm_cmpgt_epi32(magnitude, _mm_set1_epi32(255 << 23));
+  const __m128i special = _mm_or_si128(_mm_and_si128(isNan, nan),
+                                       _mm_andnot_si128(isNan, _mm_set1_epi32(0x7C00)));
+
+  const __m128i isDenormal = _mm_cmplt_epi32(magnitude, _mm_set1_epi32(113 << 23));
+  const __m128i isSpecial = _mm_cmpgt_epi32(magnitude, _mm_set1_epi32(((127 + 16) << 23) - 1));
+  __m128i result = _mm_or_si128(_mm_and_si128(isDenormal, denormal),
+                                _mm_andnot_si128(isDenormal, normal));
+  result = _mm_or_si128(_mm_and_si128(isSpecial, special), _mm_andnot_si128(isSpecial, result));
+  result = _mm_or_si128(result, _mm_srli_epi32(sign, 16));
+
+  //sign extend, so that the signed pack keeps all 16 bits
+  //
+  result = _mm_srai_epi32(_mm_slli_epi32(result, 16), 16);
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(halves), _mm_packs_epi32(result, result));
+}
+
+
+void floatsToHalves(const float* values, uint16_t* halves, size_t count)
+{
+  size_t i = 0;
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+  //every AVX2 machine has F16C
+  //
+  for (; i + 8 <= count; i += 8) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(halves + i),
+                     _mm256_cvtps_ph(_mm256_loadu_ps(values + i), _MM_FROUND_TO_NEAREST_INT));
+  }
+#endif
+  for (; i + 4 <= count; i += 4) {
+    halvesBlock(values + i, halves + i);
+  }
+  if (i < count) {
+    float tailValues[4] = {};
+    uint16_t tail[4];
+    memcpy(tailValues, values + i, (count - i) * sizeof(float));
+    halvesBlock(tailValues, tail);
+    memcpy(halves + i, tail, (count - i) * sizeof(uint16_t));
+  }
+}
+
+
+void transformPointBlock(const double* points, const double* matrix, float* x, float* y, float* z)
+//Summary:	transforms 4 points, see ExportKernels::transformPoints
+{
+#if defined(__AVX2__)
+  const __m256d p0 = _mm256_loadu_pd(points);
+  const __m256d p1 = _mm256_loadu_pd(points + 4);
+  const __m256d p2 = _mm256_loadu_pd(points + 8);
+  const __m256d p3 = _mm256_loadu_pd(points + 12);
+  const __m256d xz01 = _mm256_unpacklo_pd(p0, p1);
+  const __m256d yw01 = _mm256_unpackhi_pd(p0, p1);
+  const __m256d xz23 = _mm256_unpacklo_pd(p2, p3);
+  const __m256d yw23 = _mm256_unpackhi_pd(p2, p3);
+  const __m256d xs = _mm256_permute2f128_pd(xz01, xz23, 0x20);
+  const __m256d ys = _mm256_permute2f128_pd(yw01, yw23, 0x20);
+  const __m256d zs = _mm256_permute2f128_pd(xz01, xz23, 0x31);
+  const __m256d ws = _mm256_permute2f128_pd(yw01, yw23, 0x31);
+
+  float* out[3] = { x, y, z };
+  int column;
+  for (column = 0; column < 3; column++) {
+    __m256d sum = _mm256_mul_pd(xs, _mm256_set1_pd(matrix[column]));
+    sum = _mm256_add_pd(sum, _mm256_mul_pd(ys, _mm256_set1_pd(matrix[4 + column])));
+    sum = _mm256_add_pd(sum, _mm256_mul_pd(zs, _mm256_set1_pd(matrix[8 + column])));
+    sum = _mm256_add_pd(sum, _mm256_mul_pd(ws, _mm256_set1_pd(matrix[12 + column])));
+    _mm_storeu_ps(out[column], _mm256_cvtpd_ps(sum));
+  }
+#else
+  __m128 halves[3][2];
+  int half;
+  for (half = 0; half < 2; half++) {
+    const double* p = points + 8 * half;
+    const __m128d xy0 = _mm_loadu_pd(p);
+    const __m128d zw0 = _mm_loadu_pd(p + 2);
+    const __m128d xy1 = _mm_loadu_pd(p + 4);
+    const __m128d zw1 = _mm_loadu_pd(p + 6);
+    const __m128d xs = _mm_unpacklo_pd(xy0, xy1);
+    const __m128d ys = _mm_unpackhi_pd(xy0, xy1);
+    const __m128d zs = _mm_unpacklo_pd(zw0, zw1);
+    const __m128d ws = _mm_unpackhi_pd(zw0, zw1);
+
+    int column;
+    for (column = 0; column < 3; column++) {
+      __m128d sum = _mm_mul_pd(xs, _mm_set1_pd(matrix[column]));
+      sum = _mm_add_pd(sum, _mm_mul_pd(ys, _mm_set1_pd(matrix[4 + column])));
+      sum = _mm_add_pd(sum, _mm_mul_pd(zs, _mm_set1_pd(matrix[8 + column])));
+      sum = _mm_add_pd(sum, _mm_mul_pd(ws, _mm_set1_pd(matrix[12 + column])));
+      halves[column][half] = _mm_cvtpd_ps(sum);
+    }
+  }
+  _mm_storeu_ps(x, _mm_movelh_ps(halves[0][0], halves[0][1]));
+  _mm_storeu_ps(y, _mm_movelh_ps(halves[1][0], halves[1][1]));
+  _mm_storeu_ps(z, _mm_movelh_ps(halves[2][0], halves[2][1]));
+#endif
+}
+
+
+void transformPoints(const double* points, const double* matrix,
+                     float* x, float* y, float* z, size_t count)
+{
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    transformPointBlock(points + 4 * i, matrix, x + i, y + i, z + i);
+  }
+  if (i < count) {
+    double tailPoints[16] = {};
+    float tailX[4], tailY[4], tailZ[4];
+    memcpy(tailPoints, points + 4 * i, 4 * (count - i) * sizeof(double));
+    transformPointBlock(tailPoints, matrix, tailX, tailY, tailZ);
+    memcpy(x + i, tailX, (count - i) * sizeof(float));
+    memcpy(y + i, tailY, (count - i) * sizeof(float));
+    memcpy(z + i, tailZ, (count - i) * sizeof(float));
+  }
+}
+
+
+void transformVectorBlock(float* x, float* y, float* z, const float* matrix)
+//Summary:	transforms 4 directions in place, see
+//			ExportKernels::transformVectors
+{
+  const __m128 xs = _mm_loadu_ps(x);
+  const __m128 ys = _mm_loadu_ps(y);
+  const __m128 zs = _mm_loadu_ps(z);
+  __m128 out[3];
+  int column;
+  for (column = 0; column < 3; column++) {
+    __m128 sum = _mm_mul_ps(xs, _mm_set1_ps(matrix[column]));
+    sum = _mm_add_ps(sum, _mm_mul_ps(ys, _mm_set1_ps(matrix[3 + column])));
+    sum = _mm_add_ps(sum, _mm_mul_ps(zs, _mm_set1_ps(matrix[6 + column])));
+    out[column] = sum;
+  }
+  __m128 length = _mm_mul_ps(out[0], out[0]);
+  length = _mm_add_ps(length, _mm_mul_ps(out[1], out[1]));
+  length = _mm_add_ps(length, _mm_mul_ps(out[2], out[2]));
+  length = _mm_max_ps(_mm_sqrt_ps(length), _mm_set1_ps(FLT_MIN));
+  _mm_storeu_ps(x, _mm_div_ps(out[0], length));
+  _mm_storeu_ps(y, _mm_div_ps(out[1], length));
+  _mm_storeu_ps(z, _mm_div_ps(out[2], length));
+}
+
+
+void transformVectors(float* x, float* y, float* z, size_t count, const float* matrix)
+{
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    transformVectorBlock(x + i, y + i, z + i, matrix);
+  }
+  if (i < count) {
+    float tailX[4] = {}, tailY[4] = {}, tailZ[4] = {};
+    memcpy(tailX, x + i, (count - i) * sizeof(float));
+    memcpy(tailY, y + i, (count - i) * sizeof(float));
+    memcpy(tailZ, z + i, (count - i) * sizeof(float));
+    transformVectorBlock(tailX, tailY, tailZ, matrix);
+    memcpy(x + i, tailX, (count - i) * sizeof(float));
+    memcpy(y + i, tailY, (count - i) * sizeof(float));
+    memcpy(z + i, tailZ, (count - i) * sizeof(float));
+  }
+}
+
+uint32_t hashFloats(const float* values, unsigned int count)
+{
+  unsigned int i;
+#if defined(__AVX2__)
+  //every AVX2 machine has the SSE4.2 crc32 instruction, one cycle per float
+  //
+  uint32_t h = 0xFFFFFFFFu;
+  for (i = 0; i < count; i++) {
+    uint32_t bits;
+    memcpy(&bits, &values[i], sizeof(bits));
+    h = _mm_crc32_u32(h, bits);
+  }
+#else
+  //FNV-1a
+  //
+  uint32_t h = 2166136261u;
+  for (i = 0; i < count; i++) {
+    uint32_t bits;
+    memcpy(&bits, &values[i], sizeof(bits));
+    h = (h ^ bits) * 16777619u;
+  }
+#endif
+  //murmur finalizer, so that the low bits used for a slot are well spread
+  //
+  h ^= h >> 16;
+  h *= 0x85ebca6bu;
+  h ^= h >> 13;
+  h *= 0xc2b2ae35u;
+  h ^= h >> 16;
+  return h;
+}
+
+}
+
+#define EXPORT_KERNELS { pointsToFloats, splitFloat3, mergeFloat3, interleaveUVs, hashFloats, \
+                         quantizePositions, octahedralSnorm16, octahedralSnorm8, floatsToHalves, \
+                         transformPoints, transformVectors }
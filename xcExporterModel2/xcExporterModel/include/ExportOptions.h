@@ -0,0 +1,112 @@
+#pragma once
+
+// ExportOptions.h
+
+//
+// *****************************************************************************
+//
+// STRUCT:   ExportOptions
+//
+// *****************************************************************************
+//
+// STRUCT DESCRIPTION (ExportOptions)
+//
+// ExportOptions holds the settings of one export.  ExporterModel owns it and
+// hands it to every WriterModel it creates.
+//
+// The settings come from the translator options string Maya passes to
+// MPxFileTranslator::writer(), a list of "name=value" pairs separated by
+// ';'.  parse() knows the type of every option and only applies values that
+// convert cleanly; anything else is reported back as a warning and leaves
+// the option at its previous value.
+//
+// Channel options decide what the writers extract from the mesh, not only
+// what they write, so switching a channel off also skips the Maya calls that
+// compute it.
+//
+// *****************************************************************************
+
+#include <string>
+#include <vector>
+
+struct ExportOptions {
+  ExportOptions();
+
+  bool parse(const std::string& optionsString, std::vector<std::string>& warnings);
+
+  //channels
+  //
+  bool normals;       //normals and per face-vertex normal ids
+  bool uvs;           //every uv set with per face-vertex uv ids
+  bool tangents;      //world space tangents of the current uv set
+  bool binormals;     //world space binormals of the current uv set
+  bool sets;          //face sets and their file textures
+
+  //also output the triangulation of every face: a triangle index list and
+  //the face each triangle belongs to
+  //
+  bool triangulate;
+
+  //binary format: write the welded vertex table and the table index of
+  //every face-vertex instead of separate position, normal and uv arrays
+  //with their own face-vertex index lists.  Triangulated mode always
+  //writes the table, since its triangles index it.
+  //
+  bool indexed;
+
+  //binary format, triangulated mode only: reorder the triangles for the
+  //post-transform vertex cache and renumber the welded vertices in the
+  //order the triangles first use them, see VertexCache.h
+  //
+  bool vertexCache;
+
+  //binary format, triangulated mode only: also write the triangles cut
+  //into meshlets with culling bounds, see MeshletBuilder.h
+  //
+  bool meshlets;
+
+  //binary format: write positions, normals, tangents, binormals, uvs and
+  //the welded vertex table quantized instead of as float32, see Quantize.h
+  //
+  bool quantize;
+
+  //write positions, normals, tangents and binormals in object space, with
+  //the world matrix of every shape, instead of baking that matrix into them
+  //
+  bool localSpace;
+
+  //write further instances of an instanced shape as a reference to its
+  //first instance plus a matrix, rather than as a copy of the geometry
+  //
+  bool instances;
+
+  //also save how long every phase of the export took, per mesh and per
+  //thread, as a Chrome trace next to the exported file, see ExportTrace.h
+  //
+  bool trace;
+
+  //also save per shape and channel the elements and bytes written and the
+  //peak memory of the writer's buffers as JSON next to the exported file,
+  //see ExportReport.h
+  //
+  bool report;
+
+  //also save every extracted mesh to a capture file next to the exported
+  //file, which replay/xcReplay encodes again without Maya, see
+  //MeshCapture.h
+  //
+  bool capture;
+
+  //number of threads encoding meshes while the main thread extracts the
+  //next ones; 0 encodes on the main thread, -1 uses every core but one
+  //
+  int threads;
+
+  //how the text writer prints floating point values: -1 prints the
+  //shortest text that reads back to the same value, N >= 0 prints fixed
+  //notation with N digits after the point
+  //
+  int precision;
+
+  unsigned int encodeThreads() const;
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+// ExportReport.h
+
+//
+// *****************************************************************************
+//
+// CLASS:    ExportReport
+//
+// *****************************************************************************
+//
+// CLASS DESCRIPTION (ExportReport)
+//
+// ExportReport collects what every exported shape cost: per channel the
+// number of elements, the bytes the writer emitted for it and the bytes the
+// same data takes as plain float32 / uint32 arrays, and the most memory the
+// writer's buffers held while it was encoded.  The ratio of the last two
+// byte counts is the channel's compression ratio; for the text format it is
+// usually below 1.
+//
+// write() saves the report as a JSON sidecar next to the exported file so an
+// asset pipeline can check meshes against a memory budget without exporting
+// again:
+//
+//   { "file": ..., "totalBytes": ..., "peakBufferBytes": ...,
+//     "shapes": [ { "shape": ..., "bytes": ..., "peakBufferBytes": ...,
+//                   "channels": [ { "name": ..., "elements": ...,
+//                                   "bytes": ..., "rawBytes": ...,
+//                                   "ratio": ... }, ... ] }, ... ] }
+//
+// Shapes are added by WriterModel::committed(), on the main thread and in
+// file order.
+//
+// *****************************************************************************
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct ChannelReport {
+  std::string name;
+  uint64_t    elements;
+  uint64_t    bytes;      //emitted, including chunk headers and labels
+  uint64_t    rawBytes;   //as float32 / uint32 arrays
+};
+
+struct ShapeReport {
+  std::string                 shape;
+  uint64_t                    peakBufferBytes;
+  std::vector<ChannelReport>  channels;
+};
+
+class ExportReport {
+
+public:
+  void    clear();
+  void    add(const ShapeReport& shape);
+  size_t  shapeCount() const;
+  bool    write(const std::string& fileName, const std::string& exportName) const;
+
+private:
+  std::vector<ShapeReport> fShapes;
+};
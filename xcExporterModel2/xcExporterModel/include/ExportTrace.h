@@ -0,0 +1,100 @@
+#pragma once
+
+// ExportTrace.h
+
+//
+// *****************************************************************************
+//
+// CLASS:    ExportTrace
+//
+// *****************************************************************************
+//
+// CLASS DESCRIPTION (ExportTrace)
+//
+// ExportTrace records how long every phase of an export takes: the scene
+// walk, the extraction of every mesh on the main thread and its encoding,
+// stage by stage, on the worker threads.  A TraceScope placed at the top of
+// a function records one event from its construction to its destruction,
+// tagged with the shape it worked on.
+//
+// write() saves the events in the Trace Event Format, a JSON file that
+// chrome://tracing and https://ui.perfetto.dev open as a timeline with one
+// row per thread.  Events are complete ("X") events in microseconds since
+// start().
+//
+// ExporterModel owns one trace and hands it to every writer if the "trace"
+// option is on; otherwise writers get NULL and every TraceScope is a no-op
+// that does not even read the clock.  record() may be called from any
+// thread.
+//
+// *****************************************************************************
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class ExportTrace {
+
+public:
+  ExportTrace();
+
+  void      start();
+  int64_t   now() const;
+  void      record(const char* name, const std::string& shape, int64_t begin, int64_t end);
+  bool      write(const std::string& fileName) const;
+  size_t    eventCount() const;
+
+private:
+  ExportTrace(const ExportTrace&);
+  ExportTrace& operator=(const ExportTrace&);
+
+  struct Event {
+    const char*   name;       //a string literal
+    std::string   shape;      //empty for scene-wide phases
+    int64_t       begin;      //microseconds since start()
+    int64_t       duration;
+    unsigned int  thread;     //index into fThreads
+  };
+
+  std::chrono::steady_clock::time_point fStart;
+  std::vector<Event>                    fEvents;
+  std::vector<std::thread::id>          fThreads;   //main thread first
+  mutable std::mutex                    fMutex;
+};
+
+
+//Records the time from its construction to the end of the enclosing scope
+//into trace, if trace is not NULL.
+//
+class TraceScope {
+
+public:
+  TraceScope(ExportTrace* trace, const char* name, const char* shape = NULL) :
+    fTrace(trace), fName(name), fBegin(0)
+  {
+    if (NULL != fTrace) {
+      fShape = NULL == shape ? "" : shape;
+      fBegin = fTrace->now();
+    }
+  }
+
+  ~TraceScope()
+  {
+    if (NULL != fTrace) {
+      fTrace->record(fName, fShape, fBegin, fTrace->now());
+    }
+  }
+
+private:
+  TraceScope(const TraceScope&);
+  TraceScope& operator=(const TraceScope&);
+
+  ExportTrace*  fTrace;
+  const char*   fName;
+  std::string   fShape;
+  int64_t       fBegin;
+};
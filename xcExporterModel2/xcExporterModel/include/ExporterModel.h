@@ -1,4 +1,4 @@
-
+#pragma once
 
 //-
 // ==========================================================================
@@ -43,13 +43,41 @@
 //
 // For examples, see the classes polyRawExporter and polyX3DExporter
 //
+// Instanced shapes are exported once, at their first visible instance.
+// Every further instance of the same shape is written by writeInstance() as
+// a reference to that first instance plus its own world matrix, unless the
+// "instances" option is switched off.
+//
 // *****************************************************************************
 
 #include <maya/MPxFileTranslator.h>
+#include <maya/MObject.h>
+#include <maya/MMatrix.h>
+#include <maya/MString.h>
+
+#include "ExportOptions.h"
+#include "ShaderCache.h"
+#include "ExportTrace.h"
+#include "ExportReport.h"
+#include "MeshCapture.h"
 
 #include <iosfwd>
+#include <string>
+#include <unordered_map>
 
 class WriterModel;
+class EncodePipeline;
+
+//An instance that is written as a reference to an already exported one.
+//Matrices are row-major, in Maya's row vector convention.
+//
+struct InstanceRecord {
+  std::string name;             //partial DAG path of this instance
+  std::string sourceName;       //partial DAG path of the exported instance
+  double      worldMatrix[4][4];
+  double      relativeMatrix[4][4]; //maps the exported positions of the
+                                    //source onto this instance
+};
 
 class ExporterModel : public MPxFileTranslator {
 
@@ -68,6 +96,8 @@ public:
 
 
 protected:
+  virtual	ExportOptions defaultOptions() const;
+  virtual	bool			  isBinary() const;
   virtual	bool			  isVisible(MFnDagNode& fnDag, MStatus& status);
   virtual	MStatus		  exportAll(std::ostream& os);
   virtual	MStatus			exportSelection(std::ostream& os);
@@ -75,6 +105,58 @@ protected:
   virtual void			  writeFooter(std::ostream& os);
   virtual MStatus			processPolyMesh(const MDagPath dagPath, std::ostream& os);
   virtual WriterModel* createPolyWriter(const MDagPath dagPath, MStatus& status) = 0;
+  virtual bool			  writeInstance(std::ostream& os, const InstanceRecord& instance) const = 0;
+
+  //settings of the current export, handed to every writer
+  //
+  ExportOptions fOptions;
+
+  //encodes the extracted meshes of the current export and writes them to
+  //the file in scene order; only valid during writer()
+  //
+  EncodePipeline* fPipeline;
+
+private:
+  MStatus			writeFile(const MString& fileName,
+                        MPxFileTranslator::FileAccessMode mode);
+  void			writeTrace(const MString& fileName);
+  void			writeReport(const MString& fileName);
+  void			openCapture(const MString& fileName);
+  void			closeCapture(const MString& fileName);
+  ExportTrace*	trace();
+  ExportReport*	report();
+  CaptureWriter*	capture();
+  bool			findInstanceSource(const MDagPath& dagPath, InstanceRecord& instance);
+
+  //the first exported instance of every instanced shape of the current
+  //export, keyed by MObjectHandle::hashCode() of the shape node
+  //
+  struct InstanceSource {
+    MObject shape;
+    MString name;
+    MMatrix inverseMatrix;
+  };
+  std::unordered_multimap<unsigned int, InstanceSource> fInstanceSources;
+
+  //texture lookups of the shading groups seen by the current export,
+  //shared by all its writers
+  //
+  ShaderCache fShaderCache;
+
+  //phase timings of the current export if the "trace" option is on, see
+  //trace()
+  //
+  ExportTrace fTrace;
+
+  //bytes and buffer memory of every shape of the current export if the
+  //"report" option is on, see report()
+  //
+  ExportReport fReport;
+
+  //the meshes of the current export as they were extracted, if the
+  //"capture" option is on, see capture()
+  //
+  CaptureWriter fCapture;
 };
 
 
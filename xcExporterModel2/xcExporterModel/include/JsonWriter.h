@@ -0,0 +1,23 @@
+#pragma once
+
+// JsonWriter.h
+
+//
+// *****************************************************************************
+//
+// JSON output helpers
+//
+// *****************************************************************************
+//
+// The JSON sidecars, the export report (see ExportReport) and the trace
+// (see ExportTrace), and xcBench's results write their numbers straight to
+// a stream; the helpers here cover what needs escaping.
+//
+// *****************************************************************************
+
+#include <iosfwd>
+#include <string>
+
+//writes text as a quoted JSON string
+//
+void writeJsonString(std::ostream& os, const std::string& text);
@@ -0,0 +1,135 @@
+#pragma once
+
+// MeshCapture.h
+
+//
+// *****************************************************************************
+//
+// STRUCT:   MeshCapture
+//
+// *****************************************************************************
+//
+// STRUCT DESCRIPTION (MeshCapture)
+//
+// MeshCapture holds everything WriterModel::extractGeometry() gathers from
+// one mesh, in plain C++ types: the snapshot streams, the face topology and
+// triangulation, every uv set and the resolved sets.  It is what a writer
+// needs to encode the mesh without Maya.
+//
+// With the "capture" option the exporter saves every mesh it extracts into
+// a capture file next to the exported file, <file>.xcap.  A writer created
+// from a MeshCapture (see WriterModel) encodes it exactly like the mesh it
+// was taken from, so replay/xcReplay can run and profile the encoders on a
+// machine without Maya.  Further instances of instanced shapes are not
+// captured.
+//
+// A capture file uses the container of xcbFormat.h with its own magic and
+// version; every mesh starts with an xcb::kShape chunk:
+//
+//   kShape          char[count]     partial DAG path of the shape
+//   kCaptureSpace   uint32[1]       1 if the vertex channels are in object
+//                                   space (localSpace), 0 if the world
+//                                   matrix is baked into them
+//   kWorldMatrix    float64[16]     world matrix of the shape
+//   kPositions, kNormals, kTangents, kBinormals
+//                   float32[3*count] the snapshot streams as (x, y, z)
+//   kFaceCounts, kFacePositions, kFaceNormals
+//                   int32[count]    the face topology, as in xcb
+//   kTriangleCounts int32[count]    triangles of every face
+//   kTriangleVertices int32[3*count] face-vertex index of every triangle
+//                                   corner, counting over the whole mesh
+//   kCurrentUVSet   char[count]     name of the current uv set
+//   kUVSetName      char[count]     starts a uv set, followed by
+//   kUVs            float32[2*count] its (u, v) pairs and
+//   kFaceUVs        int32[count]    the uv index of each face-vertex
+//   kSetName        char[count]     starts a set, followed by
+//   kSetTexture     char[count]     its file texture and
+//   kSetFaceRanges  uint32[2*count] its faces as (start, count) runs
+//
+// Channels the export switched off are left out.  A kEnd chunk terminates
+// the file.
+//
+// *****************************************************************************
+
+#include "MeshSnapshot.h"
+#include "xcbFormat.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace xcap {
+
+const uint32_t kMagic = xcb::makeId('X', 'C', 'A', 'P');
+const uint32_t kVersion = 1;
+
+enum ChunkId : uint32_t {
+  kCaptureSpace = xcb::makeId('S', 'P', 'C', 'E'),
+  kTriangleCounts = xcb::makeId('T', 'C', 'N', 'T'),
+  kTriangleVertices = xcb::makeId('T', 'V', 'T', 'X'),
+  kCurrentUVSet = xcb::makeId('U', 'V', 'C', 'R')
+};
+
+}
+
+struct CapturedUVSet {
+  std::string       name;
+  FloatStream       u;
+  FloatStream       v;
+  std::vector<int>  faceUVIds;    //uv index of each face-vertex, -1 if none
+};
+
+struct CapturedSet {
+  std::string           name;
+  std::string           texture;
+  std::vector<uint32_t> faceRanges;   //sorted (start, count) runs of faces
+};
+
+struct MeshCapture {
+  MeshCapture();
+
+  std::string       shape;
+  bool              localSpace;         //snapshot in object space
+  double            worldMatrix[4][4];
+  MeshSnapshot      snapshot;
+  std::vector<int>  faceVertexCounts;
+  std::vector<int>  faceVertexIds;
+  std::vector<int>  faceNormalIds;
+  std::vector<int>  triangleCounts;
+  std::vector<int>  triangleVertices;
+  std::string       currentUVSetName;
+  std::vector<CapturedUVSet> uvSets;
+  std::vector<CapturedSet>   sets;
+
+  size_t  faceCount() const { return faceVertexCounts.size(); }
+};
+
+
+//Writes the meshes of one export to a capture file, one at a time, as they
+//are extracted.  Only used on the main thread.
+//
+class CaptureWriter {
+
+public:
+  CaptureWriter();
+
+  bool    open(const std::string& fileName);
+  bool    isOpen() const;
+  void    write(const MeshCapture& capture);
+  bool    close();
+  size_t  meshCount() const;
+
+private:
+  CaptureWriter(const CaptureWriter&);
+  CaptureWriter& operator=(const CaptureWriter&);
+
+  std::ofstream fFile;
+  size_t        fMeshCount;
+};
+
+
+bool readCaptureFile(const std::string& fileName, std::vector<MeshCapture>& captures,
+                     std::string& error);
@@ -0,0 +1,108 @@
+#pragma once
+
+// MeshSnapshot.h
+
+//
+// *****************************************************************************
+//
+// STRUCT:   MeshSnapshot
+//
+// *****************************************************************************
+//
+// STRUCT DESCRIPTION (MeshSnapshot)
+//
+// MeshSnapshot holds the per vertex channels of one mesh as float32
+// structure-of-arrays streams: one array per component, each starting on a
+// 64 byte boundary, so that no cache line is shared between streams and the
+// encoders can run over them with vector loads.
+//
+// WriterModel::extractGeometry() fills it once from the Maya arrays, with
+// the conversions done by the ExportKernels, and the writers only read the
+// snapshot afterwards.  A position takes 12 bytes instead of the 32 of an
+// MPoint; positions are rounded to float once, here, rather than by every
+// writer.  Geometry baked into world space is transformed here as well,
+// positions in double before that rounding.
+//
+// The conversions from the Maya arrays are in MeshSnapshotMaya.cpp, so that
+// the streams themselves build without Maya.
+//
+// *****************************************************************************
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+#include <xmmintrin.h>
+
+class MPointArray;
+class MFloatVectorArray;
+class MFloatArray;
+class MMatrix;
+
+template <class T>
+class AlignedAllocator {
+
+public:
+  typedef T value_type;
+
+  static const size_t kAlignment = 64;
+
+  template <class U>
+  struct rebind {
+    typedef AlignedAllocator<U> other;
+  };
+
+  AlignedAllocator() {}
+  template <class U>
+  AlignedAllocator(const AlignedAllocator<U>&) {}
+
+  T* allocate(size_t count)
+  {
+    void* memory = _mm_malloc(count * sizeof(T), kAlignment);
+    if (NULL == memory) {
+      throw std::bad_alloc();
+    }
+    return static_cast<T*>(memory);
+  }
+
+  void deallocate(T* memory, size_t /*count*/)
+  {
+    _mm_free(memory);
+  }
+};
+
+template <class T, class U>
+bool operator==(const AlignedAllocator<T>&, const AlignedAllocator<U>&) { return true; }
+template <class T, class U>
+bool operator!=(const AlignedAllocator<T>&, const AlignedAllocator<U>&) { return false; }
+
+
+typedef std::vector<float, AlignedAllocator<float> > FloatStream;
+
+
+struct Float3Stream {
+  FloatStream x;
+  FloatStream y;
+  FloatStream z;
+
+  size_t  length() const { return x.size(); }
+  void    resize(size_t count);
+  void    clear();
+  void    interleave(std::vector<float>& xyz) const;
+  void    deinterleave(const std::vector<float>& xyz);
+};
+
+
+struct MeshSnapshot {
+  Float3Stream  positions;
+  Float3Stream  normals;
+  Float3Stream  tangents;
+  Float3Stream  binormals;
+};
+
+
+void snapshotPoints(const MPointArray& points, Float3Stream& stream);
+void snapshotPoints(const MPointArray& points, const MMatrix& matrix, Float3Stream& stream);
+void transformStream(Float3Stream& stream, const MMatrix& matrix);
+void snapshotVectors(const MFloatVectorArray& vectors, Float3Stream& stream);
+void snapshotFloats(const MFloatArray& values, FloatStream& stream);
@@ -0,0 +1,47 @@
+#pragma once
+
+// MeshletBuilder.h
+
+//
+// *****************************************************************************
+//
+// STRUCT:   Meshlets
+//
+// *****************************************************************************
+//
+// STRUCT DESCRIPTION (Meshlets)
+//
+// buildMeshlets() cuts an indexed triangle list into meshlets of at most
+// xcb::kMaxMeshletVertices vertices and xcb::kMaxMeshletTriangles triangles,
+// the unit a mesh shading renderer culls and draws.  Triangles are taken in
+// the order of the list and a meshlet is closed as soon as the next triangle
+// no longer fits, so a list ordered for the vertex cache (see VertexCache.h)
+// gives compact, well filled meshlets.  A meshlet is also closed before
+// every triangle listed in breaks, so that batches of the list drawn apart,
+// such as the sets of a mesh, never share one.
+//
+// Every meshlet gets a bounding sphere around its vertices and a normal cone
+// around the normals of its triangles, in the space of the vertex
+// positions; xcbFormat.h describes the culling tests they are meant for.
+//
+// The builder only reads the arrays it is given, so the encoders of several
+// meshes can run it at the same time.
+//
+// *****************************************************************************
+
+#include "xcbFormat.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct Meshlets {
+  std::vector<xcb::Meshlet> meshlets;
+  std::vector<uint32_t>     vertices;     //mesh vertex of each meshlet vertex
+  std::vector<uint8_t>      triangles;    //3 meshlet vertex indices per triangle
+};
+
+void buildMeshlets(const uint32_t* triangles, size_t triangleCount,
+                   const float* vertices, unsigned int stride, size_t vertexCount,
+                   const uint32_t* breaks, size_t breakCount,
+                   Meshlets& result);
@@ -0,0 +1,108 @@
+#pragma once
+
+// OutputSink.h
+
+//
+// *****************************************************************************
+//
+// CLASS:    OutputSink
+//
+// *****************************************************************************
+//
+// CLASS DESCRIPTION (OutputSink)
+//
+// OutputSink is the destination the exporters write their bytes to.  It sits
+// under ExporterModel and WriterModel so the translators never talk to the
+// file system directly, and a different destination (memory, file, ...) can
+// be plugged in without touching the writers.
+//
+// FileOutputSink keeps a large user-space buffer and only hands data to the
+// OS when that buffer is full or when flush() is called explicitly, instead of
+// once per formatted value.
+//
+// MemoryOutputSink appends everything to a std::string; it is used to encode
+// data away from the file, e.g. on worker threads.
+//
+// SinkStreamBuf adapts a sink to a std::streambuf so the existing
+// std::ostream based writers keep working unchanged on top of it.
+//
+// *****************************************************************************
+
+#include <cstddef>
+#include <fstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+class OutputSink {
+
+public:
+  virtual ~OutputSink() {}
+
+  virtual bool    write(const char* data, size_t size) = 0;
+  virtual bool    flush() = 0;
+  virtual size_t  bytesWritten() const = 0;
+};
+
+
+class FileOutputSink : public OutputSink {
+
+public:
+  static const size_t kDefaultBufferSize = 4 * 1024 * 1024;
+
+  FileOutputSink(const char* fileName, bool binary = false,
+                 size_t bufferSize = kDefaultBufferSize);
+  ~FileOutputSink() override;
+
+  bool    isOpen() const;
+  bool    write(const char* data, size_t size) override;
+  bool    flush() override;
+  size_t  bytesWritten() const override;
+  bool    close();
+
+private:
+  bool    drain();
+
+  std::ofstream     fFile;
+  std::vector<char> fBuffer;
+  size_t            fUsed;
+  size_t            fBytesWritten;
+  bool              fFailed;
+};
+
+
+class MemoryOutputSink : public OutputSink {
+
+public:
+  explicit MemoryOutputSink(std::string& buffer);
+
+  bool    write(const char* data, size_t size) override;
+  bool    flush() override;
+  size_t  bytesWritten() const override;
+
+private:
+  std::string& fBuffer;
+};
+
+
+class SinkStreamBuf : public std::streambuf {
+
+public:
+  explicit SinkStreamBuf(OutputSink& sink);
+  ~SinkStreamBuf() override;
+
+protected:
+  int_type        overflow(int_type ch) override;
+  std::streamsize xsputn(const char* data, std::streamsize size) override;
+  int             sync() override;
+  pos_type        seekoff(off_type off, std::ios_base::seekdir dir,
+                          std::ios_base::openmode which) override;
+
+private:
+  bool            drain();
+
+  static const size_t kPutAreaSize = 16 * 1024;
+
+  OutputSink& fSink;
+  char        fPutArea[kPutAreaSize];
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+// Quantize.h
+
+//
+// *****************************************************************************
+//
+// Quantized vertex channels
+//
+// *****************************************************************************
+//
+// With the quantize option the binary writer stores the vertex channels in
+// the compact encodings GPUs decode for free, converted by the
+// ExportKernels:
+//   positions   unorm16 (x, y, z, 0) against the bounding box of the mesh:
+//               q = round((p - low) * 65535 / (high - low)), decoded as
+//               low + q * (high - low) / 65535
+//   normals     octahedral snorm16 (u, v): the unit vector is projected onto
+//               the octahedron |x| + |y| + |z| = 1, whose lower half is
+//               folded over the diagonals into the [-1, 1] square
+//   tangents,   octahedral snorm8 (u, v); they only steer normal maps, so
+//   binormals   8 bits, about a degree, are enough
+//   uvs         IEEE half floats (u, v)
+//
+// The functions below decode these encodings again, so the writer can
+// report the largest error every channel was given.  Errors of positions and
+// uvs are distances, errors of vectors are angles in degrees; zero length
+// vectors are left out.
+//
+// *****************************************************************************
+
+#include "MeshSnapshot.h"
+
+#include <cstddef>
+#include <cstdint>
+
+//largest value of an unorm16 position component
+//
+const float kPositionSteps = 65535.0f;
+
+float   halfToFloat(uint16_t half);
+void    decodeOctahedral(float u, float v, float* vector);
+
+void    positionBounds(const Float3Stream& positions, float* low, float* high);
+void    positionScale(const float* low, const float* high, float* scale);
+double  positionError(const Float3Stream& positions, const uint16_t* xyzw,
+                      const float* low, const float* high);
+double  octahedralError(const Float3Stream& vectors, const int16_t* uv);
+double  octahedralError(const Float3Stream& vectors, const int8_t* uv);
+double  halfError(const float* values, const uint16_t* halves, size_t count);
@@ -0,0 +1,52 @@
+#pragma once
+
+// ShaderCache.h
+
+//
+// *****************************************************************************
+//
+// CLASS:    ShaderCache
+//
+// *****************************************************************************
+//
+// CLASS DESCRIPTION (ShaderCache)
+//
+// The meshes of a scene share a handful of shading groups, and finding the
+// file texture of one walks the dependency graph: the connection of its
+// surfaceShader plug, the shader's color plug and an upstream search for a
+// file texture node.  ShaderCache does that walk once per shading group and
+// remembers the result, keyed by MObjectHandle::hashCode() of the node.
+//
+// ExporterModel owns one cache for the length of an export and hands it to
+// every writer before extractGeometry().  Like every Maya call it is only
+// used on the main thread.
+//
+// *****************************************************************************
+
+#include <maya/MObject.h>
+#include <maya/MString.h>
+
+#include <unordered_map>
+
+class ShaderCache {
+
+public:
+  struct Entry {
+    bool    resolved;   //false if no shader or color plug was found; the
+                        //sets of such a shading group are not exported
+    MString texture;    //file texture name, empty if the color has none
+  };
+
+  const Entry&  lookup(const MObject& shadingGroup);
+  void          clear();
+
+private:
+  static Entry    resolve(const MObject& shadingGroup);
+  static MObject  findShader(const MObject& shadingGroup);
+
+  struct Slot {
+    MObject node;
+    Entry   entry;
+  };
+  std::unordered_multimap<unsigned int, Slot> fSlots;
+};
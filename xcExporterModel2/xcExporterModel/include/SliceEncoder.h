@@ -0,0 +1,57 @@
+#pragma once
+
+// SliceEncoder.h
+
+//
+// *****************************************************************************
+//
+// CLASS:    SliceEncoder
+//
+// *****************************************************************************
+//
+// CLASS DESCRIPTION (SliceEncoder)
+//
+// SliceEncoder splits one long loop of a writer, e.g. over the faces of a
+// mesh, into contiguous slices and runs them on a WorkerPool, so a single
+// huge mesh is not limited to the speed of one core.
+//
+// forEachSlice() runs a body once per slice, e.g. to count what every slice
+// will produce; an exclusive prefix sum over those counts then gives each
+// slice its starting offset into the flat arrays (see prefixSum()).
+//
+// encode() formats every slice into a private buffer and appends the buffers
+// to the output stream in slice order, so the bytes are identical to a
+// single loop over the whole range.
+//
+// Without a pool, or when the range is too small to be worth splitting,
+// there is a single slice and encode() writes straight to the stream.
+//
+// *****************************************************************************
+
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <vector>
+
+class WorkerPool;
+
+class SliceEncoder {
+
+public:
+  SliceEncoder(WorkerPool* pool, size_t itemCount, size_t minSliceItems);
+
+  size_t  sliceCount() const;
+  size_t  sliceBegin(size_t slice) const;
+  size_t  sliceEnd(size_t slice) const;
+
+  void    forEachSlice(const std::function<void(size_t slice)>& body) const;
+  bool    encode(std::ostream& os,
+                 const std::function<bool(size_t slice, std::ostream& os)>& encodeSlice) const;
+
+  static size_t prefixSum(std::vector<size_t>& counts);
+
+private:
+  WorkerPool* fPool;
+  size_t      fItemCount;
+  size_t      fSliceCount;
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+// TextFormatter.h
+
+//
+// *****************************************************************************
+//
+// CLASS:    TextFormatter
+//
+// *****************************************************************************
+//
+// CLASS DESCRIPTION (TextFormatter)
+//
+// TextFormatter is the number formatting engine of the text writers.  It
+// replaces std::ostream::operator<< for the hot loops, which goes through
+// the stream's locale for every value and prints only 6 significant digits.
+//
+// Values are converted with std::to_chars into a reusable char buffer, which
+// is handed to the target stream whenever it fills up and when the formatter
+// is flushed or destroyed.  Conversion is independent of the locale.
+//
+// By default (precision kShortest) floating point values are printed with
+// the shortest text that reads back to the exact same value; floats are
+// converted as floats, so 0.1f prints as 0.1.  With a precision of N >= 0
+// values are printed in fixed notation with N digits after the point.
+//
+// *****************************************************************************
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+class TextFormatter {
+
+public:
+  static const int kShortest = -1;
+
+  explicit TextFormatter(std::ostream& os, int precision = kShortest);
+  ~TextFormatter();
+
+  TextFormatter& operator<<(double value);
+  TextFormatter& operator<<(float value);
+  TextFormatter& operator<<(int value);
+  TextFormatter& operator<<(unsigned int value);
+  TextFormatter& operator<<(char value);
+  TextFormatter& operator<<(const char* text);
+  TextFormatter& operator<<(const std::string& text);
+
+  void    append(const char* text, size_t size);
+  bool    flush();
+
+private:
+  TextFormatter(const TextFormatter&);
+  TextFormatter& operator=(const TextFormatter&);
+
+  char*   reserve(size_t size);
+
+  //largest text a single number can produce: a fixed notation double with
+  //309 integer digits, a sign, a point and the maximum precision
+  //
+  static const int    kMaxPrecision = 32;
+  static const size_t kMaxNumberSize = 1 + 309 + 1 + kMaxPrecision;
+  static const size_t kBufferSize = 64 * 1024;
+
+  std::ostream&     fOut;
+  int               fPrecision;
+  std::vector<char> fBuffer;
+  size_t            fUsed;
+};
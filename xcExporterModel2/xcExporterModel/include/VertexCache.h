@@ -0,0 +1,52 @@
+#pragma once
+
+// VertexCache.h
+
+//
+// *****************************************************************************
+//
+// Post-transform vertex cache optimization of indexed triangle lists
+//
+// *****************************************************************************
+//
+// vertexCacheOrder() computes an order of the triangles of an index buffer
+// that keeps the vertices a GPU has just transformed in use for as long as
+// possible, with Tom Forsyth's "Linear-Speed Vertex Cache Optimisation":
+// every vertex is scored by its position in a simulated 32 entry LRU cache
+// and by how many of its triangles are still left, and the triangle with
+// the highest total score among those touching the cache is emitted next.
+// It runs in time linear in the number of triangles.
+//
+// firstUseOrder() then numbers the vertices in the order the reordered
+// triangles first use them, so the vertex fetches walk through the vertex
+// table mostly forward.  Vertices no triangle uses keep their relative
+// order after all the others.
+//
+// measureVertexCache() simulates a FIFO cache of the given size over an
+// index buffer and returns
+//   ACMR  average cache miss ratio: transformed vertices per triangle,
+//         between 3 and about 0.5 for a regular grid
+//   ATVR  average transformed vertex ratio: transformed vertices per
+//         vertex used, 1 being optimal
+//
+// *****************************************************************************
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct VertexCacheStats {
+  double acmr;
+  double atvr;
+};
+
+//size of the FIFO the export log reports ACMR and ATVR for
+//
+const size_t kReportedCacheSize = 16;
+
+void              vertexCacheOrder(const uint32_t* indices, size_t triangleCount,
+                                   size_t vertexCount, std::vector<uint32_t>& order);
+void              firstUseOrder(const uint32_t* indices, size_t indexCount,
+                                size_t vertexCount, std::vector<uint32_t>& remap);
+VertexCacheStats  measureVertexCache(const uint32_t* indices, size_t triangleCount,
+                                     size_t vertexCount, size_t cacheSize);
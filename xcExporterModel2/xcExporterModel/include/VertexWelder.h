@@ -0,0 +1,54 @@
+#pragma once
+
+// VertexWelder.h
+
+//
+// *****************************************************************************
+//
+// CLASS:    VertexWelder
+//
+// *****************************************************************************
+//
+// CLASS DESCRIPTION (VertexWelder)
+//
+// VertexWelder merges identical vertex attribute tuples (position, normal,
+// uv per set, ...) into a table of unique vertices and hands back the index
+// of each tuple in that table, which is what an index buffer needs.
+//
+// Every vertex is a fixed number of floats (the stride).  Two tuples are the
+// same vertex only if all their floats are bit-identical.  Lookups use an
+// open-addressing hash table with linear probing whose slots hold indices
+// into the vertex table, so the table itself stays one contiguous array.
+// Tuples are hashed by the hashFloats kernel of the installed ExportKernels.
+//
+// *****************************************************************************
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class VertexWelder {
+
+public:
+  VertexWelder(unsigned int stride, size_t expectedTuples);
+
+  uint32_t            weld(const float* attributes);
+
+  unsigned int        stride() const;
+  uint32_t            vertexCount() const;
+  const std::vector<float>& vertices() const;
+
+private:
+  bool                matches(uint32_t vertex, const float* attributes) const;
+  void                grow();
+
+  static const uint32_t kEmptySlot = 0xFFFFFFFFu;
+
+  uint32_t              (*fHash)(const float* values, unsigned int count);
+  unsigned int          fStride;
+  uint32_t              fVertexCount;
+  std::vector<float>    fVertices;
+  std::vector<uint32_t> fSlots;
+  std::vector<uint32_t> fHashes;
+  size_t                fMask;
+};
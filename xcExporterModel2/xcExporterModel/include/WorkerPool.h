@@ -0,0 +1,55 @@
+#pragma once
+
+// WorkerPool.h
+
+//
+// *****************************************************************************
+//
+// CLASS:    WorkerPool
+//
+// *****************************************************************************
+//
+// CLASS DESCRIPTION (WorkerPool)
+//
+// WorkerPool is a fixed set of threads that run submitted tasks in FIFO
+// order.  It knows nothing about Maya; tasks handed to it must not call into
+// the Maya API, which is only safe on the main thread.
+//
+// parallelFor() runs a loop body over an index range on the calling thread
+// and on any workers that are free.  The caller always takes part, so it may
+// be used from inside a task running on the pool itself without deadlocking
+// when every other worker is busy.
+//
+// *****************************************************************************
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkerPool {
+
+public:
+  explicit WorkerPool(unsigned int threadCount);
+  ~WorkerPool();
+
+  void          submit(std::function<void()> task);
+  void          parallelFor(size_t count, const std::function<void(size_t)>& body);
+  unsigned int  threadCount() const;
+
+  static unsigned int hardwareThreads();
+
+private:
+  WorkerPool(const WorkerPool&);
+  WorkerPool& operator=(const WorkerPool&);
+
+  void          workerLoop();
+
+  std::vector<std::thread>          fThreads;
+  std::deque<std::function<void()> > fTasks;
+  std::mutex                        fMutex;
+  std::condition_variable           fTaskReady;
+  bool                              fStopping;
+};
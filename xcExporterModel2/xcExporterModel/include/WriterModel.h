@@ -1,3 +1,5 @@
+#pragma once
+
 //-
 // ==========================================================================
 // Copyright 1995,2006,2008 Autodesk, Inc. All rights reserved.
@@ -28,16 +30,36 @@
 //    #include <fstream>
 //
 // The following functions must be implemented:
-// constructor - which takes in MDagPath and MStatus object addresses
+// constructor - which takes in MDagPath, ExportOptions and MStatus object
+//               addresses, and one which takes in a MeshCapture and
+//               ExportOptions
 // destructor - which destroys any objects created in the constructor
 // writeToFile() - which performs the actual data export
 // outputSingleSet() - which performs the export of a particular polygonal set 
 //					   on the mesh
 //
+// In triangulated mode writers may call batchTrianglesBySet() and output the
+// triangles in fTriangleOrder, so that the triangles of every set form one
+// contiguous range a renderer draws with a single call.
+//
 // The extractGeometry() function may be overridden to extract more data that
 // it is doing currently, but be sure to call this class' extractGeometry() 
 // method as its first operation so that essential data is extracted.
 //
+// extractGeometry() runs on Maya's main thread.  writeToFile() may run on a
+// worker thread of the EncodePipeline, so it must only read what
+// extractGeometry() gathered, must not call into Maya, and reports problems
+// through reportError() instead of MGlobal.  extractGeometry() therefore
+// copies everything out of the Maya arrays and strings into plain buffers,
+// std::vector and std::string, before the writer is submitted; the Maya
+// types are only used on the main thread.  Long loops inside writeToFile()
+// may be split into slices over fSlicePool with a SliceEncoder.
+//
+// Everything extractGeometry() gathers is also a MeshCapture: captureGeometry()
+// copies it out and the capture constructor restores it, without a mesh to
+// extract from.  The Maya calls all live in WriterModelMaya.cpp, so a writer
+// built from a capture encodes without Maya, see replay/xcReplay.cpp.
+//
 // It is recommended that smaller helper functions are added to any derived
 // classes, to export and format specific data about the mesh.  
 //
@@ -49,54 +71,174 @@
 //
 // *****************************************************************************
 
-#include <maya/MFnMesh.h>
-#include <maya/MPointArray.h>
-#include <maya/MFloatVectorArray.h>
-#include <maya/MFloatArray.h>
+#include <maya/MStatus.h>
+#include <maya/MString.h>
+#include <maya/MObjectArray.h>
+
+#include "ExportOptions.h"
+#include "EncodePipeline.h"
+#include "MeshSnapshot.h"
+#include "MeshCapture.h"
+#include "ShaderCache.h"
+#include "ExportTrace.h"
+#include "ExportReport.h"
 
+#include <cstdint>
+#include <ios>
 #include <iosfwd>
+#include <mutex>
+#include <string>
+#include <vector>
 
-class WriterModel {
+class MDagPath;
+class MFnMesh;
+
+//Used to store UV set information: the set's coordinates and the uv index
+//of every face-vertex, so writers index it directly
+//
+struct UVSet {
+  std::string		name;
+  FloatStream		uArray;
+  FloatStream		vArray;
+  std::vector<int>	faceUVIds;    //uv index of each face-vertex, -1 if none
+};
+
+class WriterModel : public EncodeJob {
 
 public:
-  WriterModel(MDagPath dagPath, MStatus& status);
+  WriterModel(const MDagPath& dagPath, const ExportOptions& options, MStatus& status);
+  WriterModel(const MeshCapture& capture, const ExportOptions& options);
   virtual				~WriterModel();
   virtual MStatus		extractGeometry();
   virtual MStatus		writeToFile(std::ostream& os) = 0;
 
+  void				setShaderCache(ShaderCache* cache);
+  void				setTrace(ExportTrace* trace);
+  void				setReport(ExportReport* report);
+  void				setCapture(CaptureWriter* capture);
+  void				captureGeometry(MeshCapture& capture) const;
+
+  bool				encode(std::ostream& os, WorkerPool* pool) override;
+  void				committed(bool succeeded) override;
+
 protected:
   //Methods
   //
-  MObject		findShader(const MObject& setNode);
+  MStatus		extractSets();
+  MStatus		extractUVSets();
+  MStatus		getFaceVertexUVIds(const MString& uvSetName, std::vector<int>& faceUVIds);
+  void		getTriangleFaces(std::vector<int>& triangleFaces) const;
+  void		batchTrianglesBySet();
   virtual MStatus		outputSets(std::ostream& os);
-  virtual	MStatus		outputSingleSet(std::ostream& os,
-                                    MString setName,
-                                    MIntArray faces,
-                                    MString textureName) = 0;
+  virtual	MStatus		outputSingleSet(std::ostream& os, unsigned int set) = 0;
   static	void		outputTabs(std::ostream& os, unsigned int tabCount);
+  void		reportError(const std::string& message);
+  void		reportInfo(const std::string& message);
+  void		reportChannel(const std::string& name, std::ostream& os, std::streamoff start,
+                        size_t elements, size_t rawBytes);
+  virtual size_t		heldBytes() const;
 
   //Data Members
   //
 
+  //the settings of the export this writer is part of
+  //
+  ExportOptions		fOptions;
+
+  //threads writeToFile() may split long loops over, see SliceEncoder; NULL
+  //outside of encode()
+  //
+  WorkerPool*			fSlicePool;
+
+  //the trace the extraction and output stages are timed into with a
+  //TraceScope; NULL if the export is not traced
+  //
+  ExportTrace*		fTrace;
+
+  //the report the bytes of every channel go to, see reportChannel(); NULL
+  //if the export has none
+  //
+  ExportReport*		fReport;
+
+  //the file extractGeometry() writes a MeshCapture of the mesh to; NULL if
+  //the export captures nothing
+  //
+  CaptureWriter*		fCapture;
+
+  //the shape's partial path name
+  //
+  std::string			fShapeName;
+
   //the current UV set's name
   //
-  MString				fCurrentUVSetName;
+  std::string			fCurrentUVSetName;
+
+  //the inclusive matrix of the shape's path, row-major in Maya's row
+  //vector convention; baked into fSnapshot unless the export writes local
+  //space
+  //
+  double				fWorldMatrix[4][4];
 
-  //for storing general mesh information
+  //for storing general mesh information: positions, normals, tangents and
+  //binormals as float32 streams, in world or object space
   //
-  MPointArray			fVertexArray;
+  MeshSnapshot		fSnapshot;
   //MColorArray			fColorArray;
-  MFloatVectorArray	fNormalArray;
-  MFloatVectorArray	fTangentArray;
-  MFloatVectorArray	fBinormalArray;
-  MIntArray idexes;
 
-  //for storing DAG objects
+  //every uv set of the mesh, if the export asks for uvs
+  //
+  std::vector<UVSet>	fUVSets;
+
+  //for storing the face topology; every face-vertex array is laid out
+  //face after face, in the order returned by MFnMesh::getVertices
+  //
+  std::vector<int>	fFaceVertexCounts;
+  std::vector<int>	fFaceVertexIds;
+  std::vector<int>	fFaceNormalIds;
+  std::vector<int>	fTriangleCounts;
+  std::vector<int>	fTriangleVertices;
+
+  //for storing DAG objects; NULL for a writer created from a capture, and
+  //fMesh until extractGeometry().  Only used on the main thread.
   //
   MFnMesh* fMesh;
   MDagPath* fDagPath;
   MObjectArray		fPolygonSets;
   MObjectArray		fPolygonComponents;
+
+  //the sets resolved by extractSets(): name, faces and texture of each;
+  //the faces as sorted (start, count) runs of face indices
+  //
+  std::vector<std::string> fSetNames;
+  std::vector<std::vector<uint32_t> > fSetFaceRanges;
+  std::vector<std::string> fSetTextures;
+
+  //in triangulated mode, set by batchTrianglesBySet(): the triangles of
+  //fTriangleVertices ordered set after set, and the (first, count) range
+  //of every set in that order followed by the range of the triangles in
+  //no set
+  //
+  std::vector<uint32_t> fTriangleOrder;
+  std::vector<uint32_t> fSetTriangleRanges;
+
+private:
+  //the shading group lookups extractSets() goes through: the export's
+  //cache, or fOwnShaderCache if none was set
+  //
+  ShaderCache*			fShaderCache;
+  ShaderCache				fOwnShaderCache;
+
+  //errors found and statistics gathered by writeToFile(), shown by
+  //committed()
+  //
+  std::vector<std::string> fErrors;
+  std::vector<std::string> fInfos;
+  std::mutex				fMessageMutex;
+
+  //what reportChannel() and encode() accounted for this shape, added to
+  //fReport by committed()
+  //
+  ShapeReport				fShapeReport;
 };
 
 
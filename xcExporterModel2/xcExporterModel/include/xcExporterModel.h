@@ -1,3 +1,5 @@
+#pragma once
+
 //-
 // ==========================================================================
 // Copyright 1995,2006,2008 Autodesk, Inc. All rights reserved.
@@ -44,6 +46,7 @@ public:
 
 private:
   WriterModel* createPolyWriter(const MDagPath dagPath, MStatus& status) override;
+  bool			writeInstance(std::ostream& os, const InstanceRecord& instance) const override;
   void			writeHeader(std::ostream& os) override;
 };
 
@@ -0,0 +1,18 @@
+#pragma once
+
+// xcFormat.h
+
+//
+// *****************************************************************************
+//
+// xc text layout
+//
+// *****************************************************************************
+//
+// The text that is shared by the writers of the .xc format: every shape,
+// see xcWriterModel, and every instance, see xcExporterModel, opens with its
+// name between two SHAPE_DIVIDER lines.
+//
+// *****************************************************************************
+
+#define SHAPE_DIVIDER "*******************************************************************************\n"
@@ -1,3 +1,5 @@
+#pragma once
+
 //-
 // ==========================================================================
 // Copyright 1995,2006,2008 Autodesk, Inc. All rights reserved.
@@ -28,9 +30,12 @@
 // - colors per vertex
 // - normals per vertex
 // - current uv set and coordinates
-// - component sets
+// - component sets as ranges of faces and, in triangulated mode, of the
+//   triangles, which are batched set after set
 // - file textures (for the current uv set)
 // - other uv sets and coordinates
+// - in triangulated mode, the triangles of every face and the face of each
+//   triangle
 //
 // *****************************************************************************
 
@@ -38,30 +43,19 @@
 
 #include <iosfwd>
 
-//Used to store UV set information
-//
-struct UVSet {
-  MFloatArray	uArray;
-  MFloatArray	vArray;
-  MString		name;
-  UVSet* next;
-};
-
 class xcWriterModel : public WriterModel {
 
 public:
-  xcWriterModel(const MDagPath& dagPath, MStatus& status);
+  xcWriterModel(const MDagPath& dagPath, const ExportOptions& options, MStatus& status);
+  xcWriterModel(const MeshCapture& capture, const ExportOptions& options);
   ~xcWriterModel() override;
-  MStatus extractGeometry() override;
   MStatus writeToFile(std::ostream& os) override;
 
 private:
   //Functions
   //
-  MStatus	outputSingleSet(std::ostream& os,
-    MString setName,
-    MIntArray faces,
-    MString textureName) override;
+  MStatus	outputSingleSet(std::ostream& os, unsigned int set) override;
+  MStatus outputWorldMatrix(std::ostream& os);
   MStatus outputFaces(std::ostream& os);
   MStatus outputVertices(std::ostream& os);
   MStatus	outputVertexInfo(std::ostream& os);
@@ -70,11 +64,6 @@ private:
   MStatus	outputBinormals(std::ostream& os);
   MStatus	outputColors(std::ostream& os);
   MStatus	outputUVs(std::ostream& os);
-
-  //Data Member
-  //for storing UV information
-  //
-  UVSet* fHeadUVSet;
 };
 
 
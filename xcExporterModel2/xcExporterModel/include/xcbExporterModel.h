@@ -0,0 +1,40 @@
+#pragma once
+
+// xcbExporterModel.h
+
+// *****************************************************************************
+//
+// CLASS:    xcbExporterModel
+//
+// *****************************************************************************
+//
+// CLASS DESCRIPTION (xcbExporterModel)
+//
+// xcbExporterModel is a class derived from ExporterModel.  It allows the
+// export of polygonal mesh data in the xcb binary container format described
+// in xcbFormat.h.  The file extension for this type is ".xcb".
+//
+// *****************************************************************************
+
+#include "ExporterModel.h"
+
+#include <iosfwd>
+
+class xcbExporterModel : public ExporterModel {
+
+public:
+  xcbExporterModel() {}
+  ~xcbExporterModel() override;
+
+  static	void* creator();
+  MString			defaultExtension() const override;
+
+
+private:
+  ExportOptions defaultOptions() const override;
+  bool			  isBinary() const override;
+  WriterModel* createPolyWriter(const MDagPath dagPath, MStatus& status) override;
+  bool			writeInstance(std::ostream& os, const InstanceRecord& instance) const override;
+  void			writeHeader(std::ostream& os) override;
+  void			writeFooter(std::ostream& os) override;
+};
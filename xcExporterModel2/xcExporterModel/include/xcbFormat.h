@@ -0,0 +1,227 @@
+#pragma once
+
+// xcbFormat.h
+
+//
+// *****************************************************************************
+//
+// xcb binary container layout
+//
+// *****************************************************************************
+//
+// An .xcb file is a 16 byte FileHeader followed by a flat sequence of chunks.
+// Every chunk starts with a 16 byte ChunkHeader and its payload is padded with
+// zeros up to the next 16 byte boundary, so every payload starts 16 byte
+// aligned relative to the start of the file.  Array chunks can therefore be
+// memcpy'd or mmap'd straight into engine buffers.
+//
+// All values are little-endian.  Float arrays are IEEE float32 and index
+// arrays are uint32; an index of 0xFFFFFFFF means "not assigned".  Matrices
+// are float64[16], row-major, in Maya's row vector convention.
+//
+// Each shape starts with a kShape chunk (its name) and owns every chunk up to
+// the next kShape, kInstance or kEnd chunk.  Chunks of channels switched off
+// in the export options are left out:
+//
+//   kShape          char[count]     partial DAG path of the shape
+//   kWorldMatrix    float64[16]     with the localSpace option only: the
+//                                   world matrix of the shape; the vertex
+//                                   channels and meshlet bounds are then in
+//                                   object space, otherwise in world space
+//   kPositions      float32[3*count] vertex positions (x, y, z)
+//   kNormals        float32[3*count] normals (x, y, z)
+//   kTangents       float32[3*count] tangents of the current uv set, in
+//                                   MFnMesh::getTangents order
+//   kBinormals      float32[3*count] binormals, same order as kTangents
+//   kFaceCounts     uint32[count]   number of vertices of each face
+//   kFacePositions  uint32[count]   position index of each face-vertex
+//   kFaceNormals    uint32[count]   normal index of each face-vertex
+//   kUVSetName      char[count]     name of the UV set the next chunks belong to
+//   kUVs            float32[2*count] (u, v) pairs of that UV set
+//   kFaceUVs        uint32[count]   uv index of each face-vertex in that set
+//   kVertices       float32[count*stride] welded unique vertices; stride is
+//                                   size / (4 * count) floats laid out as
+//                                   position xyz, normal xyz (if stride is
+//                                   6 + 2 * the number of uv sets), then uv
+//                                   for every uv set in kUVSetName order
+//   kVertexIndices  uint32[count]   kVertices index of each face-vertex
+//   kTriangles      uint32[3*count] triangulated faces, indexing kVertices;
+//                                   with the vertexCache option they are
+//                                   ordered for the vertex cache and
+//                                   kVertices is in first-use order
+//   kTriangleFaces  uint32[count]   face each triangle was cut from
+//   kMeshlets       Meshlet[count]  clusters of at most kMaxMeshletVertices
+//                                   vertices and kMaxMeshletTriangles
+//                                   triangles covering kTriangles, with
+//                                   their culling bounds (see Meshlet)
+//   kMeshletVertices uint32[count]  kVertices index of every meshlet vertex
+//   kMeshletTriangles uint8[3*count] triangles of every meshlet, indexing
+//                                   its vertices in kMeshletVertices
+//   kSetName        char[count]     name of a face set
+//   kSetTexture     char[count]     file texture of that set (may be empty)
+//   kSetFaceRanges  uint32[2*count] faces in that set as sorted (start,
+//                                   count) runs of face indices
+//   kSetTriangles   uint32[2]       in triangulated mode: the (first,
+//                                   count) range of kTriangles drawn with
+//                                   that set
+//   kSetMeshlets    uint32[2]       with meshlets: the (first, count) range
+//                                   of kMeshlets covering those triangles
+//
+// A shape is written in one of two layouts, so a reader expects one of
+// these chunk sets besides kShape, kWorldMatrix, the tangents and the sets:
+//
+//   indexed     kFaceCounts, kUVSetName for every uv set (names only),
+//               kVertices and kVertexIndices, and in triangulated mode
+//               kTriangles, kTriangleFaces and the meshlet chunks.  This is
+//               the layout of the indexed option, the default, and always
+//               the one of triangulated mode.
+//   per face-vertex
+//               kPositions, kNormals, kFaceCounts, kFacePositions,
+//               kFaceNormals, and kUVSetName, kUVs, kFaceUVs for every uv
+//               set.  Written with indexed=0 and triangulate=0 only.
+//
+// In triangulated mode kTriangles is batched by set: the triangles of every
+// set in kSetName order, then those of faces in no set.  A face in several
+// sets is drawn with the first of them, and no meshlet spans two batches, so
+// every set is one draw call of an index range or a meshlet range.
+//
+// With the quantize option (see Quantize.h) the float32 channels of either
+// layout are replaced by quantized ones; everything else stays the same:
+//
+//   kPositionBounds float32[3*count] the 2 corners low, high of the box
+//                                   kPositionsQ or kVerticesQ is relative to
+//   kPositionsQ     uint16[4*count] unorm16 positions (x, y, z, 0), instead
+//                                   of kPositions
+//   kNormalsQ       int16[2*count]  octahedral snorm16 normals (u, v),
+//                                   instead of kNormals
+//   kTangentsQ      int8[2*count]   octahedral snorm8 tangents (u, v),
+//                                   instead of kTangents
+//   kBinormalsQ     int8[2*count]   octahedral snorm8 binormals, instead of
+//                                   kBinormals
+//   kUVsQ           uint16[2*count] half float (u, v) pairs, instead of kUVs
+//   kVerticesQ      uint8[count*stride] the welded vertices, instead of
+//                                   kVertices; stride is size / count bytes
+//                                   laid out as position uint16[4], normal
+//                                   int16[2] (if stride is 12 + 4 * the
+//                                   number of uv sets), then uv half[2] for
+//                                   every uv set
+//
+// A further instance of an instanced shape is not written as a shape but as
+// a reference to the shape exported for its first instance:
+//
+//   kInstance       char[count]     partial DAG path of the instance
+//   kInstanceOf     char[count]     kShape name of the exported instance
+//   kWorldMatrix    float64[16]     world matrix of the instance
+//   kRelativeMatrix float64[16]     maps the exported positions of that
+//                                   shape onto this instance; with the
+//                                   localSpace option it is the world matrix
+//
+// A kEnd chunk with no payload terminates the file.
+//
+// *****************************************************************************
+
+#include <cstdint>
+#include <cstddef>
+#include <iosfwd>
+
+namespace xcb {
+
+constexpr uint32_t makeId(char a, char b, char c, char d)
+{
+  return static_cast<uint32_t>(static_cast<unsigned char>(a)) |
+         static_cast<uint32_t>(static_cast<unsigned char>(b)) << 8 |
+         static_cast<uint32_t>(static_cast<unsigned char>(c)) << 16 |
+         static_cast<uint32_t>(static_cast<unsigned char>(d)) << 24;
+}
+
+const uint32_t kMagic = makeId('X', 'C', 'B', '\0');
+const uint32_t kVersion = 6;
+const uint32_t kAlignment = 16;
+const uint32_t kUnassigned = 0xFFFFFFFFu;
+
+enum ChunkId : uint32_t {
+  kShape = makeId('S', 'H', 'A', 'P'),
+  kPositions = makeId('P', 'O', 'S', ' '),
+  kNormals = makeId('N', 'R', 'M', ' '),
+  kTangents = makeId('T', 'A', 'N', ' '),
+  kBinormals = makeId('B', 'N', 'R', 'M'),
+  kFaceCounts = makeId('F', 'C', 'N', 'T'),
+  kFacePositions = makeId('F', 'P', 'O', 'S'),
+  kFaceNormals = makeId('F', 'N', 'R', 'M'),
+  kUVSetName = makeId('U', 'V', 'N', 'M'),
+  kUVs = makeId('U', 'V', 'S', ' '),
+  kFaceUVs = makeId('F', 'U', 'V', 'S'),
+  kVertices = makeId('V', 'T', 'X', ' '),
+  kVertexIndices = makeId('V', 'I', 'D', 'X'),
+  kTriangles = makeId('T', 'R', 'I', ' '),
+  kTriangleFaces = makeId('T', 'F', 'A', 'C'),
+  kMeshlets = makeId('M', 'S', 'H', 'L'),
+  kMeshletVertices = makeId('M', 'S', 'L', 'V'),
+  kMeshletTriangles = makeId('M', 'S', 'L', 'T'),
+  kPositionBounds = makeId('P', 'B', 'N', 'D'),
+  kPositionsQ = makeId('P', 'O', 'S', 'Q'),
+  kNormalsQ = makeId('N', 'R', 'M', 'Q'),
+  kTangentsQ = makeId('T', 'A', 'N', 'Q'),
+  kBinormalsQ = makeId('B', 'N', 'R', 'Q'),
+  kUVsQ = makeId('U', 'V', 'S', 'Q'),
+  kVerticesQ = makeId('V', 'T', 'X', 'Q'),
+  kSetName = makeId('S', 'E', 'T', 'N'),
+  kSetTexture = makeId('S', 'E', 'T', 'T'),
+  kSetFaceRanges = makeId('S', 'E', 'T', 'R'),
+  kSetTriangles = makeId('S', 'E', 'T', 'I'),
+  kSetMeshlets = makeId('S', 'E', 'T', 'M'),
+  kInstance = makeId('I', 'N', 'S', 'T'),
+  kInstanceOf = makeId('I', 'N', 'O', 'F'),
+  kWorldMatrix = makeId('W', 'M', 'T', 'X'),
+  kRelativeMatrix = makeId('R', 'M', 'T', 'X'),
+  kEnd = makeId('E', 'N', 'D', ' ')
+};
+
+struct FileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t alignment;
+  uint32_t reserved;
+};
+
+struct ChunkHeader {
+  uint32_t id;
+  uint32_t count;   //number of elements in the payload
+  uint64_t size;    //payload size in bytes, without padding
+};
+
+//a cluster of triangles for cluster culling.  Its vertices are
+//kMeshletVertices[vertexOffset, vertexOffset + vertexCount) and its
+//triangles the byte triplets kMeshletTriangles[3 * triangleOffset, ...).
+//A meshlet can be skipped if its bounding sphere is outside the view, or,
+//for a camera at position eye, if
+//  dot(normalize(coneApex - eye), coneAxis) >= coneCutoff
+//in which case all of its triangles face away.  A coneCutoff of 1 means
+//the triangles face too many ways to ever be culled like that.
+//
+const uint32_t kMaxMeshletVertices = 64;
+const uint32_t kMaxMeshletTriangles = 124;
+
+struct Meshlet {
+  uint32_t vertexOffset;
+  uint32_t triangleOffset;
+  uint32_t vertexCount;
+  uint32_t triangleCount;
+  float    center[3];
+  float    radius;
+  float    coneApex[3];
+  float    coneCutoff;
+  float    coneAxis[3];
+  float    reserved;
+};
+
+static_assert(sizeof(FileHeader) == kAlignment, "FileHeader must be 16 bytes");
+static_assert(sizeof(ChunkHeader) == kAlignment, "ChunkHeader must be 16 bytes");
+static_assert(sizeof(Meshlet) == 64, "Meshlet must be 64 bytes");
+
+void writeFileHeader(std::ostream& os);
+void writeChunk(std::ostream& os, uint32_t id, uint32_t count,
+                const void* data, uint64_t size);
+void writeStringChunk(std::ostream& os, uint32_t id, const char* str, size_t length);
+
+}
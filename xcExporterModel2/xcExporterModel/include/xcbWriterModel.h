@@ -0,0 +1,106 @@
+#pragma once
+
+// xcbWriterModel.h
+
+//
+// *****************************************************************************
+//
+// CLASS:    xcbWriterModel
+//
+// *****************************************************************************
+//
+// CLASS DESCRIPTION (xcbWriterModel)
+//
+// xcbWriterModel is a class derived from WriterModel.  It outputs the
+// following polygonal mesh data as chunks of the xcb binary container (see
+// xcbFormat.h):
+// - optionally tangents and binormals as float32 arrays
+// - face vertex counts
+// - with the indexed option or in triangulated mode, a welded table of
+//   unique (position, normal, uv per set) vertices, the index of each
+//   face-vertex in it and the names of the uv sets
+// - otherwise vertex positions and normals as float32 arrays, per
+//   face-vertex position and normal indices, and every uv set with its
+//   coordinates and per face-vertex uv indices
+// - in triangulated mode, a triangle list into that table and the face of
+//   each triangle, batched by set, optionally reordered for the vertex cache
+//   within every batch and cut into meshlets
+// - component sets with their file textures, face ranges and, in
+//   triangulated mode, the triangle and meshlet range of their batch
+//
+// With the quantize option the vertex channels and the welded table are
+// written in the compact encodings of Quantize.h instead of float32, and
+// the largest error of every channel is reported.
+//
+// *****************************************************************************
+
+#include "WriterModel.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+class xcbWriterModel : public WriterModel {
+
+public:
+  xcbWriterModel(const MDagPath& dagPath, const ExportOptions& options, MStatus& status);
+  xcbWriterModel(const MeshCapture& capture, const ExportOptions& options);
+  ~xcbWriterModel() override;
+  MStatus writeToFile(std::ostream& os) override;
+
+private:
+  //Functions
+  //
+  MStatus	outputSingleSet(std::ostream& os, unsigned int set) override;
+  MStatus outputPositions(std::ostream& os);
+  MStatus outputNormals(std::ostream& os);
+  MStatus outputTangents(std::ostream& os);
+  MStatus outputFaces(std::ostream& os);
+  MStatus outputUVs(std::ostream& os);
+  MStatus outputIndexedVertices(std::ostream& os);
+  MStatus outputTriangles(std::ostream& os);
+  MStatus outputMeshlets(std::ostream& os);
+  void    buildTriangles();
+  void    optimizeVertexCache();
+  void    outputQuantizedVertices(std::ostream& os);
+  void    reportQuantization();
+  bool    writesVertexTable() const;
+  size_t  heldBytes() const override;
+  static void outputVectorArray(std::ostream& os, uint32_t id, const Float3Stream& array);
+  double  outputOctahedralArray(std::ostream& os, uint32_t id, const Float3Stream& array,
+                                bool snorm8);
+  static void outputIntArray(std::ostream& os, uint32_t id, const std::vector<int>& array);
+
+  //Data Members
+  //welded vertex table, fVertexStride floats per vertex
+  //
+  std::vector<float>    fVertices;
+  unsigned int          fVertexStride;
+
+  //welded vertex index of each face-vertex
+  //
+  std::vector<uint32_t> fVertexIndices;
+
+  //in triangulated mode, the triangles as welded vertex indices and the
+  //face each one was cut from
+  //
+  std::vector<uint32_t> fTriangles;
+  std::vector<uint32_t> fTriangleFaces;
+
+  //with meshlets, the (first, count) range of meshlets of every entry of
+  //fSetTriangleRanges
+  //
+  std::vector<uint32_t> fSetMeshletRanges;
+
+  //quantize option: the box the positions are quantized in, and what the
+  //quantization did to every channel
+  //
+  float                 fPositionLow[3];
+  float                 fPositionHigh[3];
+  struct Quantization {
+    double  position, normal, tangent, binormal, uv;    //largest errors
+    size_t  floatBytes, quantizedBytes;
+  };
+  Quantization          fQuantization;
+};
@@ -0,0 +1,361 @@
+//
+//
+
+//MeshGenerator.cpp
+
+#include "MeshGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const char* const kShapeNames[kMeshShapeCount] = { "grid", "sphere", "ngon", "multiuv" };
+
+const double kPi = 3.14159265358979323846;
+
+
+void setVector(Float3Stream& stream, size_t i, double x, double y, double z)
+{
+  stream.x[i] = static_cast<float>(x);
+  stream.y[i] = static_cast<float>(y);
+  stream.z[i] = static_cast<float>(z);
+}
+
+
+CapturedUVSet& addUVSet(MeshCapture& capture, const char* name, size_t uvCount)
+//Summary:	appends a uv set with uvCount uvs and no uvs assigned yet
+{
+  capture.uvSets.push_back(CapturedUVSet());
+  CapturedUVSet& uvSet = capture.uvSets.back();
+  uvSet.name = name;
+  uvSet.u.resize(uvCount);
+  uvSet.v.resize(uvCount);
+  uvSet.faceUVIds.assign(capture.faceVertexIds.size(), -1);
+  return uvSet;
+}
+
+
+void triangulateFans(MeshCapture& capture)
+//Summary:	cuts every face into a fan of triangles around its first vertex,
+//			like Maya does for the convex faces generated here
+{
+  const size_t faceCount = capture.faceCount();
+  size_t triangleCount = 0;
+  size_t face;
+  for (face = 0; face < faceCount; face++) {
+    triangleCount += capture.faceVertexCounts[face] - 2;
+  }
+
+  capture.triangleCounts.resize(faceCount);
+  capture.triangleVertices.resize(3 * triangleCount);
+  int* corner = capture.triangleVertices.empty() ? NULL : &capture.triangleVertices[0];
+  int faceVertex = 0;
+  for (face = 0; face < faceCount; face++) {
+    const int count = capture.faceVertexCounts[face];
+    capture.triangleCounts[face] = count - 2;
+    int i;
+    for (i = 1; i + 1 < count; i++) {
+      *corner++ = faceVertex;
+      *corner++ = faceVertex + i;
+      *corner++ = faceVertex + i + 1;
+    }
+    faceVertex += count;
+  }
+}
+
+
+void addSets(MeshCapture& capture)
+//Summary:	splits the faces into two sets, the first half with a file
+//			texture, the second without
+{
+  const uint32_t faceCount = static_cast<uint32_t>(capture.faceCount());
+  const uint32_t half = faceCount / 2;
+
+  CapturedSet first;
+  first.name = "lambert2SG";
+  first.texture = "checker.png";
+  first.faceRanges.push_back(0);
+  first.faceRanges.push_back(half);
+
+  CapturedSet second;
+  second.name = "lambert3SG";
+  second.faceRanges.push_back(half);
+  second.faceRanges.push_back(faceCount - half);
+
+  capture.sets.push_back(first);
+  capture.sets.push_back(second);
+}
+
+
+void generateGrid(size_t faceCount, MeshCapture& capture)
+//Summary:	a unit square of nx by ny quads in the xz plane, facing +y, with
+//			the uvs of map1 shared like its vertices
+{
+  const size_t nx = std::max<size_t>(1, static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(faceCount)))));
+  const size_t ny = std::max<size_t>(1, (faceCount + nx - 1) / nx);
+  const size_t vertexCount = (nx + 1) * (ny + 1);
+
+  MeshSnapshot& snapshot = capture.snapshot;
+  snapshot.positions.resize(vertexCount);
+  snapshot.normals.resize(vertexCount);
+  size_t i, j;
+  for (j = 0; j <= ny; j++) {
+    for (i = 0; i <= nx; i++) {
+      const size_t vertex = j * (nx + 1) + i;
+      setVector(snapshot.positions, vertex, static_cast<double>(i) / nx - 0.5, 0.0,
+        static_cast<double>(j) / ny - 0.5);
+      setVector(snapshot.normals, vertex, 0.0, 1.0, 0.0);
+    }
+  }
+
+  capture.faceVertexCounts.assign(nx * ny, 4);
+  capture.faceVertexIds.resize(4 * nx * ny);
+  int* corner = &capture.faceVertexIds[0];
+  for (j = 0; j < ny; j++) {
+    for (i = 0; i < nx; i++) {
+      const int vertex = static_cast<int>(j * (nx + 1) + i);
+      const int above = vertex + static_cast<int>(nx + 1);
+      *corner++ = vertex;
+      *corner++ = above;
+      *corner++ = above + 1;
+      *corner++ = vertex + 1;
+    }
+  }
+  capture.faceNormalIds = capture.faceVertexIds;
+
+  CapturedUVSet& map1 = addUVSet(capture, "map1", vertexCount);
+  for (i = 0; i < vertexCount; i++) {
+    map1.u[i] = snapshot.positions.x[i] + 0.5f;
+    map1.v[i] = snapshot.positions.z[i] + 0.5f;
+  }
+  map1.faceUVIds = capture.faceVertexIds;
+}
+
+
+void generateSphere(size_t faceCount, MeshCapture& capture)
+//Summary:	a unit uv sphere of segments by rings faces: quads, and
+//			triangles around the poles.  Its uvs are a (segments + 1) by
+//			(rings + 1) grid with a seam where the segments wrap around.
+{
+  const size_t rings = std::max<size_t>(2, static_cast<size_t>(std::sqrt(faceCount / 2.0) + 0.5));
+  const size_t segments = std::max<size_t>(3, (faceCount + rings - 1) / rings);
+  const size_t vertexCount = 2 + (rings - 1) * segments;
+
+  //vertex 0 is the north pole, 1 the south pole, then ring after ring
+  //
+  MeshSnapshot& snapshot = capture.snapshot;
+  snapshot.positions.resize(vertexCount);
+  setVector(snapshot.positions, 0, 0.0, 1.0, 0.0);
+  setVector(snapshot.positions, 1, 0.0, -1.0, 0.0);
+  size_t r, s;
+  for (r = 1; r < rings; r++) {
+    const double theta = kPi * r / rings;
+    for (s = 0; s < segments; s++) {
+      const double phi = 2.0 * kPi * s / segments;
+      setVector(snapshot.positions, 2 + (r - 1) * segments + s,
+        std::sin(theta) * std::cos(phi), std::cos(theta), -std::sin(theta) * std::sin(phi));
+    }
+  }
+  snapshot.normals = snapshot.positions;
+
+  const size_t uvColumns = segments + 1;
+  CapturedUVSet map1;
+  map1.name = "map1";
+  map1.u.resize(uvColumns * (rings + 1));
+  map1.v.resize(uvColumns * (rings + 1));
+  for (r = 0; r <= rings; r++) {
+    for (s = 0; s <= segments; s++) {
+      map1.u[r * uvColumns + s] = static_cast<float>(s) / segments;
+      map1.v[r * uvColumns + s] = 1.0f - static_cast<float>(r) / rings;
+    }
+  }
+
+  const size_t quadCount = (rings - 2) * segments;
+  const size_t faceVertexCount = 4 * quadCount + 3 * 2 * segments;
+  capture.faceVertexCounts.reserve(rings * segments);
+  capture.faceVertexIds.reserve(faceVertexCount);
+  map1.faceUVIds.reserve(faceVertexCount);
+
+  for (r = 0; r < rings; r++) {
+    for (s = 0; s < segments; s++) {
+      const size_t next = (s + 1) % segments;
+      const int corners[4][2] = {
+        { 0 == r ? 0 : static_cast<int>(2 + (r - 1) * segments + s), static_cast<int>(r * uvColumns + s) },
+        { rings - 1 == r ? 1 : static_cast<int>(2 + r * segments + s), static_cast<int>((r + 1) * uvColumns + s) },
+        { rings - 1 == r ? 1 : static_cast<int>(2 + r * segments + next), static_cast<int>((r + 1) * uvColumns + s + 1) },
+        { 0 == r ? 0 : static_cast<int>(2 + (r - 1) * segments + next), static_cast<int>(r * uvColumns + s + 1) }
+      };
+
+      //the corners that collapse onto a pole are left out
+      //
+      int count = 0;
+      int i;
+      for (i = 0; i < 4; i++) {
+        if ((0 == r && 3 == i) || (rings - 1 == r && 2 == i)) {
+          continue;
+        }
+        capture.faceVertexIds.push_back(corners[i][0]);
+        map1.faceUVIds.push_back(corners[i][1]);
+        count++;
+      }
+      capture.faceVertexCounts.push_back(count);
+    }
+  }
+  capture.faceNormalIds = capture.faceVertexIds;
+  capture.uvSets.push_back(map1);
+}
+
+
+void generateNgons(size_t faceCount, MeshCapture& capture)
+//Summary:	faceCount separate regular polygons of 5 to 12 sides on a grid
+//			of cells in the xz plane, all facing +y with a single normal
+{
+  const size_t columns = std::max<size_t>(1, static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(faceCount)))));
+  const double cell = 1.0 / columns;
+
+  size_t vertexCount = 0;
+  size_t face;
+  capture.faceVertexCounts.resize(faceCount);
+  for (face = 0; face < faceCount; face++) {
+    capture.faceVertexCounts[face] = 5 + static_cast<int>(face % 8);
+    vertexCount += capture.faceVertexCounts[face];
+  }
+
+  MeshSnapshot& snapshot = capture.snapshot;
+  snapshot.positions.resize(vertexCount);
+  snapshot.normals.resize(1);
+  setVector(snapshot.normals, 0, 0.0, 1.0, 0.0);
+
+  size_t vertex = 0;
+  for (face = 0; face < faceCount; face++) {
+    const int sides = capture.faceVertexCounts[face];
+    const double centerX = ((face % columns) + 0.5) * cell - 0.5;
+    const double centerZ = ((face / columns) + 0.5) * cell - 0.5;
+    int i;
+    for (i = 0; i < sides; i++) {
+      const double angle = -2.0 * kPi * i / sides;
+      setVector(snapshot.positions, vertex++, centerX + 0.4 * cell * std::cos(angle), 0.0,
+        centerZ + 0.4 * cell * std::sin(angle));
+    }
+  }
+
+  //every polygon has vertices of its own, so the face-vertices are the
+  //vertices in order
+  //
+  capture.faceVertexIds.resize(vertexCount);
+  size_t i;
+  for (i = 0; i < vertexCount; i++) {
+    capture.faceVertexIds[i] = static_cast<int>(i);
+  }
+  capture.faceNormalIds.assign(vertexCount, 0);
+
+  CapturedUVSet& map1 = addUVSet(capture, "map1", vertexCount);
+  for (i = 0; i < vertexCount; i++) {
+    map1.u[i] = snapshot.positions.x[i] + 0.5f;
+    map1.v[i] = snapshot.positions.z[i] + 0.5f;
+  }
+  map1.faceUVIds = capture.faceVertexIds;
+}
+
+
+void addMultiUVSets(MeshCapture& capture)
+//Summary:	adds the lightmap, detail and decal uv sets to a grid
+{
+  const size_t vertexCount = capture.snapshot.positions.length();
+  const size_t faceCount = capture.faceCount();
+  const size_t faceVertexCount = capture.faceVertexIds.size();
+  const size_t columns = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(faceCount))));
+  const float chart = 1.0f / columns;
+
+  //a chart of its own for every face: no uv is shared
+  //
+  CapturedUVSet& lightmap = addUVSet(capture, "lightmap", faceVertexCount);
+  const float cornerU[4] = { 0.1f, 0.1f, 0.9f, 0.9f };
+  const float cornerV[4] = { 0.1f, 0.9f, 0.9f, 0.1f };
+  size_t face, i;
+  for (face = 0; face < faceCount; face++) {
+    for (i = 0; i < 4; i++) {
+      const size_t faceVertex = 4 * face + i;
+      lightmap.u[faceVertex] = ((face % columns) + cornerU[i]) * chart;
+      lightmap.v[faceVertex] = ((face / columns) + cornerV[i]) * chart;
+      lightmap.faceUVIds[faceVertex] = static_cast<int>(faceVertex);
+    }
+  }
+
+  CapturedUVSet& detail = addUVSet(capture, "detail", vertexCount);
+  const CapturedUVSet& map1 = capture.uvSets[0];
+  for (i = 0; i < vertexCount; i++) {
+    detail.u[i] = 8.0f * map1.u[i];
+    detail.v[i] = 8.0f * map1.v[i];
+  }
+  detail.faceUVIds = capture.faceVertexIds;
+
+  //the decal covers the first half of the faces; the others all share one
+  //uv off to the side, as the text format needs a uv on every face
+  //
+  CapturedUVSet& decal = addUVSet(capture, "decal", vertexCount + 1);
+  for (i = 0; i < vertexCount; i++) {
+    decal.u[i] = 2.0f * capture.uvSets[0].u[i];
+    decal.v[i] = 2.0f * capture.uvSets[0].v[i];
+  }
+  decal.u[vertexCount] = -1.0f;
+  decal.v[vertexCount] = -1.0f;
+  for (i = 0; i < faceVertexCount; i++) {
+    decal.faceUVIds[i] = i < faceVertexCount / 2 ? capture.faceVertexIds[i] : static_cast<int>(vertexCount);
+  }
+}
+
+}
+
+
+const char* meshShapeName(MeshShape shape)
+{
+  return kShapeNames[shape];
+}
+
+
+bool findMeshShape(const std::string& name, MeshShape& shape)
+//Summary:	looks up a shape by the name meshShapeName() gives it
+//Returns:	false if no shape has that name
+{
+  int i;
+  for (i = 0; i < kMeshShapeCount; i++) {
+    if (name == kShapeNames[i]) {
+      shape = static_cast<MeshShape>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+
+void generateMesh(MeshShape shape, size_t faceCount, MeshCapture& capture)
+//Summary:	builds a mesh of at least faceCount faces into capture
+//Args   :	shape - the kind of mesh, see MeshGenerator.h
+//			faceCount - the number of faces to aim for
+//			capture - reset to the mesh, named after its shape and size
+{
+  capture = MeshCapture();
+  capture.shape = std::string(meshShapeName(shape)) + "Shape" + std::to_string(faceCount);
+  capture.currentUVSetName = "map1";
+
+  switch (shape) {
+  case kSphereMesh:
+    generateSphere(faceCount, capture);
+    break;
+  case kNgonMesh:
+    generateNgons(faceCount, capture);
+    break;
+  case kMultiUVMesh:
+    generateGrid(faceCount, capture);
+    addMultiUVSets(capture);
+    break;
+  default:
+    generateGrid(faceCount, capture);
+    break;
+  }
+
+  triangulateFans(capture);
+  addSets(capture);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+// MeshGenerator.h
+
+//
+// *****************************************************************************
+//
+// Parametric meshes for xcBench, built straight into a MeshCapture so that
+// the writers can encode them like a mesh extracted in Maya.  Every mesh
+// has per vertex normals, a current uv set "map1", a triangulation and two
+// sets splitting its faces in halves, and comes out with at least the
+// number of faces asked for:
+//
+//   grid      a square plane of quads; the best case for the encoders
+//   sphere    a uv sphere of quads with triangle fans at the poles and a
+//             uv seam, like a default polySphere
+//   ngon      separate 5 to 12 sided polygons with one shared normal, so
+//             that most of the work is fan triangulation and welding
+//   multiuv   the grid with three more uv sets: a lightmap with a chart
+//             per face, a tiled detail set and a decal set that maps half
+//             of the faces and collapses the rest onto a single uv
+//
+// The meshes only depend on the face count, so the numbers of two runs,
+// or two releases, compare.
+//
+// *****************************************************************************
+
+#include "MeshCapture.h"
+
+#include <cstddef>
+#include <string>
+
+enum MeshShape {
+  kGridMesh = 0,
+  kSphereMesh,
+  kNgonMesh,
+  kMultiUVMesh,
+  kMeshShapeCount
+};
+
+const char* meshShapeName(MeshShape shape);
+bool        findMeshShape(const std::string& name, MeshShape& shape);
+void        generateMesh(MeshShape shape, size_t faceCount, MeshCapture& capture);
@@ -0,0 +1,68 @@
+//
+//
+
+//ReplayEncoder.cpp
+
+#include "ReplayEncoder.h"
+#include "xcWriterModel.h"
+#include "xcbWriterModel.h"
+#include "xcbFormat.h"
+#include "EncodePipeline.h"
+#include "ExportTrace.h"
+
+#include <chrono>
+#include <ostream>
+
+
+bool encodeCaptures(const std::vector<MeshCapture>& captures, const ExportOptions& options,
+                    bool binary, OutputSink& sink, ExportTrace* trace, ExportReport* report,
+                    double& seconds)
+//Summary:	encodes every capture into sink like an export of the meshes
+//			would, in the xcb format if binary is set, else in the text one
+//Args   :	trace, report - handed to every writer; may be NULL
+//			seconds - set to the time spent encoding and writing, without
+//			restoring the writers from the captures
+//Returns:	false if a writer failed or the sink could not be written
+{
+  std::vector<WriterModel*> writers(captures.size());
+  size_t i;
+  for (i = 0; i < captures.size(); i++) {
+    if (binary) {
+      writers[i] = new xcbWriterModel(captures[i], options);
+    }
+    else {
+      writers[i] = new xcWriterModel(captures[i], options);
+    }
+    writers[i]->setTrace(trace);
+    writers[i]->setReport(report);
+  }
+
+  const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+  SinkStreamBuf buffer(sink);
+  std::ostream os(&buffer);
+  bool succeeded = true;
+  {
+    TraceScope scope(trace, "encodeCaptures");
+    if (binary) {
+      xcb::writeFileHeader(os);
+    }
+
+    //the pipeline owns every writer it was handed
+    //
+    EncodePipeline pipeline(os, options.encodeThreads());
+    for (i = 0; i < writers.size() && succeeded; i++) {
+      succeeded = pipeline.submit(writers[i]);
+    }
+    for (; i < writers.size(); i++) {
+      delete writers[i];
+    }
+    succeeded = pipeline.finish() && succeeded;
+
+    if (binary) {
+      xcb::writeChunk(os, xcb::kEnd, 0, NULL, 0);
+    }
+    os.flush();
+  }
+  seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+  return succeeded && !os.fail();
+}
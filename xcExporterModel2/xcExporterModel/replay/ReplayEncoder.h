@@ -0,0 +1,46 @@
+#pragma once
+
+// ReplayEncoder.h
+
+//
+// *****************************************************************************
+//
+// Encoding of MeshCaptures the way an export encodes extracted meshes, for
+// the tools of this directory: xcReplay replays captures taken in Maya and
+// xcBench generated meshes.
+//
+// encodeCaptures() restores a writer from every capture, then times what an
+// export does after extraction: the file header, the EncodePipeline over
+// all writers and the footer.  DiscardOutputSink counts the encoded bytes
+// without keeping them, so that a run measures the encoders rather than
+// the disk.
+//
+// *****************************************************************************
+
+#include "OutputSink.h"
+#include "MeshCapture.h"
+#include "ExportOptions.h"
+
+#include <cstddef>
+#include <vector>
+
+class ExportTrace;
+class ExportReport;
+
+class DiscardOutputSink : public OutputSink {
+
+public:
+  DiscardOutputSink() : fBytesWritten(0) {}
+
+  bool    write(const char* /*data*/, size_t size) override { fBytesWritten += size; return true; }
+  bool    flush() override { return true; }
+  size_t  bytesWritten() const override { return fBytesWritten; }
+
+private:
+  size_t fBytesWritten;
+};
+
+
+bool encodeCaptures(const std::vector<MeshCapture>& captures, const ExportOptions& options,
+                    bool binary, OutputSink& sink, ExportTrace* trace, ExportReport* report,
+                    double& seconds);
@@ -0,0 +1,18 @@
+//
+//
+
+//WriterModelReplay.cpp
+
+//Stands in for WriterModelMaya.cpp in builds without Maya, where writers
+//are only ever created from a MeshCapture and there is no mesh to extract
+//from
+//
+
+#include "WriterModel.h"
+
+
+MStatus WriterModel::extractGeometry()
+//Returns:	MStatus::kFailure, always
+{
+	return MStatus::kFailure;
+}
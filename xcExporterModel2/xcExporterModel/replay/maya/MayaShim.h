@@ -0,0 +1,185 @@
+#pragma once
+
+// MayaShim.h
+
+//
+// *****************************************************************************
+//
+// The few Maya value types the encoder core names, for building xcReplay
+// without the Maya devkit.  The headers next to this one stand in for the
+// devkit headers of the same name and all include this file.
+//
+// Only what WriterModel.cpp, the writers and ShaderCache.h use is here, with
+// the behaviour of the real classes: MString, the arrays, MStatus and
+// MObject.  MDagPath and MFnMesh are only ever held by pointer outside of
+// WriterModelMaya.cpp and are empty.  MGlobal prints to stderr.
+//
+// *****************************************************************************
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using std::cin;
+using std::cout;
+using std::cerr;
+using std::endl;
+using std::flush;
+using std::ios;
+using std::istream;
+using std::ostream;
+
+
+namespace MS {
+enum MStatusCode {
+  kSuccess = 0,
+  kFailure,
+  kInsufficientMemory,
+  kInvalidParameter,
+  kLicenseFailure,
+  kUnknownParameter,
+  kNotImplemented,
+  kNotFound,
+  kEndOfFile
+};
+}
+
+class MStatus {
+
+public:
+  typedef MS::MStatusCode MStatusCode;
+  static constexpr MStatusCode kSuccess = MS::kSuccess;
+  static constexpr MStatusCode kFailure = MS::kFailure;
+  static constexpr MStatusCode kInvalidParameter = MS::kInvalidParameter;
+
+  MStatus() : fCode(MS::kSuccess) {}
+  MStatus(MStatusCode code) : fCode(code) {}
+
+  MStatusCode statusCode() const { return fCode; }
+  bool        error() const { return MS::kSuccess != fCode; }
+  operator bool() const { return MS::kSuccess == fCode; }
+
+  bool operator==(const MStatus& other) const { return fCode == other.fCode; }
+  bool operator==(MStatusCode code) const { return fCode == code; }
+  bool operator!=(const MStatus& other) const { return fCode != other.fCode; }
+  bool operator!=(MStatusCode code) const { return fCode != code; }
+
+private:
+  MStatusCode fCode;
+};
+
+inline bool operator==(MS::MStatusCode code, const MStatus& status) { return status == code; }
+inline bool operator!=(MS::MStatusCode code, const MStatus& status) { return status != code; }
+
+
+class MString {
+
+public:
+  MString() {}
+  MString(const char* str) : fString(NULL == str ? "" : str) {}
+
+  const char*   asChar() const { return fString.c_str(); }
+  unsigned int  length() const { return static_cast<unsigned int>(fString.size()); }
+  unsigned int  numChars() const { return length(); }
+
+  MString& operator+=(const MString& other) { fString += other.fString; return *this; }
+  MString& operator+=(const char* str) { fString += str; return *this; }
+  MString& operator+=(int value) { fString += std::to_string(value); return *this; }
+  MString& operator+=(unsigned int value) { fString += std::to_string(value); return *this; }
+  MString& operator+=(float value) { return *this += static_cast<double>(value); }
+  MString& operator+=(double value)
+  {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%g", value);
+    fString += text;
+    return *this;
+  }
+
+  MString operator+(const MString& other) const { MString result(*this); return result += other; }
+  MString operator+(const char* str) const { MString result(*this); return result += str; }
+
+  bool operator==(const MString& other) const { return fString == other.fString; }
+  bool operator==(const char* str) const { return fString == str; }
+  bool operator!=(const MString& other) const { return fString != other.fString; }
+  bool operator!=(const char* str) const { return fString != str; }
+
+private:
+  std::string fString;
+};
+
+inline MString operator+(const char* str, const MString& string) { return MString(str) + string; }
+inline std::ostream& operator<<(std::ostream& os, const MString& string) { return os << string.asChar(); }
+
+
+//the arrays of the devkit, with its unsigned int indexing
+//
+template <class T>
+class MShimArray {
+
+public:
+  MShimArray() {}
+  MShimArray(unsigned int count, const T& value = T()) : fValues(count, value) {}
+  MShimArray(const T* values, unsigned int count) : fValues(values, values + count) {}
+
+  unsigned int  length() const { return static_cast<unsigned int>(fValues.size()); }
+  MStatus       setLength(unsigned int count) { fValues.resize(count); return MS::kSuccess; }
+  MStatus       append(const T& value) { fValues.push_back(value); return MS::kSuccess; }
+  MStatus       clear() { fValues.clear(); return MS::kSuccess; }
+
+  const T&  operator[](unsigned int index) const { return fValues[index]; }
+  T&        operator[](unsigned int index) { return fValues[index]; }
+
+  MStatus get(T* values) const
+  {
+    size_t i;
+    for (i = 0; i < fValues.size(); i++) {
+      values[i] = fValues[i];
+    }
+    return MS::kSuccess;
+  }
+
+private:
+  std::vector<T> fValues;
+};
+
+typedef MShimArray<int>     MIntArray;
+typedef MShimArray<MString> MStringArray;
+
+
+class MObject {
+
+public:
+  bool  isNull() const { return true; }
+  bool  operator==(const MObject&) const { return true; }
+  bool  operator!=(const MObject&) const { return false; }
+};
+
+typedef MShimArray<MObject> MObjectArray;
+
+
+class MDagPath {};
+class MFnMesh {};
+
+
+class MGlobal {
+
+public:
+  static MStatus displayInfo(const MString& message)
+  {
+    std::cerr << message << std::endl;
+    return MS::kSuccess;
+  }
+
+  static MStatus displayWarning(const MString& message)
+  {
+    std::cerr << "Warning: " << message << std::endl;
+    return MS::kSuccess;
+  }
+
+  static MStatus displayError(const MString& message)
+  {
+    std::cerr << "Error: " << message << std::endl;
+    return MS::kSuccess;
+  }
+};
@@ -0,0 +1,396 @@
+//
+//
+
+//KernelLevelsTest.cpp
+
+//Checks what CpuDispatch.h, ExportKernels.h and TwistKernels.h promise:
+//
+//  - every ExportKernels and TwistKernels level the machine can run writes
+//    the same bytes as the SSE2 level, for every count from 0 up to a few
+//    vectors and for a long array, without writing past the count
+//  - XC_CPU_LEVEL lowers the chosen level, and is ignored if it names an
+//    unknown level or one above the detected level
+//  - the select functions install the kernels of the level they are given
+//
+//hashFloats is left out: it may differ per level, see ExportKernels.h.
+//
+
+#include "ExportKernels.h"
+#include "TwistKernels.h"
+#include "TestCheck.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+//bytes written after the output of a kernel, which must stay untouched
+//
+const size_t kGuardBytes = 64;
+const unsigned char kGuard = 0xA5;
+
+const size_t kLongCount = 1000;
+
+const ExportKernels* const kExportLevels[] = {
+  &kExportKernelsSSE2, &kExportKernelsAVX2, &kExportKernelsAVX512
+};
+const TwistKernels* const kTwistLevels[] = {
+  &kTwistKernelsSSE2, &kTwistKernelsAVX2, &kTwistKernelsAVX512
+};
+
+
+struct Inputs {
+  //float inputs with the values that take special paths: zeros of both
+  //signs, denormals, values that round to half float limits, infinities
+  //and NaNs, among random ones
+  //
+  std::vector<float>  floats;
+  //unit vectors, the axes among them, as separate x, y and z arrays
+  //
+  std::vector<float>  unitX, unitY, unitZ;
+  //(x, y, z, 1) double points
+  //
+  std::vector<double> points;
+};
+
+
+Inputs makeInputs(size_t count)
+{
+  Inputs inputs;
+  std::mt19937 random(1234);
+  std::uniform_real_distribution<float> distribution(-100.0f, 100.0f);
+  std::normal_distribution<float> normal(0.0f, 1.0f);
+
+  const float specials[] = {
+    0.0f, -0.0f, 1.0e-40f, -1.0e-40f, 65504.0f, 65520.0f, -65520.0f, 6.1e-5f, 5.96e-8f,
+    2.98e-8f, std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(),
+    std::numeric_limits<float>::quiet_NaN(), 1.0e30f, 0.5f, 1.00048828125f
+  };
+  const size_t specialCount = sizeof(specials) / sizeof(specials[0]);
+
+  inputs.floats.resize(3 * count);
+  inputs.unitX.resize(count);
+  inputs.unitY.resize(count);
+  inputs.unitZ.resize(count);
+  inputs.points.resize(4 * count);
+
+  size_t i;
+  for (i = 0; i < inputs.floats.size(); i++) {
+    inputs.floats[i] = 0 == i % 5 ? specials[(i / 5) % specialCount] : distribution(random);
+  }
+  for (i = 0; i < count; i++) {
+    float x = normal(random);
+    float y = normal(random);
+    float z = normal(random);
+    switch (i % 9) {
+    case 0: x = 1.0f; y = 0.0f; z = 0.0f; break;
+    case 3: x = 0.0f; y = -1.0f; z = 0.0f; break;
+    case 6: x = 0.0f; y = 0.0f; z = -1.0f; break;
+    default: break;
+    }
+    const float length = std::sqrt(x * x + y * y + z * z);
+    inputs.unitX[i] = x / length;
+    inputs.unitY[i] = y / length;
+    inputs.unitZ[i] = z / length;
+
+    inputs.points[4 * i] = 10.0 * distribution(random);
+    inputs.points[4 * i + 1] = distribution(random) / 3.0;
+    inputs.points[4 * i + 2] = distribution(random) * 1.0e-3;
+    inputs.points[4 * i + 3] = 1.0;
+  }
+  return inputs;
+}
+
+
+class Output {
+  //the output buffer of a kernel, followed by kGuardBytes guard bytes
+
+public:
+  Output(size_t bytes) : fBytes(bytes), fData(bytes + kGuardBytes, kGuard) {}
+
+  template <typename T>
+  T*    as() { return reinterpret_cast<T*>(&fData[0]); }
+
+  bool  guardKept() const
+  {
+    size_t i;
+    for (i = fBytes; i < fData.size(); i++) {
+      if (kGuard != fData[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool  operator==(const Output& other) const { return fData == other.fData; }
+
+private:
+  size_t                      fBytes;
+  std::vector<unsigned char>  fData;
+};
+
+
+template <typename Run>
+void compareExportLevels(const char* name, const Inputs& inputs, CpuLevel machine, Run run)
+//Summary:	runs a kernel with every level for every count up to a few
+//			vectors and for kLongCount elements, and compares the output
+//			with the SSE2 one
+//Args   :	run - runs the kernel of the given level on the first count
+//			elements of inputs and returns its output
+{
+  std::vector<size_t> counts;
+  size_t count;
+  for (count = 0; count <= 40; count++) {
+    counts.push_back(count);
+  }
+  counts.push_back(kLongCount);
+
+  bool same = true;
+  bool guarded = true;
+  size_t c;
+  for (c = 0; c < counts.size(); c++) {
+    count = counts[c];
+    const Output expected = run(*kExportLevels[kCpuSSE2], inputs, count);
+    guarded = guarded && expected.guardKept();
+    int level;
+    for (level = kCpuAVX2; level <= machine; level++) {
+      const Output output = run(*kExportLevels[level], inputs, count);
+      if (!(output == expected)) {
+        std::fprintf(stderr, "%s: %s differs from sse2 for %zu elements\n", name,
+          cpuLevelName(static_cast<CpuLevel>(level)), count);
+        same = false;
+      }
+    }
+  }
+  CHECK(same);
+  CHECK(guarded);
+}
+
+
+void checkExportKernels(CpuLevel machine)
+{
+  const Inputs inputs = makeInputs(kLongCount);
+  const float* floats = &inputs.floats[0];
+  const float* x = &inputs.unitX[0];
+  const float* y = &inputs.unitY[0];
+  const float* z = &inputs.unitZ[0];
+
+  compareExportLevels("pointsToFloats", inputs, machine,
+    [](const ExportKernels& kernels, const Inputs& in, size_t count) {
+      Output output(3 * count * sizeof(float));
+      float* out = output.as<float>();
+      kernels.pointsToFloats(&in.points[0], out, out + count, out + 2 * count, count);
+      return output;
+    });
+
+  compareExportLevels("splitFloat3", inputs, machine,
+    [floats](const ExportKernels& kernels, const Inputs&, size_t count) {
+      Output output(3 * count * sizeof(float));
+      float* out = output.as<float>();
+      kernels.splitFloat3(floats, out, out + count, out + 2 * count, count);
+      return output;
+    });
+
+  compareExportLevels("mergeFloat3", inputs, machine,
+    [floats](const ExportKernels& kernels, const Inputs&, size_t count) {
+      Output output(3 * count * sizeof(float));
+      kernels.mergeFloat3(floats, floats + count, floats + 2 * count, output.as<float>(), count);
+      return output;
+    });
+
+  compareExportLevels("interleaveUVs", inputs, machine,
+    [floats](const ExportKernels& kernels, const Inputs&, size_t count) {
+      Output output(2 * count * sizeof(float));
+      kernels.interleaveUVs(floats, floats + count, output.as<float>(), count);
+      return output;
+    });
+
+  compareExportLevels("quantizePositions", inputs, machine,
+    [floats](const ExportKernels& kernels, const Inputs&, size_t count) {
+      const float low[3] = { -80.0f, -100.0f, -50.0f };
+      const float scale[3] = { 65535.0f / 160.0f, 65535.0f / 200.0f, 65535.0f / 100.0f };
+      Output output(4 * count * sizeof(uint16_t));
+      kernels.quantizePositions(floats, floats + count, floats + 2 * count, count, low, scale,
+        output.as<uint16_t>());
+      return output;
+    });
+
+  compareExportLevels("octahedralSnorm16", inputs, machine,
+    [x, y, z](const ExportKernels& kernels, const Inputs&, size_t count) {
+      Output output(2 * count * sizeof(int16_t));
+      kernels.octahedralSnorm16(x, y, z, count, output.as<int16_t>());
+      return output;
+    });
+
+  compareExportLevels("octahedralSnorm8", inputs, machine,
+    [x, y, z](const ExportKernels& kernels, const Inputs&, size_t count) {
+      Output output(2 * count * sizeof(int8_t));
+      kernels.octahedralSnorm8(x, y, z, count, output.as<int8_t>());
+      return output;
+    });
+
+  compareExportLevels("floatsToHalves", inputs, machine,
+    [floats](const ExportKernels& kernels, const Inputs&, size_t count) {
+      Output output(3 * count * sizeof(uint16_t));
+      kernels.floatsToHalves(floats, output.as<uint16_t>(), 3 * count);
+      return output;
+    });
+
+  compareExportLevels("transformPoints", inputs, machine,
+    [](const ExportKernels& kernels, const Inputs& in, size_t count) {
+      const double matrix[16] = {
+        0.8, 0.6, 0.0, 0.0,
+        -0.6, 0.8, 0.0, 0.0,
+        0.0, 0.0, 2.5, 0.0,
+        12.25, -3.5, 0.125, 1.0
+      };
+      Output output(3 * count * sizeof(float));
+      float* out = output.as<float>();
+      kernels.transformPoints(&in.points[0], matrix, out, out + count, out + 2 * count, count);
+      return output;
+    });
+
+  compareExportLevels("transformVectors", inputs, machine,
+    [floats](const ExportKernels& kernels, const Inputs&, size_t count) {
+      const float matrix[9] = {
+        0.8f, 0.6f, 0.0f,
+        -0.6f, 0.8f, 0.0f,
+        0.0f, 0.0f, 0.4f
+      };
+      //transformed in place, on a copy that holds zero vectors as well
+      //
+      Output output(3 * count * sizeof(float));
+      float* out = output.as<float>();
+      std::memcpy(out, floats, 3 * count * sizeof(float));
+      size_t i;
+      for (i = 0; i < count; i += 7) {
+        out[i] = out[count + i] = out[2 * count + i] = 0.0f;
+      }
+      kernels.transformVectors(out, out + count, out + 2 * count, count, matrix);
+      return output;
+    });
+}
+
+
+void checkTwistKernels(CpuLevel machine)
+//Summary:	compares sinCosFast and twistBlock, in both modes, of every level
+//			with the SSE2 ones
+{
+  const int count = 4 * kTwistBlockSize + 3;
+  std::vector<double> angles(count);
+  std::vector<double> points(4 * count);
+  std::mt19937_64 random(99);
+  std::uniform_real_distribution<double> distribution(-20.0, 20.0);
+  int i;
+  for (i = 0; i < count; i++) {
+    angles[i] = i % 11 ? distribution(random) * 1.0e4 : 0.0;
+    points[4 * i] = distribution(random);
+    points[4 * i + 1] = i % 13 ? distribution(random) : 0.0;
+    points[4 * i + 2] = distribution(random);
+    points[4 * i + 3] = 1.0;
+  }
+
+  std::vector<double> expectedSines(count), expectedCosines(count);
+  kTwistKernelsSSE2.sinCosFast(&angles[0], &expectedSines[0], &expectedCosines[0], count);
+
+  int level;
+  for (level = kCpuAVX2; level <= machine; level++) {
+    const TwistKernels& kernels = *kTwistLevels[level];
+    std::vector<double> sines(count), cosines(count);
+    kernels.sinCosFast(&angles[0], &sines[0], &cosines[0], count);
+    CHECK(0 == std::memcmp(&sines[0], &expectedSines[0], count * sizeof(double)));
+    CHECK(0 == std::memcmp(&cosines[0], &expectedCosines[0], count * sizeof(double)));
+
+    int fast;
+    for (fast = 0; fast < 2; fast++) {
+      std::vector<double> expected = points;
+      std::vector<double> twisted = points;
+      int first;
+      for (first = 0; first < count; first += kTwistBlockSize) {
+        const int size = count - first < kTwistBlockSize ? count - first : kTwistBlockSize;
+        kTwistKernelsSSE2.twistBlock(&expected[4 * first], size, 0.35, 0.75, 0 != fast);
+        kernels.twistBlock(&twisted[4 * first], size, 0.35, 0.75, 0 != fast);
+      }
+      CHECK(0 == std::memcmp(&twisted[0], &expected[0], twisted.size() * sizeof(double)));
+    }
+  }
+}
+
+
+void setLevelVariable(const char* value)
+//Summary:	sets XC_CPU_LEVEL, or removes it if value is NULL
+{
+#if defined(_MSC_VER)
+  _putenv_s("XC_CPU_LEVEL", NULL == value ? "" : value);
+#else
+  if (NULL == value) {
+    unsetenv("XC_CPU_LEVEL");
+  }
+  else {
+    setenv("XC_CPU_LEVEL", value, 1);
+  }
+#endif
+}
+
+
+void checkForcedLevel(CpuLevel machine)
+{
+  bool forced = true;
+  setLevelVariable(NULL);
+  CHECK(machine == chooseCpuLevel(forced));
+  CHECK(!forced);
+
+  int level;
+  for (level = kCpuSSE2; level <= kCpuAVX512; level++) {
+    const CpuLevel requested = static_cast<CpuLevel>(level);
+    setLevelVariable(cpuLevelName(requested));
+    const CpuLevel chosen = chooseCpuLevel(forced);
+    CHECK(chosen == (requested < machine ? requested : machine));
+    CHECK(forced == (requested < machine));
+  }
+
+  setLevelVariable("avx1024");
+  CHECK(machine == chooseCpuLevel(forced));
+  CHECK(!forced);
+
+  setLevelVariable(NULL);
+}
+
+
+void checkSelection()
+{
+  int level;
+  for (level = kCpuSSE2; level <= kCpuAVX512; level++) {
+    selectExportKernels(static_cast<CpuLevel>(level));
+    selectTwistKernels(static_cast<CpuLevel>(level));
+    CHECK(&exportKernels() == kExportLevels[level]);
+    CHECK(&twistKernels() == kTwistLevels[level]);
+  }
+  selectExportKernels(kCpuSSE2);
+  selectTwistKernels(kCpuSSE2);
+}
+
+}
+
+
+int main()
+{
+  const CpuLevel machine = detectCpuLevel();
+  std::printf("detected level: %s\n", cpuLevelName(machine));
+  if (machine < kCpuAVX512) {
+    std::printf("levels above %s are not supported by this machine and not compared\n",
+      cpuLevelName(machine));
+  }
+
+  checkExportKernels(machine);
+  checkTwistKernels(machine);
+  checkForcedLevel(machine);
+  checkSelection();
+  return test::testResult();
+}
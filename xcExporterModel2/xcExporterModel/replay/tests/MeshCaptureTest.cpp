@@ -0,0 +1,95 @@
+//
+//
+
+//MeshCaptureTest.cpp
+
+//Checks that readCaptureFile(), see MeshCapture.h, gives back a generated
+//grid and rejects set face ranges the writers could not index safely:
+//
+//  - a range starting past the last face
+//  - a range running past the last face
+//  - a range whose start + count wraps around in 32 bits
+//  - an odd number of range values
+//
+
+#include "MeshCapture.h"
+#include "MeshGenerator.h"
+#include "TestCheck.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* const kCaptureFile = "MeshCaptureTest.xcap";
+
+
+bool roundTrip(const MeshCapture& capture, std::vector<MeshCapture>& captures, std::string& error)
+//Summary:	writes capture to a file and reads it back
+{
+  CaptureWriter writer;
+  if (!writer.open(kCaptureFile)) {
+    error = "cannot write the capture file";
+    return false;
+  }
+  writer.write(capture);
+  if (!writer.close()) {
+    error = "cannot write the capture file";
+    return false;
+  }
+  return readCaptureFile(kCaptureFile, captures, error);
+}
+
+
+void checkRejected(const MeshCapture& grid, const uint32_t* ranges, size_t count)
+{
+  MeshCapture capture = grid;
+  capture.sets[0].faceRanges.assign(ranges, ranges + count);
+  std::vector<MeshCapture> captures;
+  std::string error;
+  const bool read = roundTrip(capture, captures, error);
+  std::printf("ranges of %zu values: %s\n", count, read ? "accepted" : error.c_str());
+  CHECK(!read);
+}
+
+}
+
+
+int main()
+{
+  MeshCapture grid;
+  generateMesh(kGridMesh, 100, grid);
+  const uint32_t faceCount = static_cast<uint32_t>(grid.faceCount());
+  CHECK(!grid.sets.empty());
+  if (grid.sets.empty()) {
+    return test::testResult();
+  }
+
+  std::vector<MeshCapture> captures;
+  std::string error;
+  CHECK(roundTrip(grid, captures, error));
+  CHECK(1 == captures.size() && captures[0].faceCount() == faceCount &&
+    captures[0].sets.size() == grid.sets.size() &&
+    captures[0].sets[0].faceRanges == grid.sets[0].faceRanges);
+
+  //a set covering every face, and an empty range at the end, are fine
+  //
+  MeshCapture whole = grid;
+  const uint32_t all[] = { 0, faceCount, faceCount, 0 };
+  whole.sets[0].faceRanges.assign(all, all + 4);
+  CHECK(roundTrip(whole, captures, error));
+
+  const uint32_t pastEnd[] = { faceCount + 1, 0 };
+  checkRejected(grid, pastEnd, 2);
+  const uint32_t overrun[] = { 0, 5, faceCount - 3, 4 };
+  checkRejected(grid, overrun, 4);
+  const uint32_t wraps[] = { 10, 0xFFFFFFFFu - 5 };
+  checkRejected(grid, wraps, 2);
+  const uint32_t odd[] = { 0, 5, 7 };
+  checkRejected(grid, odd, 3);
+
+  std::remove(kCaptureFile);
+  return test::testResult();
+}
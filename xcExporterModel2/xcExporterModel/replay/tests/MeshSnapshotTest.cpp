@@ -0,0 +1,149 @@
+//
+//
+
+//MeshSnapshotTest.cpp
+
+//Checks the structure-of-arrays conversions of MeshSnapshot.h with the
+//kernels of every level the machine can run, for every count from 0 to
+//kMaxCount:
+//
+//  - Float3Stream::deinterleave() followed by interleave() gives back the
+//    (x, y, z) triples bit for bit, NaN payloads and negative zeros
+//    included
+//  - deinterleave() puts every component where a scalar loop would
+//  - pointsToFloats() rounds every component of (x, y, z, w) points to
+//    float like a static_cast, and ignores w
+//  - the streams start on a 64 byte boundary
+//
+
+#include "MeshSnapshot.h"
+#include "ExportKernels.h"
+#include "TestCheck.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+const size_t kMaxCount = 300;
+
+
+float floatFromBits(uint32_t bits)
+{
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+
+std::vector<float> makeTriples(size_t count)
+//Returns:	count (x, y, z) triples of random floats, with a negative zero
+//			and NaNs with payloads among them
+{
+  std::mt19937 random(static_cast<unsigned int>(count));
+  std::uniform_real_distribution<float> distribution(-1000.0f, 1000.0f);
+  std::vector<float> xyz(3 * count);
+  size_t i;
+  for (i = 0; i < xyz.size(); i++) {
+    switch (i % 17) {
+    case 4: xyz[i] = -0.0f; break;
+    case 9: xyz[i] = floatFromBits(0x7FC01234u + static_cast<uint32_t>(i)); break;
+    case 13: xyz[i] = floatFromBits(0x00000001u); break;
+    default: xyz[i] = distribution(random); break;
+    }
+  }
+  return xyz;
+}
+
+
+bool aligned(const FloatStream& stream)
+{
+  return stream.empty() ||
+    0 == reinterpret_cast<uintptr_t>(&stream[0]) % AlignedAllocator<float>::kAlignment;
+}
+
+
+bool sameBits(float a, float b)
+{
+  return 0 == std::memcmp(&a, &b, sizeof(float));
+}
+
+
+void checkRoundTrip(size_t count)
+{
+  const std::vector<float> xyz = makeTriples(count);
+
+  Float3Stream stream;
+  stream.deinterleave(xyz);
+  bool split = stream.length() == count;
+  size_t i;
+  for (i = 0; split && i < count; i++) {
+    split = sameBits(stream.x[i], xyz[3 * i]) && sameBits(stream.y[i], xyz[3 * i + 1]) &&
+      sameBits(stream.z[i], xyz[3 * i + 2]);
+  }
+  if (!split) {
+    std::fprintf(stderr, "deinterleave is wrong for %zu vectors\n", count);
+  }
+  CHECK(split);
+  CHECK(aligned(stream.x) && aligned(stream.y) && aligned(stream.z));
+
+  std::vector<float> back(7, 1.0f);
+  stream.interleave(back);
+  const bool same = back.size() == xyz.size() &&
+    (xyz.empty() || 0 == std::memcmp(&back[0], &xyz[0], xyz.size() * sizeof(float)));
+  if (!same) {
+    std::fprintf(stderr, "interleave does not round-trip %zu vectors\n", count);
+  }
+  CHECK(same);
+}
+
+
+void checkPointsToFloats(size_t count)
+{
+  std::mt19937_64 random(count);
+  std::uniform_real_distribution<double> distribution(-1.0e6, 1.0e6);
+  std::vector<double> points(4 * count);
+  size_t i;
+  for (i = 0; i < points.size(); i++) {
+    points[i] = 3 == i % 4 ? distribution(random) : distribution(random) / 7.0;
+  }
+
+  Float3Stream stream;
+  stream.resize(count);
+  if (0 != count) {
+    exportKernels().pointsToFloats(&points[0], &stream.x[0], &stream.y[0], &stream.z[0], count);
+  }
+
+  bool same = true;
+  for (i = 0; same && i < count; i++) {
+    same = sameBits(stream.x[i], static_cast<float>(points[4 * i])) &&
+      sameBits(stream.y[i], static_cast<float>(points[4 * i + 1])) &&
+      sameBits(stream.z[i], static_cast<float>(points[4 * i + 2]));
+  }
+  if (!same) {
+    std::fprintf(stderr, "pointsToFloats is wrong for %zu points\n", count);
+  }
+  CHECK(same);
+}
+
+}
+
+
+int main()
+{
+  const CpuLevel machine = detectCpuLevel();
+  int level;
+  for (level = kCpuSSE2; level <= machine; level++) {
+    selectExportKernels(static_cast<CpuLevel>(level));
+    std::printf("%s: 0 to %zu vectors\n", cpuLevelName(static_cast<CpuLevel>(level)), kMaxCount);
+    size_t count;
+    for (count = 0; count <= kMaxCount; count++) {
+      checkRoundTrip(count);
+      checkPointsToFloats(count);
+    }
+  }
+  return test::testResult();
+}
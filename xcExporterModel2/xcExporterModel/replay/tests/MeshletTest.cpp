@@ -0,0 +1,311 @@
+//
+//
+
+//MeshletTest.cpp
+
+//Checks buildMeshlets(), see MeshletBuilder.h, on a curved grid, a flat
+//grid with set breaks and a wide vertex stride, a fan, a triangle soup with
+//degenerate triangles and an empty list:
+//
+//  - every meshlet has 1 to kMaxMeshletVertices vertices and 1 to
+//    kMaxMeshletTriangles triangles, and its vertices are distinct
+//  - the meshlets cover the vertex and triangle arrays back to back and
+//    give back the triangle list in its order
+//  - a meshlet is only closed when the next triangle does not fit, or at a
+//    break, and no meshlet spans a break
+//  - the bounding sphere holds every vertex of its meshlet
+//  - the normal cone is conservative: for camera positions all around the
+//    meshlet, the cone test only culls if every triangle faces away
+//
+
+#include "MeshletBuilder.h"
+#include "TestCheck.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace {
+
+struct Mesh {
+  const char*           name;
+  std::vector<float>    vertices;
+  unsigned int          stride;
+  std::vector<uint32_t> triangles;
+  std::vector<uint32_t> breaks;
+
+  size_t vertexCount() const { return vertices.size() / stride; }
+  size_t triangleCount() const { return triangles.size() / 3; }
+  const float* position(uint32_t vertex) const { return &vertices[vertex * stride]; }
+};
+
+
+Mesh makeGrid(const char* name, uint32_t size, unsigned int stride, bool curved)
+//Returns:	a size x size grid of quads, two triangles each, in row order;
+//			curved grids are bent into waves
+{
+  Mesh mesh;
+  mesh.name = name;
+  mesh.stride = stride;
+  mesh.vertices.assign((size + 1) * (size + 1) * stride, 0.5f);
+  uint32_t x, y;
+  for (y = 0; y <= size; y++) {
+    for (x = 0; x <= size; x++) {
+      float* p = &mesh.vertices[(y * (size + 1) + x) * stride];
+      p[0] = static_cast<float>(x);
+      p[1] = static_cast<float>(y);
+      p[2] = curved ? 1.5f * std::sin(0.4f * x) * std::cos(0.3f * y) : 0.0f;
+    }
+  }
+  for (y = 0; y < size; y++) {
+    for (x = 0; x < size; x++) {
+      const uint32_t a = y * (size + 1) + x;
+      const uint32_t triangles[6] = { a, a + 1, a + size + 2, a, a + size + 2, a + size + 1 };
+      mesh.triangles.insert(mesh.triangles.end(), triangles, triangles + 6);
+    }
+  }
+  return mesh;
+}
+
+
+Mesh makeFan(uint32_t triangleCount)
+//Returns:	a fan around vertex 0, whose every triangle brings one new
+//			vertex, so meshlets fill up on vertices first
+{
+  Mesh mesh;
+  mesh.name = "fan";
+  mesh.stride = 3;
+  mesh.vertices.push_back(0.0f);
+  mesh.vertices.push_back(0.0f);
+  mesh.vertices.push_back(1.0f);
+  uint32_t i;
+  for (i = 0; i <= triangleCount; i++) {
+    const float angle = 0.03f * i;
+    mesh.vertices.push_back(std::cos(angle));
+    mesh.vertices.push_back(std::sin(angle));
+    mesh.vertices.push_back(0.0f);
+  }
+  for (i = 0; i < triangleCount; i++) {
+    mesh.triangles.push_back(0);
+    mesh.triangles.push_back(1 + i);
+    mesh.triangles.push_back(2 + i);
+  }
+  return mesh;
+}
+
+
+Mesh makeSoup(uint32_t triangleCount)
+//Returns:	triangles of three vertices of their own each, every fifth one
+//			degenerate with a repeated vertex, at random positions
+{
+  Mesh mesh;
+  mesh.name = "soup";
+  mesh.stride = 3;
+  std::mt19937 random(5);
+  std::uniform_real_distribution<float> distribution(-50.0f, 50.0f);
+  uint32_t i;
+  for (i = 0; i < 3 * triangleCount; i++) {
+    mesh.vertices.push_back(distribution(random));
+    mesh.vertices.push_back(distribution(random));
+    mesh.vertices.push_back(distribution(random));
+  }
+  for (i = 0; i < triangleCount; i++) {
+    mesh.triangles.push_back(3 * i);
+    mesh.triangles.push_back(0 == i % 5 ? 3 * i : 3 * i + 1);
+    mesh.triangles.push_back(3 * i + 2);
+  }
+  return mesh;
+}
+
+
+unsigned int newVertices(const Mesh& mesh, size_t triangle, const std::set<uint32_t>& present)
+//Returns:	the vertices triangle would add to a meshlet holding present
+{
+  std::set<uint32_t> added;
+  int corner;
+  for (corner = 0; corner < 3; corner++) {
+    const uint32_t vertex = mesh.triangles[3 * triangle + corner];
+    if (0 == present.count(vertex)) {
+      added.insert(vertex);
+    }
+  }
+  return static_cast<unsigned int>(added.size());
+}
+
+
+void cross(const float* a, const float* b, const float* c, double normal[3])
+{
+  const double u[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+  const double v[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+  normal[0] = u[1] * v[2] - u[2] * v[1];
+  normal[1] = u[2] * v[0] - u[0] * v[2];
+  normal[2] = u[0] * v[1] - u[1] * v[0];
+}
+
+
+bool coneIsConservative(const Mesh& mesh, const Meshlets& result, const xcb::Meshlet& meshlet,
+  std::mt19937& random, int& culled)
+//Summary:	tries camera positions on spheres around the meshlet and checks
+//			that all triangles face away whenever the cone test culls
+{
+  if (meshlet.coneCutoff >= 1.0f) {
+    return true;
+  }
+  std::normal_distribution<double> normal(0.0, 1.0);
+  int sample;
+  for (sample = 0; sample < 200; sample++) {
+    double direction[3] = { normal(random), normal(random), normal(random) };
+    const double length = std::sqrt(direction[0] * direction[0] + direction[1] * direction[1] +
+      direction[2] * direction[2]);
+    const double distance = meshlet.radius * (1.5 + 0.25 * (sample % 40));
+    double eye[3];
+    int k;
+    for (k = 0; k < 3; k++) {
+      eye[k] = meshlet.center[k] + direction[k] / length * distance;
+    }
+
+    double view[3];
+    double viewLength = 0.0;
+    for (k = 0; k < 3; k++) {
+      view[k] = meshlet.coneApex[k] - eye[k];
+      viewLength += view[k] * view[k];
+    }
+    viewLength = std::sqrt(viewLength);
+    const double d = (view[0] * meshlet.coneAxis[0] + view[1] * meshlet.coneAxis[1] +
+      view[2] * meshlet.coneAxis[2]) / viewLength;
+    if (d < meshlet.coneCutoff) {
+      continue;
+    }
+    culled++;
+
+    uint32_t t;
+    for (t = 0; t < meshlet.triangleCount; t++) {
+      const uint8_t* local = &result.triangles[3 * (meshlet.triangleOffset + t)];
+      const float* a = mesh.position(result.vertices[meshlet.vertexOffset + local[0]]);
+      const float* b = mesh.position(result.vertices[meshlet.vertexOffset + local[1]]);
+      const float* c = mesh.position(result.vertices[meshlet.vertexOffset + local[2]]);
+      double n[3];
+      cross(a, b, c, n);
+      const double facing = (eye[0] - a[0]) * n[0] + (eye[1] - a[1]) * n[1] + (eye[2] - a[2]) * n[2];
+      const double scale = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]) * distance;
+      if (facing > 1.0e-4 * scale) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+
+void checkMesh(const Mesh& mesh)
+{
+  Meshlets result;
+  buildMeshlets(mesh.triangles.empty() ? NULL : &mesh.triangles[0], mesh.triangleCount(),
+    mesh.vertices.empty() ? NULL : &mesh.vertices[0], mesh.stride, mesh.vertexCount(),
+    mesh.breaks.empty() ? NULL : &mesh.breaks[0], mesh.breaks.size(), result);
+  std::printf("%s: %zu triangles in %zu meshlets\n", mesh.name, mesh.triangleCount(),
+    result.meshlets.size());
+
+  bool limits = true;
+  bool distinct = true;
+  bool contiguous = true;
+  bool sameTriangles = true;
+  bool greedy = true;
+  bool spansBreak = false;
+  bool bounded = true;
+  bool conservative = true;
+  int culled = 0;
+  std::mt19937 random(11);
+  std::set<uint32_t> breaks(mesh.breaks.begin(), mesh.breaks.end());
+
+  size_t vertexOffset = 0;
+  size_t triangleOffset = 0;
+  size_t m;
+  for (m = 0; m < result.meshlets.size(); m++) {
+    const xcb::Meshlet& meshlet = result.meshlets[m];
+    limits = limits && meshlet.vertexCount >= 1 &&
+      meshlet.vertexCount <= xcb::kMaxMeshletVertices && meshlet.triangleCount >= 1 &&
+      meshlet.triangleCount <= xcb::kMaxMeshletTriangles;
+    contiguous = contiguous && meshlet.vertexOffset == vertexOffset &&
+      meshlet.triangleOffset == triangleOffset;
+    vertexOffset += meshlet.vertexCount;
+    triangleOffset += meshlet.triangleCount;
+    if (vertexOffset > result.vertices.size() || 3 * triangleOffset > result.triangles.size()) {
+      contiguous = false;
+      break;
+    }
+
+    const std::set<uint32_t> present(result.vertices.begin() + meshlet.vertexOffset,
+      result.vertices.begin() + vertexOffset);
+    distinct = distinct && present.size() == meshlet.vertexCount;
+
+    uint32_t t;
+    for (t = 0; t < meshlet.triangleCount; t++) {
+      const size_t triangle = meshlet.triangleOffset + t;
+      int corner;
+      for (corner = 0; corner < 3; corner++) {
+        const uint8_t local = result.triangles[3 * triangle + corner];
+        sameTriangles = sameTriangles && local < meshlet.vertexCount &&
+          result.vertices[meshlet.vertexOffset + local] == mesh.triangles[3 * triangle + corner];
+      }
+      spansBreak = spansBreak || (0 != t && 0 != breaks.count(static_cast<uint32_t>(triangle)));
+    }
+
+    if (triangleOffset < mesh.triangleCount() &&
+        0 == breaks.count(static_cast<uint32_t>(triangleOffset))) {
+      greedy = greedy && (meshlet.triangleCount == xcb::kMaxMeshletTriangles ||
+        meshlet.vertexCount + newVertices(mesh, triangleOffset, present) >
+        xcb::kMaxMeshletVertices);
+    }
+
+    std::set<uint32_t>::const_iterator vertex;
+    for (vertex = present.begin(); vertex != present.end(); ++vertex) {
+      const float* p = mesh.position(*vertex);
+      const double dx = p[0] - meshlet.center[0];
+      const double dy = p[1] - meshlet.center[1];
+      const double dz = p[2] - meshlet.center[2];
+      bounded = bounded &&
+        std::sqrt(dx * dx + dy * dy + dz * dz) <= meshlet.radius * (1.0 + 1.0e-5) + 1.0e-6;
+    }
+
+    conservative = conservative && coneIsConservative(mesh, result, meshlet, random, culled);
+  }
+
+  contiguous = contiguous && vertexOffset == result.vertices.size() &&
+    3 * triangleOffset == result.triangles.size() && triangleOffset == mesh.triangleCount();
+  std::printf("  %d camera positions culled by the cone test\n", culled);
+
+  CHECK(limits);
+  CHECK(distinct);
+  CHECK(contiguous);
+  CHECK(sameTriangles);
+  CHECK(greedy);
+  CHECK(!spansBreak);
+  CHECK(bounded);
+  CHECK(conservative);
+}
+
+}
+
+
+int main()
+{
+  Mesh empty;
+  empty.name = "empty";
+  empty.stride = 3;
+  checkMesh(empty);
+
+  checkMesh(makeGrid("curved grid", 40, 3, true));
+
+  Mesh sets = makeGrid("flat grid with sets", 30, 8, false);
+  const uint32_t breaks[] = { 0, 17, 17, 500, 501, 1799 };
+  sets.breaks.assign(breaks, breaks + sizeof(breaks) / sizeof(breaks[0]));
+  checkMesh(sets);
+
+  checkMesh(makeFan(300));
+  checkMesh(makeSoup(200));
+  return test::testResult();
+}
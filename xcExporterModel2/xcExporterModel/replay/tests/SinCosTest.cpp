@@ -0,0 +1,137 @@
+//
+//
+
+//SinCosTest.cpp
+
+//Checks the accuracy SinCos.h documents for sinCosFast(), with the kernels
+//of every instruction set level the machine can run: at most 1 ulp for
+//|angle| <= pi/4 and 2 ulp for |angle| <= 2^20, against the C library, for
+//results of magnitude above 1e-3.  Angles beyond 2^20, infinities and NaNs
+//must give exactly what the C library gives.
+//
+
+#include "SinCos.h"
+#include "TwistKernels.h"
+#include "TestCheck.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+int64_t orderedBits(double value)
+//Returns:	the bits of value as an integer that orders like the doubles do,
+//			so that the difference of two of them counts the ulps between
+{
+  int64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits < 0 ? std::numeric_limits<int64_t>::min() - bits : bits;
+}
+
+
+uint64_t ulpError(double value, double expected)
+{
+  const int64_t a = orderedBits(value);
+  const int64_t b = orderedBits(expected);
+  return a > b ? static_cast<uint64_t>(a - b) : static_cast<uint64_t>(b - a);
+}
+
+
+uint64_t maxUlpError(const double* values, const double* expected, size_t count)
+//Returns:	the largest ulp error of the values whose expected result has a
+//			magnitude above 1e-3
+{
+  uint64_t error = 0;
+  size_t i;
+  for (i = 0; i < count; i++) {
+    if (std::fabs(expected[i]) > 1e-3) {
+      const uint64_t e = ulpError(values[i], expected[i]);
+      error = e > error ? e : error;
+    }
+  }
+  return error;
+}
+
+
+bool sameResult(double value, double expected)
+{
+  return (std::isnan(value) && std::isnan(expected)) || orderedBits(value) == orderedBits(expected);
+}
+
+
+void checkRange(const TwistKernels& kernels, double range, uint64_t bound)
+//Summary:	checks the ulp bound on uniformly distributed angles in
+//			[-range, range]; the count is no multiple of any lane width, so
+//			the scalar tail is checked as well
+{
+  const int count = 1000003;
+  std::vector<double> angles(count);
+  std::mt19937_64 random(20240611);
+  std::uniform_real_distribution<double> distribution(-range, range);
+  int i;
+  for (i = 0; i < count; i++) {
+    angles[i] = distribution(random);
+  }
+
+  std::vector<double> sines(count), cosines(count);
+  std::vector<double> expectedSines(count), expectedCosines(count);
+  kernels.sinCosFast(&angles[0], &sines[0], &cosines[0], count);
+  sinCosExact(&angles[0], &expectedSines[0], &expectedCosines[0], count);
+
+  const uint64_t sinError = maxUlpError(&sines[0], &expectedSines[0], count);
+  const uint64_t cosError = maxUlpError(&cosines[0], &expectedCosines[0], count);
+  std::printf("  |angle| <= %-10g sin %llu ulp, cos %llu ulp\n", range,
+    static_cast<unsigned long long>(sinError), static_cast<unsigned long long>(cosError));
+  CHECK(sinError <= bound);
+  CHECK(cosError <= bound);
+}
+
+
+void checkSpecialAngles(const TwistKernels& kernels)
+//Summary:	checks the angles sinCosFast() hands to the C library, and zero
+{
+  const double infinity = std::numeric_limits<double>::infinity();
+  const double angles[] = {
+    0.0, 1048577.0, -3.0e6, 1.0e10, -1.0e300, infinity, -infinity,
+    std::numeric_limits<double>::quiet_NaN(), 1.0e22
+  };
+  const int count = static_cast<int>(sizeof(angles) / sizeof(angles[0]));
+  double sines[count], cosines[count];
+  kernels.sinCosFast(angles, sines, cosines, count);
+
+  int i;
+  for (i = 1; i < count; i++) {
+    CHECK(sameResult(sines[i], std::sin(angles[i])));
+    CHECK(sameResult(cosines[i], std::cos(angles[i])));
+  }
+  CHECK(0.0 == sines[0]);
+  CHECK(1.0 == cosines[0]);
+}
+
+}
+
+
+int main()
+{
+  const TwistKernels* kernels[] = { &kTwistKernelsSSE2, &kTwistKernelsAVX2, &kTwistKernelsAVX512 };
+  const CpuLevel machine = detectCpuLevel();
+
+  int level;
+  for (level = kCpuSSE2; level <= kCpuAVX512; level++) {
+    if (level > machine) {
+      std::printf("%s: not supported by this machine, skipped\n",
+        cpuLevelName(static_cast<CpuLevel>(level)));
+      continue;
+    }
+    std::printf("%s:\n", cpuLevelName(static_cast<CpuLevel>(level)));
+    checkRange(*kernels[level], 0.78539816339744831, 1);
+    checkRange(*kernels[level], 1048576.0, 2);
+    checkSpecialAngles(*kernels[level]);
+  }
+  return test::testResult();
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+// TestCheck.h
+
+//
+// *****************************************************************************
+//
+// The checks of the replay tests
+//
+// *****************************************************************************
+//
+// Every test is a small executable registered with add_test.  CHECK prints
+// a condition that does not hold, with its file and line, and counts it;
+// main() returns testResult(), which is non-zero once any check failed, so
+// that ctest reports the test as failed.
+//
+// *****************************************************************************
+
+#include <cstdio>
+
+namespace test {
+
+inline int& failures()
+{
+  static int count = 0;
+  return count;
+}
+
+inline bool check(bool condition, const char* text, const char* file, int line)
+{
+  if (!condition) {
+    std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, text);
+    failures()++;
+  }
+  return condition;
+}
+
+inline int testResult()
+{
+  if (0 != failures()) {
+    std::fprintf(stderr, "%d checks failed\n", failures());
+    return 1;
+  }
+  return 0;
+}
+
+}
+
+#define CHECK(condition) test::check((condition), #condition, __FILE__, __LINE__)
@@ -0,0 +1,238 @@
+//
+//
+
+//VertexCacheTest.cpp
+
+//Checks the vertex cache optimization of VertexCache.h on a grid, a fan
+//wider than the cache, triangles with repeated vertices, meshes with
+//unused vertices and an empty mesh:
+//
+//  - vertexCacheOrder() returns a permutation of the triangles, so the
+//    reordered list holds exactly the triangles of the original, each with
+//    its vertices in their original winding
+//  - firstUseOrder() returns a permutation of the vertices that numbers
+//    them in the order the triangles first use them, with the unused ones
+//    last in their original order
+//  - on a grid the reordered triangles transform fewer vertices
+//
+
+#include "VertexCache.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+struct Mesh {
+  const char*           name;
+  std::vector<uint32_t> indices;
+  size_t                vertexCount;
+};
+
+
+Mesh makeGrid(uint32_t width, uint32_t height)
+//Returns:	a grid of width x height quads, two triangles each, in row order
+{
+  Mesh mesh;
+  mesh.name = "grid";
+  mesh.vertexCount = (width + 1) * (height + 1);
+  uint32_t x, y;
+  for (y = 0; y < height; y++) {
+    for (x = 0; x < width; x++) {
+      const uint32_t a = y * (width + 1) + x;
+      const uint32_t b = a + 1;
+      const uint32_t c = a + width + 1;
+      const uint32_t d = c + 1;
+      const uint32_t triangles[6] = { a, b, d, a, d, c };
+      mesh.indices.insert(mesh.indices.end(), triangles, triangles + 6);
+    }
+  }
+  return mesh;
+}
+
+
+Mesh makeFan(uint32_t triangleCount)
+//Returns:	a closed fan of triangles around vertex 0, which is shared by
+//			more triangles than the cache holds
+{
+  Mesh mesh;
+  mesh.name = "fan";
+  mesh.vertexCount = triangleCount + 1;
+  uint32_t i;
+  for (i = 0; i < triangleCount; i++) {
+    mesh.indices.push_back(0);
+    mesh.indices.push_back(1 + i);
+    mesh.indices.push_back(1 + (i + 1) % triangleCount);
+  }
+  return mesh;
+}
+
+
+Mesh makeScattered()
+//Returns:	triangles with repeated vertices, a repeated triangle and
+//			vertices no triangle uses, among them the first and the last
+{
+  Mesh mesh;
+  mesh.name = "scattered";
+  mesh.vertexCount = 12;
+  const uint32_t indices[] = {
+    5, 3, 7,
+    2, 2, 9,
+    7, 3, 5,
+    5, 3, 7,
+    4, 4, 4,
+    9, 8, 3,
+    2, 6, 9
+  };
+  mesh.indices.assign(indices, indices + sizeof(indices) / sizeof(indices[0]));
+  return mesh;
+}
+
+
+std::vector<uint32_t> sortedTriangles(const std::vector<uint32_t>& indices)
+//Returns:	the triangles as a sorted list of (a, b, c) keys, so that two
+//			lists with the same triangles compare equal
+{
+  std::vector<uint64_t> keys;
+  size_t i;
+  for (i = 0; i + 3 <= indices.size(); i += 3) {
+    keys.push_back((static_cast<uint64_t>(indices[i]) << 42) |
+      (static_cast<uint64_t>(indices[i + 1]) << 21) | indices[i + 2]);
+  }
+  std::sort(keys.begin(), keys.end());
+  std::vector<uint32_t> sorted;
+  for (i = 0; i < keys.size(); i++) {
+    sorted.push_back(static_cast<uint32_t>(keys[i] >> 42));
+    sorted.push_back(static_cast<uint32_t>(keys[i] >> 21) & 0x1FFFFF);
+    sorted.push_back(static_cast<uint32_t>(keys[i]) & 0x1FFFFF);
+  }
+  return sorted;
+}
+
+
+bool isPermutation(const std::vector<uint32_t>& values, size_t count)
+{
+  if (values.size() != count) {
+    return false;
+  }
+  std::vector<bool> seen(count, false);
+  size_t i;
+  for (i = 0; i < values.size(); i++) {
+    if (values[i] >= count || seen[values[i]]) {
+      return false;
+    }
+    seen[values[i]] = true;
+  }
+  return true;
+}
+
+
+void checkMesh(const Mesh& mesh)
+{
+  std::printf("%s: %zu triangles, %zu vertices\n", mesh.name, mesh.indices.size() / 3,
+    mesh.vertexCount);
+  const size_t triangleCount = mesh.indices.size() / 3;
+  const uint32_t* indices = mesh.indices.empty() ? NULL : &mesh.indices[0];
+
+  std::vector<uint32_t> order;
+  vertexCacheOrder(indices, triangleCount, mesh.vertexCount, order);
+  CHECK(isPermutation(order, triangleCount));
+  if (!isPermutation(order, triangleCount)) {
+    return;
+  }
+
+  std::vector<uint32_t> reordered(mesh.indices.size());
+  size_t i;
+  for (i = 0; i < triangleCount; i++) {
+    std::copy(&mesh.indices[3 * order[i]], &mesh.indices[3 * order[i]] + 3, &reordered[3 * i]);
+  }
+  CHECK(sortedTriangles(reordered) == sortedTriangles(mesh.indices));
+
+  std::vector<uint32_t> remap;
+  firstUseOrder(reordered.empty() ? NULL : &reordered[0], reordered.size(), mesh.vertexCount,
+    remap);
+  CHECK(isPermutation(remap, mesh.vertexCount));
+  if (!isPermutation(remap, mesh.vertexCount)) {
+    return;
+  }
+
+  //walking the renumbered triangles, every vertex is either one seen
+  //before or the next number; the unused vertices follow in their order
+  //
+  uint32_t next = 0;
+  bool firstUse = true;
+  for (i = 0; i < reordered.size(); i++) {
+    const uint32_t vertex = remap[reordered[i]];
+    if (vertex == next) {
+      next++;
+    }
+    else if (vertex > next) {
+      firstUse = false;
+    }
+  }
+  CHECK(firstUse);
+
+  std::vector<bool> used(mesh.vertexCount, false);
+  for (i = 0; i < reordered.size(); i++) {
+    used[reordered[i]] = true;
+  }
+  bool unusedLast = true;
+  for (i = 0; i < mesh.vertexCount; i++) {
+    if (!used[i]) {
+      unusedLast = unusedLast && remap[i] == next;
+      next++;
+    }
+  }
+  CHECK(unusedLast);
+}
+
+
+void checkGridImproves()
+{
+  const Mesh grid = makeGrid(64, 64);
+  const size_t triangleCount = grid.indices.size() / 3;
+  std::vector<uint32_t> order;
+  vertexCacheOrder(&grid.indices[0], triangleCount, grid.vertexCount, order);
+
+  std::vector<uint32_t> reordered(grid.indices.size());
+  size_t i;
+  for (i = 0; i < triangleCount; i++) {
+    std::copy(&grid.indices[3 * order[i]], &grid.indices[3 * order[i]] + 3, &reordered[3 * i]);
+  }
+
+  const VertexCacheStats before = measureVertexCache(&grid.indices[0], triangleCount,
+    grid.vertexCount, kReportedCacheSize);
+  const VertexCacheStats after = measureVertexCache(&reordered[0], triangleCount,
+    grid.vertexCount, kReportedCacheSize);
+  std::printf("grid ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n", before.acmr, after.acmr,
+    before.atvr, after.atvr);
+  CHECK(after.acmr < before.acmr);
+  CHECK(after.atvr >= 1.0);
+  CHECK(after.acmr >= 0.5);
+}
+
+}
+
+
+int main()
+{
+  Mesh empty;
+  empty.name = "empty";
+  empty.vertexCount = 0;
+  checkMesh(empty);
+
+  Mesh unused;
+  unused.name = "no triangles";
+  unused.vertexCount = 5;
+  checkMesh(unused);
+
+  checkMesh(makeGrid(1, 1));
+  checkMesh(makeGrid(37, 23));
+  checkMesh(makeFan(100));
+  checkMesh(makeScattered());
+  checkGridImproves();
+  return test::testResult();
+}
@@ -0,0 +1,139 @@
+//
+//
+
+//XcbLayoutTest.cpp
+
+//Checks the chunks the xcb writer emits for a quantized grid, in the indexed
+//layout and in the per face-vertex one, see xcbFormat.h:
+//
+//  - the file is a well formed chunk list that ends with kEnd
+//  - every quantized channel is written exactly once, and the float chunk
+//    it replaces not at all
+//  - apart from the set chunks, which come once per set, no chunk id is
+//    written twice for the shape
+//
+
+#include "ReplayEncoder.h"
+#include "MeshGenerator.h"
+#include "xcbFormat.h"
+#include "TestCheck.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+class StringOutputSink : public OutputSink {
+
+public:
+  bool    write(const char* data, size_t size) override { fData.append(data, size); return true; }
+  bool    flush() override { return true; }
+  size_t  bytesWritten() const override { return fData.size(); }
+
+  const std::string& data() const { return fData; }
+
+private:
+  std::string fData;
+};
+
+
+std::string idName(uint32_t id)
+{
+  char name[5] = { static_cast<char>(id), static_cast<char>(id >> 8),
+    static_cast<char>(id >> 16), static_cast<char>(id >> 24), '\0' };
+  return name;
+}
+
+
+bool readChunks(const std::string& data, std::map<uint32_t, int>& counts)
+//Summary:	counts the chunks of an encoded file by id
+//Returns:	false if the chunks overrun the file or it does not end with kEnd
+{
+  size_t offset = sizeof(xcb::FileHeader);
+  uint32_t last = 0;
+  while (offset + sizeof(xcb::ChunkHeader) <= data.size()) {
+    xcb::ChunkHeader header;
+    std::memcpy(&header, data.data() + offset, sizeof(header));
+    offset += sizeof(header) + (header.size + xcb::kAlignment - 1) / xcb::kAlignment * xcb::kAlignment;
+    counts[header.id]++;
+    last = header.id;
+  }
+  return offset == data.size() && xcb::kEnd == last;
+}
+
+
+bool isSetChunk(uint32_t id)
+{
+  return xcb::kSetName == id || xcb::kSetTexture == id || xcb::kSetFaceRanges == id ||
+    xcb::kSetTriangles == id || xcb::kSetMeshlets == id;
+}
+
+
+void checkLayout(const char* optionsString, const std::vector<MeshCapture>& captures,
+  const uint32_t* expected, size_t expectedCount, const uint32_t* replaced, size_t replacedCount)
+//Args   :	expected - the chunks that must be written exactly once
+//			replaced - the float chunks that must not be written
+{
+  ExportOptions options;
+  std::vector<std::string> warnings;
+  CHECK(options.parse(optionsString, warnings) && warnings.empty());
+
+  StringOutputSink sink;
+  double seconds = 0.0;
+  CHECK(encodeCaptures(captures, options, true, sink, NULL, NULL, seconds));
+
+  std::map<uint32_t, int> counts;
+  CHECK(readChunks(sink.data(), counts));
+  std::printf("%s: %zu bytes,", optionsString, sink.data().size());
+  std::map<uint32_t, int>::const_iterator chunk;
+  for (chunk = counts.begin(); chunk != counts.end(); ++chunk) {
+    std::printf(" %s x%d", idName(chunk->first).c_str(), chunk->second);
+  }
+  std::printf("\n");
+
+  bool once = true;
+  for (chunk = counts.begin(); chunk != counts.end(); ++chunk) {
+    if (!isSetChunk(chunk->first) && 1 != chunk->second) {
+      std::fprintf(stderr, "%s written %d times\n", idName(chunk->first).c_str(), chunk->second);
+      once = false;
+    }
+  }
+  CHECK(once);
+
+  size_t i;
+  for (i = 0; i < expectedCount; i++) {
+    CHECK(1 == counts[expected[i]]);
+  }
+  for (i = 0; i < replacedCount; i++) {
+    CHECK(0 == counts[replaced[i]]);
+  }
+}
+
+}
+
+
+int main()
+{
+  std::vector<MeshCapture> captures(1);
+  generateMesh(kGridMesh, 5000, captures[0]);
+
+  const uint32_t replaced[] = { xcb::kPositions, xcb::kNormals, xcb::kTangents, xcb::kBinormals,
+    xcb::kUVs, xcb::kVertices };
+  const size_t replacedCount = sizeof(replaced) / sizeof(replaced[0]);
+
+  const uint32_t indexed[] = { xcb::kShape, xcb::kPositionBounds, xcb::kVerticesQ,
+    xcb::kVertexIndices, xcb::kTriangles, xcb::kEnd };
+  checkLayout("quantize=1;sets=1;uvs=1;normals=1;triangulate=1", captures, indexed,
+    sizeof(indexed) / sizeof(indexed[0]), replaced, replacedCount);
+
+  const uint32_t faceVertex[] = { xcb::kShape, xcb::kPositionBounds, xcb::kPositionsQ,
+    xcb::kNormalsQ, xcb::kFaceCounts, xcb::kFacePositions, xcb::kFaceNormals, xcb::kUVsQ,
+    xcb::kFaceUVs, xcb::kEnd };
+  checkLayout("quantize=1;sets=1;uvs=1;normals=1;indexed=0;triangulate=0", captures, faceVertex,
+    sizeof(faceVertex) / sizeof(faceVertex[0]), replaced, replacedCount);
+  return test::testResult();
+}
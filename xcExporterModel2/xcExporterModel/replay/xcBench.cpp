@@ -0,0 +1,414 @@
+//
+//
+
+//xcBench.cpp
+
+//Benchmarks the writers of the exporter on generated meshes (see
+//MeshGenerator.h), without Maya.  Every shape is generated at every size
+//and encoded through every export path:
+//
+//  text       the xc text format with the defaults of its translator
+//  binary     xcb per face-vertex, with the faces as they are
+//             (triangulate=0;indexed=0)
+//  indexed    xcb welded and triangulated, cache optimized, with meshlets
+//             (triangulate=1;vertexCache=1;meshlets=1)
+//  quantized  indexed with the vertex table quantized (quantize=1)
+//
+//The output is discarded, so that a run measures the encoders rather than
+//the disk.  A case is encoded the given number of times and reports its
+//best run, as MB/s of output, faces/s and the peak resident memory of the
+//process while the mesh was held and encoded.
+//
+//  xcBench [-s sizes] [-m shapes] [-p paths] [-n runs] [-O options] [-j file]
+//
+//  -s sizes    comma separated face counts, k and m suffixes allowed;
+//              default 1k,10k,100k,1m.  Sizes up to 50m are meant to be
+//              asked for explicitly: 50m faces need several GB.
+//  -m shapes   comma separated shapes, default grid,sphere,ngon,multiuv
+//  -p paths    comma separated paths, default text,binary,indexed,quantized
+//  -n runs     encode every case this many times, default 3
+//  -O options  export options as "name=value;...", on top of those of the
+//              path, e.g. encodeThreads=1
+//  -j file     also write the results as JSON to file
+//
+//XC_CPU_LEVEL chooses the kernels like it does for the plug-in.  The
+//meshes only depend on the face count, so the numbers of one machine
+//compare from release to release.
+//
+//On Linux the peak is reset for every case; elsewhere it is the peak of
+//the process so far, which only grows with the cases.  The messages of the
+//writers, such as the vertex cache statistics, go to stderr.
+//
+
+#include "ReplayEncoder.h"
+#include "MeshGenerator.h"
+#include "ExportKernels.h"
+#include "JsonWriter.h"
+#include "CpuDispatch.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+enum ExportPath {
+  kTextPath = 0,
+  kBinaryPath,
+  kIndexedPath,
+  kQuantizedPath,
+  kExportPathCount
+};
+
+struct PathInfo {
+  const char* name;
+  bool        binary;
+  const char* options;
+};
+
+const PathInfo kPaths[kExportPathCount] = {
+  { "text",       false,  "" },
+  { "binary",     true,   "triangulate=0;indexed=0" },
+  { "indexed",    true,   "triangulate=1;vertexCache=1;meshlets=1" },
+  { "quantized",  true,   "triangulate=1;vertexCache=1;meshlets=1;quantize=1" }
+};
+
+const size_t kMaxFaceCount = 50000000;
+
+
+struct Arguments {
+  Arguments() : runs(3) {}
+
+  std::vector<size_t>     sizes;
+  std::vector<MeshShape>  shapes;
+  std::vector<int>        paths;
+  int                     runs;
+  std::string             options;
+  std::string             json;
+};
+
+
+struct Result {
+  MeshShape   shape;
+  size_t      faceCount;
+  int         path;
+  size_t      bytes;
+  double      seconds;
+  double      peakMB;
+};
+
+
+void printUsage()
+{
+  std::fprintf(stderr,
+    "usage: xcBench [-s sizes] [-m shapes] [-p paths] [-n runs] [-O options] [-j file]\n"
+    "  -s sizes    comma separated face counts such as 1k,250k,50m; default 1k,10k,100k,1m\n"
+    "  -m shapes   grid, sphere, ngon, multiuv; default all\n"
+    "  -p paths    text, binary, indexed, quantized; default all\n"
+    "  -n runs     encode every case this many times and keep the best, default 3\n"
+    "  -O options  export options as \"name=value;...\" on top of those of the path\n"
+    "  -j file     also write the results as JSON to file\n");
+}
+
+
+std::vector<std::string> splitList(const std::string& list)
+{
+  std::vector<std::string> items;
+  size_t start = 0;
+  while (start <= list.size()) {
+    size_t end = list.find(',', start);
+    if (std::string::npos == end) {
+      end = list.size();
+    }
+    if (end > start) {
+      items.push_back(list.substr(start, end - start));
+    }
+    start = end + 1;
+  }
+  return items;
+}
+
+
+bool parseSize(const std::string& text, size_t& size)
+//Summary:	reads a face count such as 5000, 25k or 2m
+//Returns:	false if text is not a count from 1 to 50m
+{
+  char* end = NULL;
+  const double value = std::strtod(text.c_str(), &end);
+  double scale = 1.0;
+  if ('k' == *end || 'K' == *end) {
+    scale = 1e3;
+    end++;
+  }
+  else if ('m' == *end || 'M' == *end) {
+    scale = 1e6;
+    end++;
+  }
+  if (end == text.c_str() || '\0' != *end) {
+    return false;
+  }
+
+  const double faces = value * scale + 0.5;
+  if (faces < 1.0 || faces > static_cast<double>(kMaxFaceCount)) {
+    return false;
+  }
+  size = static_cast<size_t>(faces);
+  return true;
+}
+
+
+bool parseArguments(int argc, char** argv, Arguments& arguments)
+//Returns:	false if the arguments are incomplete or unknown
+{
+  int i;
+  size_t j;
+  for (i = 1; i < argc; i++) {
+    const std::string argument = argv[i];
+    if (i + 1 >= argc) {
+      return false;
+    }
+    const std::string value = argv[++i];
+    const std::vector<std::string> items = splitList(value);
+
+    if ("-s" == argument) {
+      for (j = 0; j < items.size(); j++) {
+        size_t size;
+        if (!parseSize(items[j], size)) {
+          std::fprintf(stderr, "%s: not a face count from 1 to 50m\n", items[j].c_str());
+          return false;
+        }
+        arguments.sizes.push_back(size);
+      }
+    }
+    else if ("-m" == argument) {
+      for (j = 0; j < items.size(); j++) {
+        MeshShape shape;
+        if (!findMeshShape(items[j], shape)) {
+          std::fprintf(stderr, "%s: unknown shape\n", items[j].c_str());
+          return false;
+        }
+        arguments.shapes.push_back(shape);
+      }
+    }
+    else if ("-p" == argument) {
+      for (j = 0; j < items.size(); j++) {
+        int path;
+        for (path = 0; path < kExportPathCount && items[j] != kPaths[path].name; path++) {
+        }
+        if (kExportPathCount == path) {
+          std::fprintf(stderr, "%s: unknown path\n", items[j].c_str());
+          return false;
+        }
+        arguments.paths.push_back(path);
+      }
+    }
+    else if ("-n" == argument) {
+      arguments.runs = std::atoi(value.c_str());
+      if (arguments.runs < 1) {
+        return false;
+      }
+    }
+    else if ("-O" == argument) {
+      arguments.options = value;
+    }
+    else if ("-j" == argument) {
+      arguments.json = value;
+    }
+    else {
+      return false;
+    }
+  }
+
+  if (arguments.sizes.empty()) {
+    const size_t sizes[] = { 1000, 10000, 100000, 1000000 };
+    arguments.sizes.assign(sizes, sizes + sizeof(sizes) / sizeof(sizes[0]));
+  }
+  if (arguments.shapes.empty()) {
+    int shape;
+    for (shape = 0; shape < kMeshShapeCount; shape++) {
+      arguments.shapes.push_back(static_cast<MeshShape>(shape));
+    }
+  }
+  if (arguments.paths.empty()) {
+    int path;
+    for (path = 0; path < kExportPathCount; path++) {
+      arguments.paths.push_back(path);
+    }
+  }
+  return true;
+}
+
+
+void resetPeakMemory()
+//Summary:	starts a new peak of resident memory, where the system allows it
+{
+#if defined(__linux__)
+  std::ofstream file("/proc/self/clear_refs");
+  file << "5";
+#endif
+}
+
+
+double peakMemoryMB()
+//Returns:	the peak resident memory of the process in MB since
+//			resetPeakMemory(), or since it started
+{
+#if defined(_WIN32)
+  PROCESS_MEMORY_COUNTERS counters;
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+    return counters.PeakWorkingSetSize / 1e6;
+  }
+  return 0.0;
+#else
+#if defined(__linux__)
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (0 == line.compare(0, 6, "VmHWM:")) {
+      return std::atof(line.c_str() + 6) * 1024.0 / 1e6;
+    }
+  }
+#endif
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+  return usage.ru_maxrss / 1e6;
+#else
+  return usage.ru_maxrss * 1024.0 / 1e6;
+#endif
+#endif
+}
+
+
+bool writeResults(const std::string& fileName, const char* kernels, unsigned int threads,
+                  int runs, const std::vector<Result>& results)
+{
+  std::ofstream file(fileName.c_str());
+  if (!file) {
+    return false;
+  }
+
+  file << "{\n\"kernels\": ";
+  writeJsonString(file, kernels);
+  file << ",\n\"encodeThreads\": " << threads
+    << ",\n\"runs\": " << runs
+    << ",\n\"results\": [";
+
+  size_t i;
+  for (i = 0; i < results.size(); i++) {
+    const Result& result = results[i];
+    char numbers[160];
+    snprintf(numbers, sizeof(numbers),
+      "\"seconds\": %.6f, \"mbPerSecond\": %.2f, \"facesPerSecond\": %.0f, \"peakRssMB\": %.1f",
+      result.seconds, result.bytes / result.seconds / 1e6,
+      result.faceCount / result.seconds, result.peakMB);
+
+    file << (0 == i ? "\n" : ",\n") << "{\"shape\": ";
+    writeJsonString(file, meshShapeName(result.shape));
+    file << ", \"faces\": " << result.faceCount << ", \"path\": ";
+    writeJsonString(file, kPaths[result.path].name);
+    file << ", \"bytes\": " << result.bytes << ", " << numbers << "}";
+  }
+  file << "\n]\n}\n";
+
+  file.close();
+  return !file.fail();
+}
+
+}
+
+
+int main(int argc, char** argv)
+{
+  Arguments arguments;
+  if (!parseArguments(argc, argv, arguments)) {
+    printUsage();
+    return 2;
+  }
+
+  bool forced;
+  const CpuLevel level = chooseCpuLevel(forced);
+  selectExportKernels(level);
+
+  //the options of every path: the defaults of the translator, those of
+  //the path, then those given with -O
+  //
+  ExportOptions options[kExportPathCount];
+  int path;
+  for (path = 0; path < kExportPathCount; path++) {
+    std::vector<std::string> warnings;
+    options[path].triangulate = kPaths[path].binary;
+    options[path].parse(kPaths[path].options, warnings);
+    options[path].parse(arguments.options, warnings);
+    size_t i;
+    for (i = 0; i < warnings.size() && kTextPath == path; i++) {
+      std::fprintf(stderr, "Export options: %s\n", warnings[i].c_str());
+    }
+  }
+
+  const unsigned int threads = options[kTextPath].encodeThreads();
+  std::printf("%s kernels, %u encode threads, best of %d runs\n\n", cpuLevelName(level),
+    threads, arguments.runs);
+  std::printf("%-8s %10s %-9s %12s %9s %9s %12s %9s\n", "shape", "faces", "path", "bytes",
+    "s", "MB/s", "faces/s", "peak MB");
+
+  std::vector<Result> results;
+  size_t s, m, p;
+  for (s = 0; s < arguments.sizes.size(); s++) {
+    for (m = 0; m < arguments.shapes.size(); m++) {
+      std::vector<MeshCapture> captures(1);
+      generateMesh(arguments.shapes[m], arguments.sizes[s], captures[0]);
+
+      for (p = 0; p < arguments.paths.size(); p++) {
+        Result result;
+        result.shape = arguments.shapes[m];
+        result.faceCount = captures[0].faceCount();
+        result.path = arguments.paths[p];
+        result.bytes = 0;
+        result.seconds = 0.0;
+
+        resetPeakMemory();
+        int run;
+        for (run = 0; run < arguments.runs; run++) {
+          DiscardOutputSink sink;
+          double seconds = 0.0;
+          if (!encodeCaptures(captures, options[result.path], kPaths[result.path].binary, sink,
+                NULL, NULL, seconds)) {
+            std::fprintf(stderr, "%s, %llu faces, %s: encoding failed\n",
+              meshShapeName(result.shape), static_cast<unsigned long long>(result.faceCount),
+              kPaths[result.path].name);
+            return 1;
+          }
+          result.bytes = sink.bytesWritten();
+          result.seconds = 0 == run ? seconds : std::min(result.seconds, seconds);
+        }
+        result.peakMB = peakMemoryMB();
+
+        std::printf("%-8s %10llu %-9s %12llu %9.4f %9.1f %12.0f %9.1f\n",
+          meshShapeName(result.shape), static_cast<unsigned long long>(result.faceCount),
+          kPaths[result.path].name, static_cast<unsigned long long>(result.bytes),
+          result.seconds, result.bytes / result.seconds / 1e6,
+          result.faceCount / result.seconds, result.peakMB);
+        std::fflush(stdout);
+        results.push_back(result);
+      }
+    }
+  }
+
+  if (!arguments.json.empty() &&
+      !writeResults(arguments.json, cpuLevelName(level), threads, arguments.runs, results)) {
+    std::fprintf(stderr, "%s: could not be written\n", arguments.json.c_str());
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,189 @@
+//
+//
+
+//xcFormatBench.cpp
+
+//Compares the number formatting of the text writers with the one it
+//replaced.  The same pseudo-random floats, laid out as the "(x, y, z)\t"
+//rows of the Mesh_info section, are formatted with
+//
+//  ostream     std::ostream::operator<<, with max_digits10 significant
+//              digits for the shortest mode so that the values read back
+//              exactly, and std::fixed for the fixed mode
+//  formatter   TextFormatter, see TextFormatter.h
+//
+//once in the shortest mode and once with a fixed precision.  The text goes
+//to a stream that only counts it, so only the formatting is timed.
+//
+//  xcFormatBench [-v values] [-p precision] [-n runs]
+//
+//  -v values      number of floats, default 3000000
+//  -p precision   digits after the point of the fixed mode, default 6
+//  -n runs        runs of every path, the best one is reported; default 3
+//
+
+#include "TextFormatter.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <limits>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace {
+
+class CountingBuf : public std::streambuf {
+  //a stream buffer that drops the text written to it and counts its bytes
+
+public:
+  CountingBuf() : fBytes(0) {}
+
+  size_t bytes() const { return fBytes; }
+
+protected:
+  std::streamsize xsputn(const char*, std::streamsize count) override
+  {
+    fBytes += static_cast<size_t>(count);
+    return count;
+  }
+
+  int_type overflow(int_type c) override
+  {
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+      fBytes++;
+    }
+    return traits_type::not_eof(c);
+  }
+
+private:
+  size_t fBytes;
+};
+
+
+template <typename Output>
+void writeRows(Output& out, const std::vector<float>& values)
+{
+  size_t i;
+  for (i = 0; i + 3 <= values.size(); i += 3) {
+    out << "(" << values[i] << ", " << values[i + 1] << ", " << values[i + 2] << ")\t";
+  }
+}
+
+
+typedef std::chrono::steady_clock Clock;
+
+double formatOstream(const std::vector<float>& values, int precision, size_t& bytes)
+//Returns:	the seconds std::ostream took to format values
+{
+  CountingBuf buffer;
+  std::ostream os(&buffer);
+  if (TextFormatter::kShortest == precision) {
+    os << std::setprecision(std::numeric_limits<float>::max_digits10);
+  }
+  else {
+    os << std::fixed << std::setprecision(precision);
+  }
+
+  const Clock::time_point begin = Clock::now();
+  writeRows(os, values);
+  os.flush();
+  const double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+  bytes = buffer.bytes();
+  return seconds;
+}
+
+
+double formatFormatter(const std::vector<float>& values, int precision, size_t& bytes)
+//Returns:	the seconds TextFormatter took to format values
+{
+  CountingBuf buffer;
+  std::ostream os(&buffer);
+
+  const Clock::time_point begin = Clock::now();
+  {
+    TextFormatter out(os, precision);
+    writeRows(out, values);
+    out.flush();
+  }
+  const double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+  bytes = buffer.bytes();
+  return seconds;
+}
+
+
+void report(const char* mode, const char* name, double seconds, size_t values, size_t bytes)
+{
+  std::printf("%-9s %-10s %9.3f s %8.1f ns/value %9.1f MB/s %12zu bytes\n", mode, name,
+    seconds, seconds / values * 1e9, bytes / seconds / 1e6, bytes);
+}
+
+
+void compare(const char* mode, const std::vector<float>& values, int precision, int runs)
+{
+  double ostreamBest = 0.0;
+  double formatterBest = 0.0;
+  size_t ostreamBytes = 0;
+  size_t formatterBytes = 0;
+  int run;
+  for (run = 0; run < runs; run++) {
+    const double ostreamSeconds = formatOstream(values, precision, ostreamBytes);
+    const double formatterSeconds = formatFormatter(values, precision, formatterBytes);
+    ostreamBest = 0 == run || ostreamSeconds < ostreamBest ? ostreamSeconds : ostreamBest;
+    formatterBest = 0 == run || formatterSeconds < formatterBest ? formatterSeconds : formatterBest;
+  }
+  report(mode, "ostream", ostreamBest, values.size(), ostreamBytes);
+  report(mode, "formatter", formatterBest, values.size(), formatterBytes);
+  std::printf("%-9s speedup %.2fx\n", mode, ostreamBest / formatterBest);
+}
+
+}
+
+
+int main(int argc, char** argv)
+{
+  int valueCount = 3000000;
+  int precision = 6;
+  int runs = 3;
+  int i;
+  for (i = 1; i + 1 < argc; i += 2) {
+    const std::string argument = argv[i];
+    if ("-v" == argument) {
+      valueCount = std::atoi(argv[i + 1]);
+    }
+    else if ("-p" == argument) {
+      precision = std::atoi(argv[i + 1]);
+    }
+    else if ("-n" == argument) {
+      runs = std::atoi(argv[i + 1]);
+    }
+    else {
+      break;
+    }
+  }
+  if (i != argc || valueCount < 3 || precision < 0 || runs < 1) {
+    std::fprintf(stderr, "usage: xcFormatBench [-v values] [-p precision] [-n runs]\n");
+    return 2;
+  }
+
+  //coordinates of a mesh a few hundred units across, with a fixed seed so
+  //that every run formats the same text
+  //
+  std::vector<float> values(static_cast<size_t>(valueCount) / 3 * 3);
+  unsigned int state = 12345u;
+  size_t v;
+  for (v = 0; v < values.size(); v++) {
+    state = state * 1664525u + 1013904223u;
+    values[v] = (static_cast<float>(state >> 8) / 16777216.0f - 0.5f) * 500.0f;
+  }
+
+  std::printf("%zu floats, best of %d runs\n", values.size(), runs);
+  compare("shortest", values, TextFormatter::kShortest, runs);
+  char mode[32];
+  std::snprintf(mode, sizeof(mode), "fixed %d", precision);
+  compare(mode, values, precision, runs);
+  return 0;
+}
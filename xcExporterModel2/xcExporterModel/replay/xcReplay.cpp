@@ -0,0 +1,192 @@
+//
+//
+
+//xcReplay.cpp
+
+//Encodes the meshes of a capture file (see MeshCapture.h) with the writers
+//of the exporter, without Maya, and reports how long that took.  Every run
+//restores fresh writers from the capture, then times the encoding through
+//an EncodePipeline exactly as an export does it, headers included.
+//
+//  xcReplay [-b] [-o file] [-n runs] [-O options] capture.xcap
+//
+//  -b          write the binary xcb format instead of the text format
+//  -o file     write the output to file; by default it is only counted
+//  -n runs     encode the capture this many times, default 1
+//  -O options  export options as "name=value;...", on top of the defaults
+//              of the translator; trace=1 and report=1 save their JSON
+//              next to the output, or the capture if there is none
+//
+//XC_CPU_LEVEL chooses the kernels like it does for the plug-in.
+//
+
+#include "ReplayEncoder.h"
+#include "MeshCapture.h"
+#include "OutputSink.h"
+#include "ExportKernels.h"
+#include "ExportTrace.h"
+#include "ExportReport.h"
+#include "CpuDispatch.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Arguments {
+  Arguments() : binary(false), runs(1) {}
+
+  bool        binary;
+  int         runs;
+  std::string output;
+  std::string options;
+  std::string capture;
+};
+
+
+void printUsage()
+{
+  std::fprintf(stderr,
+    "usage: xcReplay [-b] [-o file] [-n runs] [-O options] capture.xcap\n"
+    "  -b          write the binary xcb format instead of the text format\n"
+    "  -o file     write the output to file; by default it is only counted\n"
+    "  -n runs     encode the capture this many times, default 1\n"
+    "  -O options  export options as \"name=value;...\"\n");
+}
+
+
+bool parseArguments(int argc, char** argv, Arguments& arguments)
+//Returns:	false if the arguments are incomplete or unknown
+{
+  int i;
+  for (i = 1; i < argc; i++) {
+    const std::string argument = argv[i];
+    const bool hasValue = i + 1 < argc;
+    if ("-b" == argument) {
+      arguments.binary = true;
+    }
+    else if ("-o" == argument && hasValue) {
+      arguments.output = argv[++i];
+    }
+    else if ("-n" == argument && hasValue) {
+      arguments.runs = std::atoi(argv[++i]);
+      if (arguments.runs < 1) {
+        return false;
+      }
+    }
+    else if ("-O" == argument && hasValue) {
+      arguments.options = argv[++i];
+    }
+    else if ('-' != argument[0] && arguments.capture.empty()) {
+      arguments.capture = argument;
+    }
+    else {
+      return false;
+    }
+  }
+  return !arguments.capture.empty();
+}
+
+}
+
+
+int main(int argc, char** argv)
+{
+  Arguments arguments;
+  if (!parseArguments(argc, argv, arguments)) {
+    printUsage();
+    return 2;
+  }
+
+  bool forced;
+  const CpuLevel level = chooseCpuLevel(forced);
+  selectExportKernels(level);
+
+  //the defaults the translators register, see initializePlugin()
+  //
+  ExportOptions options;
+  options.triangulate = arguments.binary;
+  std::vector<std::string> warnings;
+  options.parse(arguments.options, warnings);
+  size_t i;
+  for (i = 0; i < warnings.size(); i++) {
+    std::fprintf(stderr, "Export options: %s\n", warnings[i].c_str());
+  }
+
+  std::vector<MeshCapture> captures;
+  std::string error;
+  if (!readCaptureFile(arguments.capture, captures, error)) {
+    std::fprintf(stderr, "%s\n", error.c_str());
+    return 1;
+  }
+
+  size_t faceCount = 0;
+  for (i = 0; i < captures.size(); i++) {
+    faceCount += captures[i].faceCount();
+  }
+  std::printf("%s: %u meshes, %llu faces; %s, %s kernels, %u encode threads\n",
+    arguments.capture.c_str(), static_cast<unsigned int>(captures.size()),
+    static_cast<unsigned long long>(faceCount), arguments.binary ? "xcb" : "text",
+    cpuLevelName(level), options.encodeThreads());
+
+  ExportTrace trace;
+  ExportReport report;
+  if (options.trace) {
+    trace.start();
+  }
+
+  double best = 0.0;
+  double total = 0.0;
+  size_t bytes = 0;
+  int run;
+  for (run = 0; run < arguments.runs; run++) {
+    //only the last run is reported
+    //
+    report.clear();
+
+    DiscardOutputSink discard;
+    FileOutputSink* file = NULL;
+    if (!arguments.output.empty()) {
+      file = new FileOutputSink(arguments.output.c_str(), arguments.binary);
+      if (!file->isOpen()) {
+        std::fprintf(stderr, "%s: could not be opened for writing\n", arguments.output.c_str());
+        delete file;
+        return 1;
+      }
+    }
+    OutputSink& sink = NULL != file ? static_cast<OutputSink&>(*file) : discard;
+
+    double seconds = 0.0;
+    bool succeeded = encodeCaptures(captures, options, arguments.binary, sink,
+      options.trace ? &trace : NULL, options.report ? &report : NULL, seconds);
+    bytes = sink.bytesWritten();
+    if (NULL != file) {
+      succeeded = file->close() && succeeded;
+      delete file;
+    }
+    if (!succeeded) {
+      std::fprintf(stderr, "run %d failed\n", run + 1);
+      return 1;
+    }
+
+    best = 0 == run ? seconds : std::min(best, seconds);
+    total += seconds;
+    std::printf("run %d: %.3f s, %.1f MB/s, %.0f faces/s\n", run + 1, seconds,
+      bytes / seconds / 1e6, faceCount / seconds);
+  }
+
+  std::printf("%llu bytes; best %.3f s (%.1f MB/s), mean %.3f s\n",
+    static_cast<unsigned long long>(bytes), best, bytes / best / 1e6, total / arguments.runs);
+
+  const std::string base = arguments.output.empty() ? arguments.capture : arguments.output;
+  if (options.trace && !trace.write(base + ".trace.json")) {
+    std::fprintf(stderr, "%s.trace.json: could not be written\n", base.c_str());
+  }
+  if (options.report && !report.write(base + ".report.json", base)) {
+    std::fprintf(stderr, "%s.report.json: could not be written\n", base.c_str());
+  }
+  return 0;
+}
@@ -0,0 +1,141 @@
+//
+//
+
+//xcSinkBench.cpp
+
+//Compares the output path of the exporter with the one it replaced.  The
+//same listing of vertex lines, "V:\t(x, y, z)\n" like the text writer
+//emits, is written to a file twice:
+//
+//  unitbuf    a std::ofstream with std::ios::unitbuf set, which flushes to
+//             the OS after every insertion, as the exporter used to do
+//  sink       a std::ostream over SinkStreamBuf and FileOutputSink
+//
+//and every path reports its wall time and, on Linux, the number of write
+//system calls it made (syscw of /proc/self/io).
+//
+//  xcSinkBench [-v values] [-o file]
+//
+//  -v values   number of vertex lines, default 1000000
+//  -o file     the file written, default xcSinkBench.tmp; removed afterwards
+//
+
+#include "OutputSink.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <ostream>
+#include <string>
+
+namespace {
+
+long long writeSyscalls()
+//Returns:	the write system calls of the process so far, -1 if unknown
+{
+#if defined(__linux__)
+  std::ifstream io("/proc/self/io");
+  std::string line;
+  while (std::getline(io, line)) {
+    if (0 == line.compare(0, 6, "syscw:")) {
+      return std::atoll(line.c_str() + 6);
+    }
+  }
+#endif
+  return -1;
+}
+
+
+void writeListing(std::ostream& os, int values)
+{
+  int i;
+  for (i = 0; i < values; i++) {
+    const float x = 0.001f * i;
+    os << "V:" << "\t" << "(" << x << ", " << -x << ", " << 0.5f * x << ")\n";
+  }
+}
+
+
+void report(const char* name, double seconds, long long syscalls, size_t bytes)
+{
+  std::printf("%-8s %9.3f s %9.1f MB/s", name, seconds, bytes / seconds / 1e6);
+  if (syscalls >= 0) {
+    std::printf(" %12lld writes", syscalls);
+  }
+  std::printf("\n");
+}
+
+}
+
+
+int main(int argc, char** argv)
+{
+  int values = 1000000;
+  std::string fileName = "xcSinkBench.tmp";
+  int i;
+  for (i = 1; i + 1 < argc; i += 2) {
+    const std::string argument = argv[i];
+    if ("-v" == argument) {
+      values = std::atoi(argv[i + 1]);
+    }
+    else if ("-o" == argument) {
+      fileName = argv[i + 1];
+    }
+    else {
+      break;
+    }
+  }
+  if (i != argc || values < 1) {
+    std::fprintf(stderr, "usage: xcSinkBench [-v values] [-o file]\n");
+    return 2;
+  }
+
+  std::printf("%d vertex lines to %s\n", values, fileName.c_str());
+
+  typedef std::chrono::steady_clock Clock;
+  size_t bytes = 0;
+  {
+    long long syscalls = writeSyscalls();
+    const Clock::time_point begin = Clock::now();
+    std::ofstream file(fileName.c_str(), std::ios::out);
+    file.setf(std::ios::unitbuf);
+    writeListing(file, values);
+    file.close();
+    const double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    syscalls = syscalls < 0 ? -1 : writeSyscalls() - syscalls;
+    if (!file) {
+      std::fprintf(stderr, "%s: could not be written\n", fileName.c_str());
+      return 1;
+    }
+
+    std::ifstream written(fileName.c_str(), std::ios::binary | std::ios::ate);
+    bytes = static_cast<size_t>(written.tellg());
+    report("unitbuf", seconds, syscalls, bytes);
+  }
+
+  {
+    long long syscalls = writeSyscalls();
+    const Clock::time_point begin = Clock::now();
+    FileOutputSink sink(fileName.c_str());
+    bool succeeded;
+    {
+      SinkStreamBuf buffer(sink);
+      std::ostream os(&buffer);
+      writeListing(os, values);
+      os.flush();
+      succeeded = !os.fail();
+    }
+    succeeded = sink.close() && succeeded;
+    const double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    syscalls = syscalls < 0 ? -1 : writeSyscalls() - syscalls;
+    if (!succeeded || sink.bytesWritten() != bytes) {
+      std::fprintf(stderr, "%s: could not be written\n", fileName.c_str());
+      return 1;
+    }
+    report("sink", seconds, syscalls, sink.bytesWritten());
+  }
+
+  std::remove(fileName.c_str());
+  return 0;
+}
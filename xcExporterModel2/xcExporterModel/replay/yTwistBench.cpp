@@ -0,0 +1,139 @@
+//
+//
+
+//yTwistBench.cpp
+
+//Benchmarks the yTwist deformer's kernels on a point cloud, without Maya.
+//The same cloud is twisted block by block, like yTwist::deform does on one
+//thread:
+//
+//  exact      the SSE2 kernels with the C library sin and cos, which exact
+//             mode always runs
+//  fast       sinCosFast(), with the kernels of every instruction set level
+//             the machine can run
+//
+//Every path reports its best time of the runs and, for the fast ones, the
+//largest distance of a twisted point from the exact result.
+//
+//  yTwistBench [-p points] [-n runs]
+//
+//  -p points   size of the point cloud, default 1000000
+//  -n runs     runs of every path, default 5
+//
+
+#include "TwistKernels.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+//the angle attribute of the yTwist node, at an envelope of 1
+//
+const double kMagnitude = 0.35;
+
+void twistCloud(double* points, int count, void (*twistBlock)(double*, int, double, double, bool),
+  bool fast)
+{
+  int first;
+  for (first = 0; first < count; first += kTwistBlockSize) {
+    const int size = count - first < kTwistBlockSize ? count - first : kTwistBlockSize;
+    twistBlock(points + 4 * first, size, kMagnitude, 1.0, fast);
+  }
+}
+
+
+double bestTime(const std::vector<double>& cloud, std::vector<double>& points,
+  void (*twistBlock)(double*, int, double, double, bool), bool fast, int runs)
+//Returns:	the seconds of the fastest run; points holds the twisted cloud
+{
+  typedef std::chrono::steady_clock Clock;
+  double best = 0.0;
+  int run;
+  for (run = 0; run < runs; run++) {
+    points = cloud;
+    const Clock::time_point begin = Clock::now();
+    twistCloud(&points[0], static_cast<int>(points.size() / 4), twistBlock, fast);
+    const double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    best = 0 == run || seconds < best ? seconds : best;
+  }
+  return best;
+}
+
+
+double maxDistance(const std::vector<double>& points, const std::vector<double>& expected)
+{
+  double distance = 0.0;
+  size_t i;
+  for (i = 0; i < points.size(); i += 4) {
+    const double dx = points[i] - expected[i];
+    const double dz = points[i + 2] - expected[i + 2];
+    const double d = std::sqrt(dx * dx + dz * dz);
+    distance = d > distance ? d : distance;
+  }
+  return distance;
+}
+
+}
+
+
+int main(int argc, char** argv)
+{
+  int pointCount = 1000000;
+  int runs = 5;
+  int i;
+  for (i = 1; i + 1 < argc; i += 2) {
+    const std::string argument = argv[i];
+    if ("-p" == argument) {
+      pointCount = std::atoi(argv[i + 1]);
+    }
+    else if ("-n" == argument) {
+      runs = std::atoi(argv[i + 1]);
+    }
+    else {
+      break;
+    }
+  }
+  if (i != argc || pointCount < 1 || runs < 1) {
+    std::fprintf(stderr, "usage: yTwistBench [-p points] [-n runs]\n");
+    return 2;
+  }
+
+  //a cloud of (x, y, z, 1) points, the layout of MPoint, 20 units high so
+  //that the twist angles reach about 3.5 radians
+  //
+  std::vector<double> cloud(4 * static_cast<size_t>(pointCount));
+  std::mt19937_64 random(7);
+  std::uniform_real_distribution<double> distribution(-10.0, 10.0);
+  size_t p;
+  for (p = 0; p < cloud.size(); p += 4) {
+    cloud[p] = distribution(random);
+    cloud[p + 1] = distribution(random);
+    cloud[p + 2] = distribution(random);
+    cloud[p + 3] = 1.0;
+  }
+
+  std::printf("%d points, best of %d runs\n", pointCount, runs);
+
+  std::vector<double> exact;
+  const double exactSeconds = bestTime(cloud, exact, kTwistKernelsSSE2.twistBlock, false, runs);
+  std::printf("%-12s %9.4f s %9.1f Mpoints/s\n", "exact", exactSeconds,
+    pointCount / exactSeconds / 1e6);
+
+  const TwistKernels* kernels[] = { &kTwistKernelsSSE2, &kTwistKernelsAVX2, &kTwistKernelsAVX512 };
+  const CpuLevel machine = detectCpuLevel();
+  int level;
+  for (level = kCpuSSE2; level <= machine; level++) {
+    std::vector<double> points;
+    const double seconds = bestTime(cloud, points, kernels[level]->twistBlock, true, runs);
+    const std::string name = std::string("fast ") + cpuLevelName(static_cast<CpuLevel>(level));
+    std::printf("%-12s %9.4f s %9.1f Mpoints/s %6.2fx  max deviation %.3g\n", name.c_str(),
+      seconds, pointCount / seconds / 1e6, exactSeconds / seconds, maxDistance(points, exact));
+  }
+  return 0;
+}
@@ -0,0 +1,130 @@
+//
+//
+
+//CpuDispatch.cpp
+
+#include "CpuDispatch.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+namespace {
+
+void cpuid(unsigned int leaf, unsigned int subLeaf, unsigned int registers[4])
+//Summary:	runs the cpuid instruction; registers receives eax, ebx, ecx, edx
+{
+#if defined(_MSC_VER)
+  int values[4];
+  __cpuidex(values, static_cast<int>(leaf), static_cast<int>(subLeaf));
+  int i;
+  for (i = 0; i < 4; i++) {
+    registers[i] = static_cast<unsigned int>(values[i]);
+  }
+#else
+  __cpuid_count(leaf, subLeaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+}
+
+
+uint64_t enabledStates()
+//Summary:	returns XCR0, the register states the OS saves on a context switch
+{
+#if defined(_MSC_VER)
+  return _xgetbv(0);
+#else
+  unsigned int low, high;
+  __asm__ __volatile__("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+  return (static_cast<uint64_t>(high) << 32) | low;
+#endif
+}
+
+}
+
+
+CpuLevel detectCpuLevel()
+//Summary:	finds the highest level both the CPU and the OS support
+{
+  unsigned int registers[4];
+  cpuid(0, 0, registers);
+  const unsigned int maxLeaf = registers[0];
+  if (maxLeaf < 7) {
+    return kCpuSSE2;
+  }
+
+  cpuid(1, 0, registers);
+  const bool sse42 = 0 != (registers[2] & (1u << 20));
+  const bool osxsave = 0 != (registers[2] & (1u << 27));
+  const bool avx = 0 != (registers[2] & (1u << 28));
+  if (!sse42 || !osxsave || !avx) {
+    return kCpuSSE2;
+  }
+
+  //the OS must save the xmm and ymm registers (bits 1 and 2) for AVX2, and
+  //the opmask and zmm registers as well (bits 5 to 7) for AVX-512
+  //
+  const uint64_t states = enabledStates();
+  if (0x6 != (states & 0x6)) {
+    return kCpuSSE2;
+  }
+
+  cpuid(7, 0, registers);
+  const bool avx2 = 0 != (registers[1] & (1u << 5));
+  const bool avx512f = 0 != (registers[1] & (1u << 16));
+  if (!avx2) {
+    return kCpuSSE2;
+  }
+  if (avx512f && 0xE6 == (states & 0xE6)) {
+    return kCpuAVX512;
+  }
+  return kCpuAVX2;
+}
+
+
+CpuLevel chooseCpuLevel(bool& forced)
+//Summary:	returns the level the kernels should use: the detected one, or the
+//			level named by XC_CPU_LEVEL if that is lower
+//Args   :	forced - set to true if XC_CPU_LEVEL lowered the level
+{
+  forced = false;
+  const CpuLevel detected = detectCpuLevel();
+
+  const char* requested = getenv("XC_CPU_LEVEL");
+  if (NULL == requested) {
+    return detected;
+  }
+
+  CpuLevel level;
+  for (level = kCpuSSE2; level <= kCpuAVX512; level = static_cast<CpuLevel>(level + 1)) {
+    if (0 == strcmp(requested, cpuLevelName(level))) {
+      break;
+    }
+  }
+  if (level > kCpuAVX512 || level >= detected) {
+    return detected;
+  }
+
+  forced = true;
+  return level;
+}
+
+
+const char* cpuLevelName(CpuLevel level)
+//Summary:	returns the name XC_CPU_LEVEL uses for a level
+{
+  switch (level) {
+  case kCpuAVX512:
+    return "avx512";
+  case kCpuAVX2:
+    return "avx2";
+  default:
+    return "sse2";
+  }
+}
@@ -0,0 +1,143 @@
+//
+//
+
+//EncodePipeline.cpp
+
+#include "EncodePipeline.h"
+#include "OutputSink.h"
+
+#include <ostream>
+
+
+EncodePipeline::EncodePipeline(std::ostream& os, unsigned int threadCount) :
+  fOut(os),
+  fPool(NULL),
+  fMaxInFlight(0),
+  fFailed(false)
+  //Summary:	creates a pipeline committing to os
+  //Args   :	os - the stream finished jobs are written to, in order
+  //			threadCount - number of encoding threads; 0 encodes on the
+  //			calling thread
+{
+  if (0 != threadCount) {
+    fPool = new WorkerPool(threadCount);
+
+    //bound the number of extracted meshes waiting for their turn, so memory
+    //stays proportional to the thread count rather than the scene size
+    //
+    fMaxInFlight = 2 * static_cast<size_t>(threadCount);
+  }
+}
+
+
+EncodePipeline::~EncodePipeline()
+//Summary:	waits for running jobs and releases every job that was not
+//			committed
+{
+  delete fPool;
+
+  while (!fInFlight.empty()) {
+    Slot* slot = fInFlight.front();
+    fInFlight.pop_front();
+    slot->job->committed(false);
+    delete slot->job;
+    delete slot;
+  }
+}
+
+
+bool EncodePipeline::submit(EncodeJob* job)
+//Summary:	hands a job to the pipeline, which takes ownership of it, and
+//			commits every job at the head of the queue that has finished
+//Args   :	job - the job to encode
+//Returns:	false once any job has failed; the export should stop
+{
+  Slot* slot = new Slot;
+  slot->job = job;
+  slot->done = false;
+  slot->succeeded = false;
+  fInFlight.push_back(slot);
+
+  if (NULL == fPool) {
+    encodeSlot(slot);
+    slot->done = true;
+  }
+  else {
+    fPool->submit([this, slot]() {
+      encodeSlot(slot);
+      {
+        std::lock_guard<std::mutex> lock(fMutex);
+        slot->done = true;
+      }
+      fSlotDone.notify_all();
+    });
+  }
+
+  //write out what is already done; only block, on the oldest job, while
+  //more than fMaxInFlight jobs are queued up
+  //
+  return commit(false);
+}
+
+
+bool EncodePipeline::finish()
+//Summary:	waits for all jobs and commits them
+//Returns:	true if every job succeeded and was written
+{
+  return commit(true) && !fFailed;
+}
+
+
+void EncodePipeline::encodeSlot(Slot* slot)
+//Summary:	encodes a job into the slot's private buffer; the caller marks
+//			the slot done
+{
+  std::string bytes;
+  {
+    MemoryOutputSink sink(bytes);
+    SinkStreamBuf buffer(sink);
+    std::ostream os(&buffer);
+    slot->succeeded = slot->job->encode(os, fPool);
+    os.flush();
+    slot->succeeded = slot->succeeded && !!os;
+  }
+  slot->bytes.swap(bytes);
+}
+
+
+bool EncodePipeline::commit(bool waitForAll)
+//Summary:	writes out finished jobs from the head of the queue
+//Args   :	waitForAll - wait for every queued job instead of stopping at the
+//			first one that is still running
+//Returns:	false once any job has failed
+{
+  while (!fInFlight.empty()) {
+    Slot* slot = fInFlight.front();
+
+    if (NULL != fPool) {
+      std::unique_lock<std::mutex> lock(fMutex);
+      if (!slot->done && !waitForAll && fInFlight.size() <= fMaxInFlight) {
+        break;
+      }
+      while (!slot->done) {
+        fSlotDone.wait(lock);
+      }
+    }
+
+    fInFlight.pop_front();
+
+    if (!fFailed && slot->succeeded) {
+      fOut.write(slot->bytes.data(), static_cast<std::streamsize>(slot->bytes.size()));
+      fFailed = !fOut;
+    }
+    else {
+      fFailed = true;
+    }
+
+    slot->job->committed(!fFailed);
+    delete slot->job;
+    delete slot;
+  }
+
+  return !fFailed;
+}
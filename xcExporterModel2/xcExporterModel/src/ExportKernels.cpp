@@ -0,0 +1,38 @@
+//
+//
+
+//ExportKernels.cpp
+
+#include "ExportKernels.h"
+
+namespace {
+
+const ExportKernels* gExportKernels = &kExportKernelsSSE2;
+
+}
+
+
+const ExportKernels& exportKernels()
+//Summary:	returns the kernels installed by selectExportKernels(), the SSE2
+//			ones until then
+{
+  return *gExportKernels;
+}
+
+
+void selectExportKernels(CpuLevel level)
+//Summary:	installs the kernels compiled for the given level; called once,
+//			when the plug-in is loaded
+{
+  switch (level) {
+  case kCpuAVX512:
+    gExportKernels = &kExportKernelsAVX512;
+    break;
+  case kCpuAVX2:
+    gExportKernels = &kExportKernelsAVX2;
+    break;
+  default:
+    gExportKernels = &kExportKernelsSSE2;
+    break;
+  }
+}
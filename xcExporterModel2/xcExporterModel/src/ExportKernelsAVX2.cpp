@@ -0,0 +1,14 @@
+//
+//
+
+//ExportKernelsAVX2.cpp
+
+//the exporter kernels, compiled for kCpuAVX2; see ExportKernels.h
+
+#if !defined(__AVX2__)
+#error ExportKernelsAVX2.cpp must be compiled with AVX2 enabled
+#endif
+
+#include "ExportKernelsImpl.h"
+
+const ExportKernels kExportKernelsAVX2 = EXPORT_KERNELS;
@@ -0,0 +1,14 @@
+//
+//
+
+//ExportKernelsAVX512.cpp
+
+//the exporter kernels, compiled for kCpuAVX512; see ExportKernels.h
+
+#if !defined(__AVX512F__)
+#error ExportKernelsAVX512.cpp must be compiled with AVX-512 enabled
+#endif
+
+#include "ExportKernelsImpl.h"
+
+const ExportKernels kExportKernelsAVX512 = EXPORT_KERNELS;
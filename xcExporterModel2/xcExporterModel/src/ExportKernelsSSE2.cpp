@@ -0,0 +1,14 @@
+//
+//
+
+//ExportKernelsSSE2.cpp
+
+//the exporter kernels, compiled for kCpuSSE2; see ExportKernels.h
+
+#if defined(__AVX2__)
+#error ExportKernelsSSE2.cpp must be compiled for the SSE2 baseline
+#endif
+
+#include "ExportKernelsImpl.h"
+
+const ExportKernels kExportKernelsSSE2 = EXPORT_KERNELS;
@@ -0,0 +1,199 @@
+//
+//
+
+//ExportOptions.cpp
+
+#include "ExportOptions.h"
+
+#include "WorkerPool.h"
+
+#include <cstddef>
+#include <cstdlib>
+
+namespace {
+
+//Every option is described by its name and the member it sets; the member
+//pointer type is what makes the parser typed.
+//
+struct BoolOption {
+  const char* name;
+  bool ExportOptions::* member;
+};
+
+const BoolOption kBoolOptions[] = {
+  { "normals", &ExportOptions::normals },
+  { "uvs", &ExportOptions::uvs },
+  { "tangents", &ExportOptions::tangents },
+  { "binormals", &ExportOptions::binormals },
+  { "sets", &ExportOptions::sets },
+  { "triangulate", &ExportOptions::triangulate },
+  { "indexed", &ExportOptions::indexed },
+  { "vertexCache", &ExportOptions::vertexCache },
+  { "meshlets", &ExportOptions::meshlets },
+  { "quantize", &ExportOptions::quantize },
+  { "localSpace", &ExportOptions::localSpace },
+  { "instances", &ExportOptions::instances },
+  { "trace", &ExportOptions::trace },
+  { "report", &ExportOptions::report },
+  { "capture", &ExportOptions::capture },
+};
+
+struct IntOption {
+  const char* name;
+  int ExportOptions::* member;
+  int minimum;
+};
+
+const IntOption kIntOptions[] = {
+  { "threads", &ExportOptions::threads, -1 },
+  { "precision", &ExportOptions::precision, -1 },
+};
+
+
+std::string trim(const std::string& str)
+//Summary:	removes leading and trailing white space
+{
+  const char* whiteSpace = " \t\r\n";
+  const size_t first = str.find_first_not_of(whiteSpace);
+  if (std::string::npos == first) {
+    return std::string();
+  }
+  const size_t last = str.find_last_not_of(whiteSpace);
+  return str.substr(first, last - first + 1);
+}
+
+
+bool parseBool(const std::string& value, bool& result)
+//Summary:	converts "1"/"0", "true"/"false" or "on"/"off"
+//Returns:	false if value is none of these
+{
+  if ("1" == value || "true" == value || "on" == value) {
+    result = true;
+    return true;
+  }
+  if ("0" == value || "false" == value || "off" == value) {
+    result = false;
+    return true;
+  }
+  return false;
+}
+
+
+bool parseInt(const std::string& value, int minimum, int& result)
+//Summary:	converts a decimal integer no smaller than minimum
+//Returns:	false if value is not such an integer
+{
+  if (value.empty()) {
+    return false;
+  }
+  char* end = NULL;
+  const long parsed = strtol(value.c_str(), &end, 10);
+  if ('\0' != *end || parsed < minimum || parsed > 0x7FFFFFFF) {
+    return false;
+  }
+  result = static_cast<int>(parsed);
+  return true;
+}
+
+}
+
+
+ExportOptions::ExportOptions() :
+  normals(true),
+  uvs(true),
+  tangents(false),
+  binormals(false),
+  sets(true),
+  triangulate(false),
+  indexed(true),
+  vertexCache(false),
+  meshlets(false),
+  quantize(false),
+  localSpace(false),
+  instances(true),
+  trace(false),
+  report(false),
+  capture(false),
+  threads(-1),
+  precision(-1)
+  //Summary:	creates the default settings
+{
+}
+
+
+bool ExportOptions::parse(const std::string& optionsString, std::vector<std::string>& warnings)
+//Summary:	applies the "name=value;name=value" pairs of a translator options
+//			string on top of the current settings
+//Args   :	optionsString - the options string passed to the translator
+//			warnings - receives one message per pair that could not be applied
+//Returns:	true if every pair was applied
+{
+  bool succeeded = true;
+  size_t start = 0;
+
+  while (start <= optionsString.size()) {
+    size_t end = optionsString.find(';', start);
+    if (std::string::npos == end) {
+      end = optionsString.size();
+    }
+
+    const std::string pair = trim(optionsString.substr(start, end - start));
+    start = end + 1;
+
+    if (pair.empty()) {
+      continue;
+    }
+
+    const size_t equals = pair.find('=');
+    if (std::string::npos == equals) {
+      warnings.push_back("option \"" + pair + "\" has no value");
+      succeeded = false;
+      continue;
+    }
+
+    const std::string name = trim(pair.substr(0, equals));
+    const std::string value = trim(pair.substr(equals + 1));
+
+    bool known = false;
+    size_t i;
+    for (i = 0; i < sizeof(kBoolOptions) / sizeof(kBoolOptions[0]); i++) {
+      if (name == kBoolOptions[i].name) {
+        known = true;
+        if (!parseBool(value, this->*kBoolOptions[i].member)) {
+          warnings.push_back("option \"" + name + "\" expects 0 or 1, got \"" + value + "\"");
+          succeeded = false;
+        }
+        break;
+      }
+    }
+
+    for (i = 0; !known && i < sizeof(kIntOptions) / sizeof(kIntOptions[0]); i++) {
+      if (name == kIntOptions[i].name) {
+        known = true;
+        if (!parseInt(value, kIntOptions[i].minimum, this->*kIntOptions[i].member)) {
+          warnings.push_back("option \"" + name + "\" expects an integer, got \"" + value + "\"");
+          succeeded = false;
+        }
+      }
+    }
+
+    if (!known) {
+      warnings.push_back("unknown option \"" + name + "\"");
+      succeeded = false;
+    }
+  }
+
+  return succeeded;
+}
+
+
+unsigned int ExportOptions::encodeThreads() const
+//Summary:	resolves the threads option to an actual thread count
+//Returns:	the number of encoding threads; 0 means encode on the main thread
+{
+  if (threads >= 0) {
+    return static_cast<unsigned int>(threads);
+  }
+  const unsigned int hardware = WorkerPool::hardwareThreads();
+  return hardware > 1 ? hardware - 1 : 1;
+}
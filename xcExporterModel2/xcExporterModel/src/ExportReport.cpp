@@ -0,0 +1,95 @@
+//
+//
+
+//ExportReport.cpp
+
+#include "ExportReport.h"
+#include "JsonWriter.h"
+
+#include <cstdio>
+#include <fstream>
+
+
+void ExportReport::clear()
+//Summary:	forgets the shapes of a previous export
+{
+  fShapes.clear();
+}
+
+
+void ExportReport::add(const ShapeReport& shape)
+//Summary:	appends the accounting of one exported shape
+{
+  fShapes.push_back(shape);
+}
+
+
+size_t ExportReport::shapeCount() const
+//Summary:	returns the number of shapes added since clear()
+{
+  return fShapes.size();
+}
+
+
+bool ExportReport::write(const std::string& fileName, const std::string& exportName) const
+//Summary:	saves the report as JSON
+//Args   :	fileName - the pathname of the file to be written to
+//			exportName - the pathname of the exported file it describes
+//Returns:	true if the file was written
+{
+  std::ofstream file(fileName.c_str(), std::ios::out | std::ios::trunc);
+  if (!file) {
+    return false;
+  }
+
+  uint64_t totalBytes = 0;
+  uint64_t peakBufferBytes = 0;
+  size_t i, c;
+  for (i = 0; i < fShapes.size(); i++) {
+    for (c = 0; c < fShapes[i].channels.size(); c++) {
+      totalBytes += fShapes[i].channels[c].bytes;
+    }
+    if (fShapes[i].peakBufferBytes > peakBufferBytes) {
+      peakBufferBytes = fShapes[i].peakBufferBytes;
+    }
+  }
+
+  file << "{\n\"file\": ";
+  writeJsonString(file, exportName);
+  file << ",\n\"totalBytes\": " << totalBytes
+    << ",\n\"peakBufferBytes\": " << peakBufferBytes
+    << ",\n\"shapes\": [";
+
+  for (i = 0; i < fShapes.size(); i++) {
+    const ShapeReport& shape = fShapes[i];
+    uint64_t shapeBytes = 0;
+    for (c = 0; c < shape.channels.size(); c++) {
+      shapeBytes += shape.channels[c].bytes;
+    }
+
+    file << (0 == i ? "\n" : ",\n") << "{\"shape\": ";
+    writeJsonString(file, shape.shape);
+    file << ", \"bytes\": " << shapeBytes
+      << ", \"peakBufferBytes\": " << shape.peakBufferBytes
+      << ", \"channels\": [";
+    for (c = 0; c < shape.channels.size(); c++) {
+      const ChannelReport& channel = shape.channels[c];
+      char ratio[32];
+      snprintf(ratio, sizeof(ratio), "%.4f", 0 == channel.bytes ? 0.0 :
+        static_cast<double>(channel.rawBytes) / static_cast<double>(channel.bytes));
+
+      file << (0 == c ? "\n  " : ",\n  ") << "{\"name\": ";
+      writeJsonString(file, channel.name);
+      file << ", \"elements\": " << channel.elements
+        << ", \"bytes\": " << channel.bytes
+        << ", \"rawBytes\": " << channel.rawBytes
+        << ", \"ratio\": " << ratio << "}";
+    }
+    file << "]}";
+  }
+  file << "\n]\n}\n";
+
+  file.close();
+  return !file.fail();
+}
+
@@ -0,0 +1,121 @@
+//
+//
+
+//ExportTrace.cpp
+
+#include "ExportTrace.h"
+#include "JsonWriter.h"
+
+#include <fstream>
+
+
+ExportTrace::ExportTrace() :
+  fStart(std::chrono::steady_clock::now())
+  //Summary:	creates an empty trace
+{
+}
+
+
+void ExportTrace::start()
+//Summary:	forgets the events of a previous export and restarts the clock;
+//			the calling thread is shown as the main thread
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+  fEvents.clear();
+  fThreads.clear();
+  fThreads.push_back(std::this_thread::get_id());
+  fStart = std::chrono::steady_clock::now();
+}
+
+
+int64_t ExportTrace::now() const
+//Summary:	returns the microseconds since start()
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now() - fStart).count();
+}
+
+
+void ExportTrace::record(const char* name, const std::string& shape, int64_t begin, int64_t end)
+//Summary:	adds a finished event of the calling thread
+//Args   :	name - the phase, a string literal
+//			shape - the shape the phase worked on, empty if none
+//			begin, end - microseconds since start(), as returned by now()
+{
+  const std::thread::id id = std::this_thread::get_id();
+
+  std::lock_guard<std::mutex> lock(fMutex);
+  unsigned int thread = 0;
+  while (thread < fThreads.size() && fThreads[thread] != id) {
+    thread++;
+  }
+  if (thread == fThreads.size()) {
+    fThreads.push_back(id);
+  }
+
+  Event event;
+  event.name = name;
+  event.shape = shape;
+  event.begin = begin;
+  event.duration = end - begin;
+  event.thread = thread;
+  fEvents.push_back(event);
+}
+
+
+size_t ExportTrace::eventCount() const
+//Summary:	returns the number of events recorded since start()
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+  return fEvents.size();
+}
+
+
+bool ExportTrace::write(const std::string& fileName) const
+//Summary:	saves the events as a Trace Event Format JSON file
+//Args   :	fileName - the pathname of the file to be written to
+//Returns:	true if the file was written
+{
+  std::ofstream file(fileName.c_str(), std::ios::out | std::ios::trunc);
+  if (!file) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(fMutex);
+  file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+  //name the rows of the timeline
+  //
+  unsigned int thread;
+  for (thread = 0; thread < fThreads.size(); thread++) {
+    file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread
+      << ",\"args\":{\"name\":\"";
+    if (0 == thread) {
+      file << "Maya main thread";
+    }
+    else {
+      file << "Encoder " << thread;
+    }
+    file << "\"}},\n";
+  }
+  file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,"
+    "\"args\":{\"name\":\"Export\"}}";
+
+  size_t i;
+  for (i = 0; i < fEvents.size(); i++) {
+    const Event& event = fEvents[i];
+    file << ",\n{\"name\":\"" << event.name << "\",\"cat\":\""
+      << (event.shape.empty() ? "export" : "mesh") << "\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+      << event.thread << ",\"ts\":" << event.begin << ",\"dur\":" << event.duration;
+    if (!event.shape.empty()) {
+      file << ",\"args\":{\"shape\":";
+      writeJsonString(file, event.shape);
+      file << "}";
+    }
+    file << "}";
+  }
+  file << "\n]}\n";
+
+  file.close();
+  return !file.fail();
+}
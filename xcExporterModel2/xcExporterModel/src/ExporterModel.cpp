@@ -21,14 +21,44 @@
 #include <maya/MDagPath.h>
 #include <maya/MItSelectionList.h>
 #include <maya/MPlug.h>
+#include <maya/MObjectHandle.h>
 
 #include "ExporterModel.h"
 #include "WriterModel.h"
+#include "OutputSink.h"
+#include "EncodePipeline.h"
 
-#include <fstream>
-#include <ios>
+#include <ostream>
+#include <string>
+#include <vector>
 
-ExporterModel::ExporterModel()
+namespace {
+
+//Encodes one instance reference through the translator's writeInstance().
+//
+class InstanceJob : public EncodeJob {
+
+public:
+  InstanceJob(const ExporterModel& exporter, const InstanceRecord& instance,
+    bool (ExporterModel::*write)(std::ostream&, const InstanceRecord&) const) :
+    fExporter(exporter), fInstance(instance), fWrite(write) {}
+
+  bool encode(std::ostream& os, WorkerPool* /*pool*/) override
+  {
+    return (fExporter.*fWrite)(os, fInstance);
+  }
+
+private:
+  const ExporterModel& fExporter;
+  InstanceRecord fInstance;
+  bool (ExporterModel::*fWrite)(std::ostream&, const InstanceRecord&) const;
+};
+
+}
+
+
+ExporterModel::ExporterModel() :
+  fPipeline(NULL)
 {
   //Summary:  constructor method; does nothing
 }
@@ -42,7 +72,7 @@ ExporterModel::~ExporterModel()
 
 
 MStatus ExporterModel::writer(const MFileObject& file,
-  const MString& /*options*/,
+  const MString& options,
   MPxFileTranslator::FileAccessMode mode)
   //Summary:	saves a file of a type supported by this translator by traversing
   //			the all or selected objects (depending on mode) in the current
@@ -56,41 +86,212 @@ MStatus ExporterModel::writer(const MFileObject& file,
 {
   const MString fileName = file.expandedFullName();
 
-  std::ofstream newFile(fileName.asChar(), std::ios::out);
-  if (!newFile) {
+  //start every export from the translator's defaults so that settings of a
+  //previous export do not leak into this one
+  //
+  fOptions = defaultOptions();
+  std::vector<std::string> warnings;
+  fOptions.parse(options.asChar(), warnings);
+  size_t i;
+  for (i = 0; i < warnings.size(); i++) {
+    MGlobal::displayWarning(MString("Export options: ") + warnings[i].c_str());
+  }
+
+  if (fOptions.trace) {
+    fTrace.start();
+  }
+  fReport.clear();
+  if (fOptions.capture) {
+    openCapture(fileName);
+  }
+
+  MStatus status;
+  {
+    TraceScope scope(trace(), "writer");
+    status = writeFile(fileName, mode);
+  }
+
+  if (fOptions.trace) {
+    writeTrace(fileName);
+  }
+
+  //a partial report would understate the export, so it is only written
+  //for a complete file
+  //
+  if (fOptions.report && MStatus::kSuccess == status) {
+    writeReport(fileName);
+  }
+  fReport.clear();
+
+  //the meshes captured so far are worth keeping even if the export failed
+  //
+  if (fCapture.isOpen()) {
+    closeCapture(fileName);
+  }
+  return status;
+}
+
+
+MStatus ExporterModel::writeFile(const MString& fileName,
+  MPxFileTranslator::FileAccessMode mode)
+  //Summary:	writes the meshes chosen by mode to the given file
+  //Args   :	fileName - the pathname of the file to be written to
+  //			mode - export or export active
+  //Returns:	MStatus::kSuccess if the export was successful;
+  //			MStatus::kFailure otherwise
+{
+  //all output goes through a buffered sink; data only reaches the OS when the
+  //sink's buffer fills up or at the explicit flush at the end of the export
+  //
+  FileOutputSink sink(fileName.asChar(), isBinary());
+  if (!sink.isOpen()) {
     MGlobal::displayError(fileName + ": could not be opened for reading");
     return MS::kFailure;
   }
-  newFile.setf(std::ios::unitbuf);
+  SinkStreamBuf buffer(sink);
+  std::ostream newFile(&buffer);
 
   writeHeader(newFile);
 
+  //meshes are extracted here on the main thread and encoded by the
+  //pipeline's worker threads; the pipeline writes them in the order they
+  //were submitted, so the file does not depend on the thread count
+  //
+  EncodePipeline pipeline(newFile, fOptions.encodeThreads());
+  fPipeline = &pipeline;
+  fInstanceSources.clear();
+  fShaderCache.clear();
+
   //check which objects are to be exported, and invoke the corresponding
   //methods; only 'export all' and 'export selection' are allowed
   //
+  MStatus status = MStatus::kFailure;
   if (MPxFileTranslator::kExportAccessMode == mode) {
-    if (MStatus::kFailure == exportAll(newFile)) {
-      return MStatus::kFailure;
-    }
+    status = exportAll(newFile);
   }
   else if (MPxFileTranslator::kExportActiveAccessMode == mode) {
-    if (MStatus::kFailure == exportSelection(newFile)) {
-      return MStatus::kFailure;
-    }
+    status = exportSelection(newFile);
   }
-  else {
+
+  fInstanceSources.clear();
+  fShaderCache.clear();
+  bool finished;
+  {
+    //waits for the encoders still busy with the last meshes
+    //
+    TraceScope scope(trace(), "finishPipeline");
+    finished = MStatus::kFailure != status && pipeline.finish();
+  }
+  fPipeline = NULL;
+  if (!finished) {
     return MStatus::kFailure;
   }
 
   writeFooter(newFile);
   newFile.flush();
-  newFile.close();
+  if (!newFile || !sink.close()) {
+    MGlobal::displayError(fileName + ": could not be written");
+    return MS::kFailure;
+  }
 
   MGlobal::displayInfo("Export to " + fileName + " successful!");
   return MS::kSuccess;
 }
 
 
+void ExporterModel::writeTrace(const MString& fileName)
+//Summary:	saves the phase timings of the export next to the exported file,
+//			as <file>.trace.json
+//Args   :	fileName - the pathname of the exported file
+{
+  const MString traceName = fileName + ".trace.json";
+  if (fTrace.write(traceName.asChar())) {
+    MString message("Export trace of ");
+    message += static_cast<unsigned int>(fTrace.eventCount());
+    message += " events written to ";
+    message += traceName;
+    MGlobal::displayInfo(message);
+  }
+  else {
+    MGlobal::displayWarning(traceName + ": could not be written");
+  }
+}
+
+
+void ExporterModel::writeReport(const MString& fileName)
+//Summary:	saves the byte and memory accounting of the export next to the
+//			exported file, as <file>.report.json
+//Args   :	fileName - the pathname of the exported file
+{
+  const MString reportName = fileName + ".report.json";
+  if (fReport.write(reportName.asChar(), fileName.asChar())) {
+    MString message("Export report of ");
+    message += static_cast<unsigned int>(fReport.shapeCount());
+    message += " shapes written to ";
+    message += reportName;
+    MGlobal::displayInfo(message);
+  }
+  else {
+    MGlobal::displayWarning(reportName + ": could not be written");
+  }
+}
+
+
+void ExporterModel::openCapture(const MString& fileName)
+//Summary:	creates the capture file every mesh of the export is saved to as
+//			it is extracted, next to the exported file, as <file>.xcap
+//Args   :	fileName - the pathname of the exported file
+{
+  const MString captureName = fileName + ".xcap";
+  if (!fCapture.open(captureName.asChar())) {
+    MGlobal::displayWarning(captureName + ": could not be opened for writing");
+  }
+}
+
+
+void ExporterModel::closeCapture(const MString& fileName)
+//Summary:	terminates the capture file opened by openCapture()
+//Args   :	fileName - the pathname of the exported file
+{
+  const MString captureName = fileName + ".xcap";
+  const size_t meshCount = fCapture.meshCount();
+  if (fCapture.close()) {
+    MString message("Capture of ");
+    message += static_cast<unsigned int>(meshCount);
+    message += " meshes written to ";
+    message += captureName;
+    MGlobal::displayInfo(message);
+  }
+  else {
+    MGlobal::displayWarning(captureName + ": could not be written");
+  }
+}
+
+
+ExportTrace* ExporterModel::trace()
+//Summary:	returns the trace phases are recorded into, or NULL if the
+//			current export is not traced
+{
+  return fOptions.trace ? &fTrace : NULL;
+}
+
+
+ExportReport* ExporterModel::report()
+//Summary:	returns the report shapes are accounted in, or NULL if the
+//			current export has none
+{
+  return fOptions.report ? &fReport : NULL;
+}
+
+
+CaptureWriter* ExporterModel::capture()
+//Summary:	returns the capture file extracted meshes are saved to, or NULL
+//			if the current export captures nothing
+{
+  return fCapture.isOpen() ? &fCapture : NULL;
+}
+
+
 bool ExporterModel::haveWriteMethod() const
 //Summary:	returns true if the writer() method of the class is implemented;
 //			false otherwise
@@ -100,6 +301,23 @@ bool ExporterModel::haveWriteMethod() const
 }
 
 
+ExportOptions ExporterModel::defaultOptions() const
+//Summary:	returns the settings used for every option the options string
+//			does not mention
+{
+  return ExportOptions();
+}
+
+
+bool ExporterModel::isBinary() const
+//Summary:	returns true if the format must be written without newline
+//			translation
+//Returns:  false; text formats are written in text mode
+{
+  return false;
+}
+
+
 bool ExporterModel::haveReadMethod() const
 //Summary:	returns true if the reader() method of the class is implemented;
 //			false otherwise
@@ -128,6 +346,7 @@ MStatus ExporterModel::exportAll(std::ostream& os)
 
   //create an iterator for only the mesh components of the DAG
   //
+  TraceScope scope(trace(), "exportAll");
   MItDag itDag(MItDag::kDepthFirst, MFn::kMesh, &status);
 
   if (MStatus::kFailure == status) {
@@ -165,6 +384,7 @@ MStatus ExporterModel::exportSelection(std::ostream& os)
 //			MStatus::kFailure if the method fails
 {
   MStatus status;
+  TraceScope scope(trace(), "exportSelection");
 
   //create an iterator for the selected mesh components of the DAG
   //
@@ -199,31 +419,112 @@ MStatus ExporterModel::exportSelection(std::ostream& os)
 
 MStatus ExporterModel::processPolyMesh(const MDagPath dagPath, std::ostream& os)
 //Summary:	processes the mesh on the given dag path by extracting its geometry
-//			and writing this data to file
+//			and handing the writer to the pipeline, which writes this data to
+//			file once it is encoded
 //Args   :	dagPath - the current dag path whose poly mesh is to be processed
-//			os - an output stream to write to
+//			os - an output stream to write to; used directly only when no
+//				 pipeline is running
 //Returns:	MStatus::kSuccess if the polygonal mesh data was processed fully;
 //			MStatus::kFailure otherwise
 {
   MStatus status;
+  TraceScope scope(trace(), "processPolyMesh", dagPath.partialPathName().asChar());
+
+  //further instances of a shape that was already exported only need their
+  //matrix
+  //
+  InstanceRecord instance;
+  if (findInstanceSource(dagPath, instance)) {
+    MGlobal::displayInfo(MString("Exporting ") + instance.name.c_str() +
+      " as an instance of " + instance.sourceName.c_str());
+    if (NULL == fPipeline) {
+      return writeInstance(os, instance) ? MStatus::kSuccess : MStatus::kFailure;
+    }
+    if (!fPipeline->submit(new InstanceJob(*this, instance, &ExporterModel::writeInstance))) {
+      return MStatus::kFailure;
+    }
+    return MStatus::kSuccess;
+  }
+
   WriterModel* pWriter = createPolyWriter(dagPath, status);
   if (MStatus::kFailure == status) {
     delete pWriter;
     return MStatus::kFailure;
   }
+  pWriter->setShaderCache(&fShaderCache);
+  pWriter->setTrace(trace());
+  pWriter->setReport(report());
+  pWriter->setCapture(capture());
   if (MStatus::kFailure == pWriter->extractGeometry()) {
     delete pWriter;
     return MStatus::kFailure;
   }
-  if (MStatus::kFailure == pWriter->writeToFile(os)) {
+
+  if (NULL == fPipeline) {
+    status = pWriter->writeToFile(os);
+    pWriter->committed(MStatus::kSuccess == status);
     delete pWriter;
+    return status;
+  }
+
+  //the pipeline owns the writer from here on
+  //
+  if (!fPipeline->submit(pWriter)) {
     return MStatus::kFailure;
   }
-  delete pWriter;
   return MStatus::kSuccess;
 }
 
 
+bool ExporterModel::findInstanceSource(const MDagPath& dagPath, InstanceRecord& instance)
+//Summary:	looks up whether the shape on the given path was already exported
+//			through another instance.  The first instance of every shape is
+//			remembered, so that it is exported in full.
+//Args   :	dagPath - the current dag path
+//			instance - receives the reference to write, if any
+//Returns:	true if dagPath must be written as a reference to instance
+{
+  if (!fOptions.instances || !dagPath.isInstanced()) {
+    return false;
+  }
+
+  //selected paths may end at the transform
+  //
+  MDagPath shapePath(dagPath);
+  shapePath.extendToShape();
+
+  MObject shape = shapePath.node();
+  const unsigned int hash = MObjectHandle(shape).hashCode();
+
+  auto range = fInstanceSources.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second.shape == shape) {
+      const InstanceSource& source = it->second;
+      const MMatrix worldMatrix = shapePath.inclusiveMatrix();
+
+      //world space source geometry is taken back to object space and out
+      //through this instance's transforms; local space geometry only needs
+      //the latter
+      //
+      const MMatrix relativeMatrix = source.inverseMatrix * worldMatrix;
+
+      instance.name = shapePath.partialPathName().asChar();
+      instance.sourceName = source.name.asChar();
+      worldMatrix.get(instance.worldMatrix);
+      relativeMatrix.get(instance.relativeMatrix);
+      return true;
+    }
+  }
+
+  InstanceSource source;
+  source.shape = shape;
+  source.name = shapePath.partialPathName();
+  source.inverseMatrix = fOptions.localSpace ? MMatrix::identity : shapePath.inclusiveMatrixInverse();
+  fInstanceSources.insert(std::make_pair(hash, source));
+  return false;
+}
+
+
 bool ExporterModel::isVisible(MFnDagNode& fnDag, MStatus& status)
 //Summary:	determines if the given DAG node is currently visible
 //Args   :	fnDag - the DAG node to check
@@ -0,0 +1,33 @@
+//
+//
+
+//JsonWriter.cpp
+
+#include "JsonWriter.h"
+
+#include <cstdio>
+#include <ostream>
+
+
+void writeJsonString(std::ostream& os, const std::string& text)
+//Summary:	writes text as a quoted JSON string, escaping quotes, backslashes
+//			and control characters
+{
+  os << '"';
+  size_t i;
+  for (i = 0; i < text.size(); i++) {
+    const unsigned char c = static_cast<unsigned char>(text[i]);
+    if ('"' == c || '\\' == c) {
+      os << '\\' << static_cast<char>(c);
+    }
+    else if (c < 0x20) {
+      char escaped[8];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      os << escaped;
+    }
+    else {
+      os << static_cast<char>(c);
+    }
+  }
+  os << '"';
+}
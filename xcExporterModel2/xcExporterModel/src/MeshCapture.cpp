@@ -0,0 +1,473 @@
+//
+//
+
+//MeshCapture.cpp
+
+#include "MeshCapture.h"
+
+#include <algorithm>
+#include <istream>
+#include <ostream>
+
+namespace {
+
+void writeStream(std::ostream& os, uint32_t id, const Float3Stream& stream)
+//Summary:	writes a snapshot stream as a chunk of (x, y, z) triples
+{
+  std::vector<float> xyz;
+  stream.interleave(xyz);
+  xcb::writeChunk(os, id, static_cast<uint32_t>(stream.length()),
+    xyz.empty() ? NULL : &xyz[0], xyz.size() * sizeof(float));
+}
+
+
+void writeInts(std::ostream& os, uint32_t id, const std::vector<int>& values, size_t perElement)
+//Summary:	writes an index array as a chunk of perElement indices per element
+{
+  xcb::writeChunk(os, id, static_cast<uint32_t>(values.size() / perElement),
+    values.empty() ? NULL : &values[0], values.size() * sizeof(int));
+}
+
+
+void writeString(std::ostream& os, uint32_t id, const std::string& str)
+{
+  xcb::writeStringChunk(os, id, str.c_str(), str.size());
+}
+
+
+bool readPayload(std::istream& is, const xcb::ChunkHeader& header, void* data)
+//Summary:	reads the payload of the chunk whose header was just read into
+//			data, which must hold header.size bytes, and skips its padding
+//Returns:	false if the file ends before the next chunk
+{
+  if (0 != header.size) {
+    is.read(static_cast<char*>(data), static_cast<std::streamsize>(header.size));
+  }
+  const uint64_t remainder = header.size % xcb::kAlignment;
+  if (0 != remainder) {
+    is.ignore(static_cast<std::streamsize>(xcb::kAlignment - remainder));
+  }
+  return !is.fail();
+}
+
+
+bool skipPayload(std::istream& is, const xcb::ChunkHeader& header)
+{
+  const uint64_t padded = (header.size + xcb::kAlignment - 1) / xcb::kAlignment * xcb::kAlignment;
+  is.seekg(static_cast<std::streamoff>(padded), std::ios::cur);
+  return !is.fail();
+}
+
+
+template <class Array>
+bool readArray(std::istream& is, const xcb::ChunkHeader& header, Array& array)
+//Summary:	reads the payload of the current chunk into array
+//Returns:	false if the payload is not a whole number of elements or is
+//			cut short
+{
+  typedef typename Array::value_type Value;
+  if (0 != header.size % sizeof(Value)) {
+    return false;
+  }
+  array.resize(static_cast<size_t>(header.size / sizeof(Value)));
+  return readPayload(is, header, array.empty() ? NULL : &array[0]);
+}
+
+
+bool readString(std::istream& is, const xcb::ChunkHeader& header, std::string& str)
+{
+  std::vector<char> chars;
+  if (!readArray(is, header, chars)) {
+    return false;
+  }
+  str.assign(chars.begin(), chars.end());
+  return true;
+}
+
+
+bool readStream(std::istream& is, const xcb::ChunkHeader& header, Float3Stream& stream)
+//Summary:	reads a chunk of (x, y, z) triples into a snapshot stream
+{
+  std::vector<float> xyz;
+  if (!readArray(is, header, xyz) || 0 != xyz.size() % 3) {
+    return false;
+  }
+  stream.deinterleave(xyz);
+  return true;
+}
+
+
+bool readUVs(std::istream& is, const xcb::ChunkHeader& header, CapturedUVSet& uvSet)
+//Summary:	reads a chunk of (u, v) pairs into the streams of a uv set
+{
+  std::vector<float> uv;
+  if (!readArray(is, header, uv) || 0 != uv.size() % 2) {
+    return false;
+  }
+  const size_t count = uv.size() / 2;
+  uvSet.u.resize(count);
+  uvSet.v.resize(count);
+  size_t i;
+  for (i = 0; i < count; i++) {
+    uvSet.u[i] = uv[2 * i];
+    uvSet.v[i] = uv[2 * i + 1];
+  }
+  return true;
+}
+
+
+bool checkIndices(const std::vector<int>& indices, size_t limit, bool unassigned)
+//Summary:	checks that every index is below limit; -1 is allowed if
+//			unassigned is set
+{
+  size_t i;
+  for (i = 0; i < indices.size(); i++) {
+    const int index = indices[i];
+    if (index < 0 ? !(unassigned && -1 == index) : static_cast<size_t>(index) >= limit) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+bool checkFaceRanges(const std::vector<uint32_t>& ranges, size_t faceCount)
+//Summary:	checks that ranges holds (start, count) pairs of faces below
+//			faceCount, without relying on start + count not to wrap
+{
+  if (0 != ranges.size() % 2) {
+    return false;
+  }
+  size_t r;
+  for (r = 0; r < ranges.size(); r += 2) {
+    if (ranges[r] > faceCount || ranges[r + 1] > faceCount - ranges[r]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+bool checkCapture(const MeshCapture& capture, std::string& error)
+//Summary:	checks that the arrays of a capture fit together, so that the
+//			writers can index them without checks of their own
+//Args   :	error - set to what does not fit
+{
+  const size_t faceCount = capture.faceCount();
+  const size_t faceVertexCount = capture.faceVertexIds.size();
+  const MeshSnapshot& snapshot = capture.snapshot;
+
+  size_t faceVertices = 0;
+  size_t triangles = 0;
+  size_t i;
+  for (i = 0; i < faceCount; i++) {
+    faceVertices += static_cast<size_t>(std::max(capture.faceVertexCounts[i], 0));
+  }
+  for (i = 0; i < capture.triangleCounts.size(); i++) {
+    triangles += static_cast<size_t>(std::max(capture.triangleCounts[i], 0));
+  }
+
+  if (faceVertices != faceVertexCount) {
+    error = "face vertex counts do not add up to the face vertices";
+  }
+  else if (!checkIndices(capture.faceVertexIds, snapshot.positions.length(), false)) {
+    error = "face vertex out of range";
+  }
+  else if (!capture.faceNormalIds.empty() &&
+           (capture.faceNormalIds.size() != faceVertexCount ||
+            !checkIndices(capture.faceNormalIds, snapshot.normals.length(), false))) {
+    error = "face normals do not match the face vertices";
+  }
+  else if (capture.triangleCounts.size() != faceCount ||
+           3 * triangles != capture.triangleVertices.size() ||
+           !checkIndices(capture.triangleVertices, faceVertexCount, false)) {
+    error = "triangulation does not match the faces";
+  }
+  else if (snapshot.binormals.length() != 0 &&
+           snapshot.binormals.length() != snapshot.tangents.length()) {
+    error = "tangents and binormals differ in length";
+  }
+
+  for (i = 0; error.empty() && i < capture.uvSets.size(); i++) {
+    const CapturedUVSet& uvSet = capture.uvSets[i];
+    if (uvSet.u.size() != uvSet.v.size() || uvSet.faceUVIds.size() != faceVertexCount ||
+        !checkIndices(uvSet.faceUVIds, uvSet.u.size(), true)) {
+      error = "uv set " + uvSet.name + " does not match the face vertices";
+    }
+  }
+  for (i = 0; error.empty() && i < capture.sets.size(); i++) {
+    if (!checkFaceRanges(capture.sets[i].faceRanges, faceCount)) {
+      error = "set " + capture.sets[i].name + " has face ranges out of range";
+    }
+  }
+
+  if (!error.empty()) {
+    error = capture.shape + ": " + error;
+    return false;
+  }
+  return true;
+}
+
+}
+
+
+MeshCapture::MeshCapture() :
+  localSpace(false)
+  //Summary:	creates an empty capture with an identity world matrix
+{
+  int i, j;
+  for (i = 0; i < 4; i++) {
+    for (j = 0; j < 4; j++) {
+      worldMatrix[i][j] = i == j ? 1.0 : 0.0;
+    }
+  }
+}
+
+
+CaptureWriter::CaptureWriter() :
+  fMeshCount(0)
+{
+}
+
+
+bool CaptureWriter::open(const std::string& fileName)
+//Summary:	creates the capture file and writes its header
+//Returns:	false if the file could not be created
+{
+  fMeshCount = 0;
+  fFile.open(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!fFile.is_open()) {
+    return false;
+  }
+
+  xcb::FileHeader header;
+  header.magic = xcap::kMagic;
+  header.version = xcap::kVersion;
+  header.alignment = xcb::kAlignment;
+  header.reserved = 0;
+  fFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  return !fFile.fail();
+}
+
+
+bool CaptureWriter::isOpen() const
+{
+  return fFile.is_open();
+}
+
+
+void CaptureWriter::write(const MeshCapture& capture)
+//Summary:	appends a mesh to the capture file; channels the capture does
+//			not hold are left out
+{
+  std::ostream& os = fFile;
+  const MeshSnapshot& snapshot = capture.snapshot;
+
+  writeString(os, xcb::kShape, capture.shape);
+  const uint32_t space = capture.localSpace ? 1 : 0;
+  xcb::writeChunk(os, xcap::kCaptureSpace, 1, &space, sizeof(space));
+  xcb::writeChunk(os, xcb::kWorldMatrix, 16, capture.worldMatrix, sizeof(capture.worldMatrix));
+
+  writeStream(os, xcb::kPositions, snapshot.positions);
+  if (0 != snapshot.normals.length()) {
+    writeStream(os, xcb::kNormals, snapshot.normals);
+  }
+  if (0 != snapshot.tangents.length()) {
+    writeStream(os, xcb::kTangents, snapshot.tangents);
+  }
+  if (0 != snapshot.binormals.length()) {
+    writeStream(os, xcb::kBinormals, snapshot.binormals);
+  }
+
+  writeInts(os, xcb::kFaceCounts, capture.faceVertexCounts, 1);
+  writeInts(os, xcb::kFacePositions, capture.faceVertexIds, 1);
+  if (!capture.faceNormalIds.empty()) {
+    writeInts(os, xcb::kFaceNormals, capture.faceNormalIds, 1);
+  }
+  writeInts(os, xcap::kTriangleCounts, capture.triangleCounts, 1);
+  writeInts(os, xcap::kTriangleVertices, capture.triangleVertices, 3);
+
+  if (!capture.currentUVSetName.empty()) {
+    writeString(os, xcap::kCurrentUVSet, capture.currentUVSetName);
+  }
+
+  size_t i, j;
+  for (i = 0; i < capture.uvSets.size(); i++) {
+    const CapturedUVSet& uvSet = capture.uvSets[i];
+    std::vector<float> uv(2 * uvSet.u.size());
+    for (j = 0; j < uvSet.u.size(); j++) {
+      uv[2 * j] = uvSet.u[j];
+      uv[2 * j + 1] = uvSet.v[j];
+    }
+    writeString(os, xcb::kUVSetName, uvSet.name);
+    xcb::writeChunk(os, xcb::kUVs, static_cast<uint32_t>(uvSet.u.size()),
+      uv.empty() ? NULL : &uv[0], uv.size() * sizeof(float));
+    writeInts(os, xcb::kFaceUVs, uvSet.faceUVIds, 1);
+  }
+
+  for (i = 0; i < capture.sets.size(); i++) {
+    const CapturedSet& set = capture.sets[i];
+    writeString(os, xcb::kSetName, set.name);
+    writeString(os, xcb::kSetTexture, set.texture);
+    xcb::writeChunk(os, xcb::kSetFaceRanges, static_cast<uint32_t>(set.faceRanges.size() / 2),
+      set.faceRanges.empty() ? NULL : &set.faceRanges[0], set.faceRanges.size() * sizeof(uint32_t));
+  }
+
+  fMeshCount++;
+}
+
+
+bool CaptureWriter::close()
+//Summary:	terminates and closes the capture file
+//Returns:	false if anything could not be written
+{
+  xcb::writeChunk(fFile, xcb::kEnd, 0, NULL, 0);
+  fFile.close();
+  return !fFile.fail();
+}
+
+
+size_t CaptureWriter::meshCount() const
+{
+  return fMeshCount;
+}
+
+
+bool readCaptureFile(const std::string& fileName, std::vector<MeshCapture>& captures,
+                     std::string& error)
+//Summary:	reads every mesh of a capture file.  Chunks this version does not
+//			know are skipped.
+//Args   :	fileName - the capture file
+//			captures - receives the meshes, in the order they were captured
+//			error - set to what went wrong if the file cannot be read
+//Returns:	false if the file could not be opened, is not a capture file or
+//			is malformed
+{
+  std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+  if (!file.is_open()) {
+    error = fileName + ": could not be opened for reading";
+    return false;
+  }
+
+  xcb::FileHeader fileHeader;
+  file.read(reinterpret_cast<char*>(&fileHeader), sizeof(fileHeader));
+  if (file.fail() || xcap::kMagic != fileHeader.magic) {
+    error = fileName + ": not a capture file";
+    return false;
+  }
+  if (xcap::kVersion != fileHeader.version) {
+    error = fileName + ": capture version " + std::to_string(fileHeader.version) +
+      " is not supported";
+    return false;
+  }
+
+  const size_t first = captures.size();
+  for (;;) {
+    xcb::ChunkHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (file.fail()) {
+      error = fileName + ": ends without an end chunk";
+      return false;
+    }
+
+    if (xcb::kEnd == header.id) {
+      break;
+    }
+    if (xcb::kShape == header.id) {
+      captures.push_back(MeshCapture());
+      if (!readString(file, header, captures.back().shape)) {
+        error = fileName + ": truncated shape name";
+        return false;
+      }
+      continue;
+    }
+    if (first == captures.size()) {
+      error = fileName + ": data before the first shape";
+      return false;
+    }
+
+    MeshCapture& capture = captures.back();
+    MeshSnapshot& snapshot = capture.snapshot;
+    bool read = false;
+    switch (header.id) {
+    case xcap::kCaptureSpace: {
+      uint32_t space = 0;
+      read = sizeof(space) == header.size && readPayload(file, header, &space);
+      capture.localSpace = 0 != space;
+      break;
+    }
+    case xcb::kWorldMatrix:
+      read = sizeof(capture.worldMatrix) == header.size && readPayload(file, header, capture.worldMatrix);
+      break;
+    case xcb::kPositions:
+      read = readStream(file, header, snapshot.positions);
+      break;
+    case xcb::kNormals:
+      read = readStream(file, header, snapshot.normals);
+      break;
+    case xcb::kTangents:
+      read = readStream(file, header, snapshot.tangents);
+      break;
+    case xcb::kBinormals:
+      read = readStream(file, header, snapshot.binormals);
+      break;
+    case xcb::kFaceCounts:
+      read = readArray(file, header, capture.faceVertexCounts);
+      break;
+    case xcb::kFacePositions:
+      read = readArray(file, header, capture.faceVertexIds);
+      break;
+    case xcb::kFaceNormals:
+      read = readArray(file, header, capture.faceNormalIds);
+      break;
+    case xcap::kTriangleCounts:
+      read = readArray(file, header, capture.triangleCounts);
+      break;
+    case xcap::kTriangleVertices:
+      read = readArray(file, header, capture.triangleVertices);
+      break;
+    case xcap::kCurrentUVSet:
+      read = readString(file, header, capture.currentUVSetName);
+      break;
+    case xcb::kUVSetName:
+      capture.uvSets.push_back(CapturedUVSet());
+      read = readString(file, header, capture.uvSets.back().name);
+      break;
+    case xcb::kUVs:
+      read = !capture.uvSets.empty() && readUVs(file, header, capture.uvSets.back());
+      break;
+    case xcb::kFaceUVs:
+      read = !capture.uvSets.empty() && readArray(file, header, capture.uvSets.back().faceUVIds);
+      break;
+    case xcb::kSetName:
+      capture.sets.push_back(CapturedSet());
+      read = readString(file, header, capture.sets.back().name);
+      break;
+    case xcb::kSetTexture:
+      read = !capture.sets.empty() && readString(file, header, capture.sets.back().texture);
+      break;
+    case xcb::kSetFaceRanges:
+      read = !capture.sets.empty() && readArray(file, header, capture.sets.back().faceRanges);
+      break;
+    default:
+      read = skipPayload(file, header);
+      break;
+    }
+
+    if (!read) {
+      const char id[5] = { static_cast<char>(header.id), static_cast<char>(header.id >> 8),
+        static_cast<char>(header.id >> 16), static_cast<char>(header.id >> 24), '\0' };
+      error = fileName + ": malformed " + id + " chunk in " + capture.shape;
+      return false;
+    }
+  }
+
+  size_t i;
+  for (i = first; i < captures.size(); i++) {
+    if (!checkCapture(captures[i], error)) {
+      error = fileName + ": " + error;
+      return false;
+    }
+  }
+  return true;
+}
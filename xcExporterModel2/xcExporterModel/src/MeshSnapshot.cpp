@@ -0,0 +1,51 @@
+//
+//
+
+//MeshSnapshot.cpp
+
+#include "MeshSnapshot.h"
+#include "ExportKernels.h"
+
+
+void Float3Stream::resize(size_t count)
+//Summary:	sets the number of vectors in the stream
+{
+  x.resize(count);
+  y.resize(count);
+  z.resize(count);
+}
+
+
+void Float3Stream::clear()
+//Summary:	removes every vector and releases the memory of the stream
+{
+  FloatStream().swap(x);
+  FloatStream().swap(y);
+  FloatStream().swap(z);
+}
+
+
+void Float3Stream::interleave(std::vector<float>& xyz) const
+//Summary:	writes the stream as (x, y, z) triples, the layout of the xcb
+//			vector chunks
+//Args   :	xyz - set to 3 * length() floats
+{
+  const size_t count = length();
+  xyz.resize(3 * count);
+  if (0 != count) {
+    exportKernels().mergeFloat3(&x[0], &y[0], &z[0], &xyz[0], count);
+  }
+}
+
+
+void Float3Stream::deinterleave(const std::vector<float>& xyz)
+//Summary:	sets the stream from (x, y, z) triples, the inverse of
+//			interleave()
+//Args   :	xyz - 3 * N floats; the stream is set to N vectors
+{
+  const size_t count = xyz.size() / 3;
+  resize(count);
+  if (0 != count) {
+    exportKernels().splitFloat3(&xyz[0], &x[0], &y[0], &z[0], count);
+  }
+}
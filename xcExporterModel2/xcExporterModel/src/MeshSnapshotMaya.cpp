@@ -0,0 +1,93 @@
+//
+//
+
+//MeshSnapshotMaya.cpp
+
+//The conversions of MeshSnapshot from the Maya arrays
+//
+
+#include <maya/MPointArray.h>
+#include <maya/MFloatVectorArray.h>
+#include <maya/MFloatArray.h>
+#include <maya/MMatrix.h>
+
+#include "MeshSnapshot.h"
+#include "ExportKernels.h"
+
+
+void snapshotPoints(const MPointArray& points, Float3Stream& stream)
+//Summary:	rounds points to float32 streams
+//Args   :	points - the points; only x, y and z are kept
+//			stream - set to one vector per point
+{
+  const size_t count = points.length();
+  stream.resize(count);
+  if (0 != count) {
+    //MPointArray stores its points as contiguous (x, y, z, w) doubles
+    //
+    exportKernels().pointsToFloats(&points[0].x, &stream.x[0], &stream.y[0], &stream.z[0], count);
+  }
+}
+
+
+void snapshotPoints(const MPointArray& points, const MMatrix& matrix, Float3Stream& stream)
+//Summary:	transforms points and rounds them to float32 streams
+//Args   :	points - the points
+//			matrix - the transform, in Maya's row vector convention
+//			stream - set to one transformed vector per point
+{
+  const size_t count = points.length();
+  stream.resize(count);
+  if (0 != count) {
+    double elements[4][4];
+    matrix.get(elements);
+    exportKernels().transformPoints(&points[0].x, &elements[0][0],
+      &stream.x[0], &stream.y[0], &stream.z[0], count);
+  }
+}
+
+
+void transformStream(Float3Stream& stream, const MMatrix& matrix)
+//Summary:	transforms a stream of directions by the upper 3x3 of matrix and
+//			renormalizes them
+//Args   :	matrix - the transform, in Maya's row vector convention; normals
+//			need the inverse transpose of the one of the points
+{
+  const size_t count = stream.length();
+  if (0 != count) {
+    float elements[9];
+    int i, j;
+    for (i = 0; i < 3; i++) {
+      for (j = 0; j < 3; j++) {
+        elements[3 * i + j] = static_cast<float>(matrix(i, j));
+      }
+    }
+    exportKernels().transformVectors(&stream.x[0], &stream.y[0], &stream.z[0], count, elements);
+  }
+}
+
+
+void snapshotVectors(const MFloatVectorArray& vectors, Float3Stream& stream)
+//Summary:	splits vectors into float32 streams
+//Args   :	vectors - the vectors
+//			stream - set to one vector per element of vectors
+{
+  const size_t count = vectors.length();
+  stream.resize(count);
+  if (0 != count) {
+    //MFloatVectorArray stores its vectors as contiguous (x, y, z) floats
+    //
+    exportKernels().splitFloat3(&vectors[0].x, &stream.x[0], &stream.y[0], &stream.z[0], count);
+  }
+}
+
+
+void snapshotFloats(const MFloatArray& values, FloatStream& stream)
+//Summary:	copies values into a float32 stream
+{
+  const unsigned int count = values.length();
+  stream.resize(count);
+  if (0 != count) {
+    values.get(&stream[0]);
+  }
+}
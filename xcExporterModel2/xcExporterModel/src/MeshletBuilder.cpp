@@ -0,0 +1,231 @@
+//
+//
+
+//MeshletBuilder.cpp
+
+#include "MeshletBuilder.h"
+
+#include <cmath>
+
+namespace {
+
+const uint8_t kNotInMeshlet = 0xFF;
+
+//below this, the triangles of a meshlet spread over more than about 84
+//degrees and a cone around them would hardly ever cull anything
+//
+const float kMinConeDot = 0.1f;
+
+
+struct Vector3 {
+  float x, y, z;
+};
+
+Vector3 position(const float* vertices, unsigned int stride, uint32_t vertex)
+{
+  const float* p = vertices + static_cast<size_t>(vertex) * stride;
+  Vector3 v = { p[0], p[1], p[2] };
+  return v;
+}
+
+Vector3 subtract(const Vector3& a, const Vector3& b)
+{
+  Vector3 v = { a.x - b.x, a.y - b.y, a.z - b.z };
+  return v;
+}
+
+float dot(const Vector3& a, const Vector3& b)
+{
+  return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+Vector3 cross(const Vector3& a, const Vector3& b)
+{
+  Vector3 v = { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+  return v;
+}
+
+bool normalize(Vector3& v)
+{
+  const float length = sqrtf(dot(v, v));
+  if (0.0f == length) {
+    return false;
+  }
+  v.x /= length;
+  v.y /= length;
+  v.z /= length;
+  return true;
+}
+
+
+void computeBounds(xcb::Meshlet& meshlet, const Meshlets& result,
+                   const float* vertices, unsigned int stride)
+//Summary:	sets the bounding sphere and the normal cone of a finished meshlet
+{
+  const uint32_t* meshletVertices = &result.vertices[meshlet.vertexOffset];
+  const uint8_t* meshletTriangles = &result.triangles[3 * meshlet.triangleOffset];
+
+  //sphere around the center of the bounding box
+  //
+  Vector3 low = position(vertices, stride, meshletVertices[0]);
+  Vector3 high = low;
+  uint32_t i;
+  for (i = 1; i < meshlet.vertexCount; i++) {
+    const Vector3 p = position(vertices, stride, meshletVertices[i]);
+    low.x = p.x < low.x ? p.x : low.x;
+    low.y = p.y < low.y ? p.y : low.y;
+    low.z = p.z < low.z ? p.z : low.z;
+    high.x = p.x > high.x ? p.x : high.x;
+    high.y = p.y > high.y ? p.y : high.y;
+    high.z = p.z > high.z ? p.z : high.z;
+  }
+  const Vector3 center = { (low.x + high.x) * 0.5f, (low.y + high.y) * 0.5f, (low.z + high.z) * 0.5f };
+  float radiusSquared = 0.0f;
+  for (i = 0; i < meshlet.vertexCount; i++) {
+    const Vector3 d = subtract(position(vertices, stride, meshletVertices[i]), center);
+    radiusSquared = dot(d, d) > radiusSquared ? dot(d, d) : radiusSquared;
+  }
+  meshlet.center[0] = center.x;
+  meshlet.center[1] = center.y;
+  meshlet.center[2] = center.z;
+  meshlet.radius = sqrtf(radiusSquared);
+
+  //cone around the triangle normals; its axis is their normalized sum and
+  //its apex lies behind the sphere center, far enough for every triangle
+  //plane to be in front of it
+  //
+  std::vector<Vector3> normals;
+  normals.reserve(meshlet.triangleCount);
+  std::vector<Vector3> corners;
+  corners.reserve(meshlet.triangleCount);
+  Vector3 axis = { 0.0f, 0.0f, 0.0f };
+  for (i = 0; i < meshlet.triangleCount; i++) {
+    const Vector3 a = position(vertices, stride, meshletVertices[meshletTriangles[3 * i]]);
+    const Vector3 b = position(vertices, stride, meshletVertices[meshletTriangles[3 * i + 1]]);
+    const Vector3 c = position(vertices, stride, meshletVertices[meshletTriangles[3 * i + 2]]);
+    Vector3 normal = cross(subtract(b, a), subtract(c, a));
+    if (!normalize(normal)) {
+      continue;    //degenerate triangles face no way
+    }
+    normals.push_back(normal);
+    corners.push_back(a);
+    axis.x += normal.x;
+    axis.y += normal.y;
+    axis.z += normal.z;
+  }
+
+  meshlet.coneApex[0] = center.x;
+  meshlet.coneApex[1] = center.y;
+  meshlet.coneApex[2] = center.z;
+  meshlet.coneAxis[0] = 0.0f;
+  meshlet.coneAxis[1] = 0.0f;
+  meshlet.coneAxis[2] = 0.0f;
+  meshlet.coneCutoff = 1.0f;
+  meshlet.reserved = 0.0f;
+
+  if (!normalize(axis)) {
+    return;
+  }
+
+  float minDot = 1.0f;
+  size_t t;
+  for (t = 0; t < normals.size(); t++) {
+    const float d = dot(normals[t], axis);
+    minDot = d < minDot ? d : minDot;
+  }
+  meshlet.coneAxis[0] = axis.x;
+  meshlet.coneAxis[1] = axis.y;
+  meshlet.coneAxis[2] = axis.z;
+  if (minDot <= kMinConeDot) {
+    return;
+  }
+
+  float maxDistance = 0.0f;
+  for (t = 0; t < normals.size(); t++) {
+    //distance along -axis from the center to the plane of the triangle
+    //
+    const float distance = dot(subtract(center, corners[t]), normals[t]) / dot(axis, normals[t]);
+    maxDistance = distance > maxDistance ? distance : maxDistance;
+  }
+  meshlet.coneApex[0] = center.x - axis.x * maxDistance;
+  meshlet.coneApex[1] = center.y - axis.y * maxDistance;
+  meshlet.coneApex[2] = center.z - axis.z * maxDistance;
+  meshlet.coneCutoff = sqrtf(1.0f - minDot * minDot);
+}
+
+}
+
+
+void buildMeshlets(const uint32_t* triangles, size_t triangleCount,
+                   const float* vertices, unsigned int stride, size_t vertexCount,
+                   const uint32_t* breaks, size_t breakCount,
+                   Meshlets& result)
+//Summary:	cuts a triangle list into meshlets
+//Args   :	triangles - 3 * triangleCount vertex indices, all below
+//			vertexCount
+//			vertices - the vertex table, stride floats per vertex starting
+//			with the position (x, y, z)
+//			breaks - breakCount ascending triangle indices a new meshlet
+//			must start at; may be NULL if breakCount is 0
+//			result - set to the meshlets
+{
+  result.meshlets.clear();
+  result.vertices.clear();
+  result.triangles.clear();
+  result.triangles.reserve(3 * triangleCount);
+
+  //index of every vertex in the current meshlet
+  //
+  std::vector<uint8_t> local(vertexCount, kNotInMeshlet);
+
+  xcb::Meshlet current = {};
+  size_t nextBreak = 0;
+  size_t t;
+  for (t = 0; t <= triangleCount; t++) {
+    bool atBreak = false;
+    while (nextBreak < breakCount && breaks[nextBreak] <= t) {
+      atBreak = atBreak || breaks[nextBreak] == t;
+      nextBreak++;
+    }
+
+    unsigned int added = 0;
+    if (t < triangleCount) {
+      int corner;
+      for (corner = 0; corner < 3; corner++) {
+        const uint32_t vertex = triangles[3 * t + corner];
+        const bool repeated = (corner > 0 && vertex == triangles[3 * t]) ||
+                              (corner > 1 && vertex == triangles[3 * t + 1]);
+        added += kNotInMeshlet == local[vertex] && !repeated ? 1 : 0;
+      }
+    }
+
+    const bool full = current.vertexCount + added > xcb::kMaxMeshletVertices ||
+                      current.triangleCount == xcb::kMaxMeshletTriangles || atBreak;
+    if (0 != current.triangleCount && (t == triangleCount || full)) {
+      computeBounds(current, result, vertices, stride);
+      result.meshlets.push_back(current);
+
+      uint32_t i;
+      for (i = 0; i < current.vertexCount; i++) {
+        local[result.vertices[current.vertexOffset + i]] = kNotInMeshlet;
+      }
+      current = xcb::Meshlet();
+      current.vertexOffset = static_cast<uint32_t>(result.vertices.size());
+      current.triangleOffset = static_cast<uint32_t>(result.triangles.size() / 3);
+    }
+    if (t == triangleCount) {
+      break;
+    }
+
+    int corner;
+    for (corner = 0; corner < 3; corner++) {
+      const uint32_t vertex = triangles[3 * t + corner];
+      if (kNotInMeshlet == local[vertex]) {
+        local[vertex] = static_cast<uint8_t>(current.vertexCount++);
+        result.vertices.push_back(vertex);
+      }
+      result.triangles.push_back(local[vertex]);
+    }
+    current.triangleCount++;
+  }
+}
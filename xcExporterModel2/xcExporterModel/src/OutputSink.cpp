@@ -0,0 +1,238 @@
+//
+//
+
+//OutputSink.cpp
+
+#include "OutputSink.h"
+
+#include <algorithm>
+#include <cstring>
+
+
+FileOutputSink::FileOutputSink(const char* fileName, bool binary, size_t bufferSize) :
+  fBuffer(std::max<size_t>(bufferSize, 1)),
+  fUsed(0),
+  fBytesWritten(0),
+  fFailed(false)
+  //Summary:	opens the given file for writing
+  //Args   :	fileName - the pathname of the file to be written to
+  //			binary - true to open the file without newline translation
+  //			bufferSize - size in bytes of the user-space buffer
+{
+  //the stream's own buffering is disabled; fBuffer is the only buffer, so
+  //every drain() is a single write to the OS
+  //
+  fFile.rdbuf()->pubsetbuf(NULL, 0);
+
+  std::ios::openmode mode = std::ios::out | std::ios::trunc;
+  if (binary) {
+    mode |= std::ios::binary;
+  }
+  fFile.open(fileName, mode);
+}
+
+
+FileOutputSink::~FileOutputSink()
+//Summary:	flushes any pending data and closes the file
+{
+  close();
+}
+
+
+bool FileOutputSink::isOpen() const
+//Summary:	returns true if the file was opened successfully
+{
+  return fFile.is_open();
+}
+
+
+bool FileOutputSink::write(const char* data, size_t size)
+//Summary:	appends data to the buffer, draining it to the file when full
+//Args   :	data - the bytes to be written
+//			size - the number of bytes to be written
+//Returns:	true if no write to the file has failed so far; the bytes of
+//			a failed write are not counted
+{
+  if (fFailed) {
+    return false;
+  }
+
+  if (size > fBuffer.size() - fUsed) {
+    if (!drain()) {
+      return false;
+    }
+
+    //blocks at least as large as the buffer go straight to the file
+    //
+    if (size >= fBuffer.size()) {
+      fFile.write(data, static_cast<std::streamsize>(size));
+      fFailed = !fFile;
+      if (!fFailed) {
+        fBytesWritten += size;
+      }
+      return !fFailed;
+    }
+  }
+
+  memcpy(&fBuffer[fUsed], data, size);
+  fUsed += size;
+  fBytesWritten += size;
+  return true;
+}
+
+
+bool FileOutputSink::flush()
+//Summary:	explicit flush point; hands all buffered data to the OS
+//Returns:	true if no write to the file has failed so far
+{
+  if (!drain()) {
+    return false;
+  }
+  fFile.flush();
+  fFailed = fFailed || !fFile;
+  return !fFailed;
+}
+
+
+size_t FileOutputSink::bytesWritten() const
+//Summary:	returns the number of bytes write() accepted, buffered or
+//			already in the file
+{
+  return fBytesWritten;
+}
+
+
+bool FileOutputSink::close()
+//Summary:	flushes and closes the file
+//Returns:	true if all data reached the file
+{
+  if (!fFile.is_open()) {
+    return !fFailed;
+  }
+  flush();
+  fFile.close();
+  fFailed = fFailed || !fFile;
+  return !fFailed;
+}
+
+
+bool FileOutputSink::drain()
+//Summary:	writes the buffered bytes to the file; if that fails they no
+//			longer count as written
+{
+  if (0 != fUsed && !fFailed) {
+    fFile.write(&fBuffer[0], static_cast<std::streamsize>(fUsed));
+    fFailed = !fFile;
+    if (fFailed) {
+      fBytesWritten -= fUsed;
+    }
+  }
+  fUsed = 0;
+  return !fFailed;
+}
+
+
+MemoryOutputSink::MemoryOutputSink(std::string& buffer) :
+  fBuffer(buffer)
+  //Summary:	creates a sink appending to buffer
+{
+}
+
+
+bool MemoryOutputSink::write(const char* data, size_t size)
+//Summary:	appends data to the buffer
+{
+  fBuffer.append(data, size);
+  return true;
+}
+
+
+bool MemoryOutputSink::flush()
+//Summary:	nothing to flush; the data already is in the buffer
+{
+  return true;
+}
+
+
+size_t MemoryOutputSink::bytesWritten() const
+//Summary:	returns the size of the buffer
+{
+  return fBuffer.size();
+}
+
+
+SinkStreamBuf::SinkStreamBuf(OutputSink& sink) :
+  fSink(sink)
+  //Summary:	creates a stream buffer that forwards its data to sink
+{
+  setp(fPutArea, fPutArea + kPutAreaSize);
+}
+
+
+SinkStreamBuf::~SinkStreamBuf()
+//Summary:	forwards any data still held in the put area to the sink
+{
+  drain();
+}
+
+
+SinkStreamBuf::int_type SinkStreamBuf::overflow(int_type ch)
+//Summary:	called when the put area is full
+{
+  if (!drain()) {
+    return traits_type::eof();
+  }
+  if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+    *pptr() = traits_type::to_char_type(ch);
+    pbump(1);
+  }
+  return traits_type::not_eof(ch);
+}
+
+
+std::streamsize SinkStreamBuf::xsputn(const char* data, std::streamsize size)
+//Summary:	copies formatted output into the put area, passing large blocks
+//			through to the sink directly
+{
+  if (size > epptr() - pptr()) {
+    if (!drain()) {
+      return 0;
+    }
+    if (size >= static_cast<std::streamsize>(kPutAreaSize)) {
+      return fSink.write(data, static_cast<size_t>(size)) ? size : 0;
+    }
+  }
+  memcpy(pptr(), data, static_cast<size_t>(size));
+  pbump(static_cast<int>(size));
+  return size;
+}
+
+
+int SinkStreamBuf::sync()
+//Summary:	called by std::ostream::flush(); pushes data into the sink and
+//			asks the sink to flush as well
+{
+  return (drain() && fSink.flush()) ? 0 : -1;
+}
+
+
+SinkStreamBuf::pos_type SinkStreamBuf::seekoff(off_type off,
+                                               std::ios_base::seekdir dir,
+                                               std::ios_base::openmode which)
+//Summary:	supports tellp() only; the position is the number of bytes written
+//			through this buffer so far
+{
+  if (0 != off || std::ios_base::cur != dir || !(which & std::ios_base::out)) {
+    return pos_type(off_type(-1));
+  }
+  return pos_type(static_cast<off_type>(fSink.bytesWritten() + (pptr() - pbase())));
+}
+
+
+bool SinkStreamBuf::drain()
+//Summary:	hands the put area to the sink
+{
+  const size_t size = static_cast<size_t>(pptr() - pbase());
+  setp(fPutArea, fPutArea + kPutAreaSize);
+  return 0 == size || fSink.write(fPutArea, size);
+}
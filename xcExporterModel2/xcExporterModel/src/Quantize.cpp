@@ -0,0 +1,184 @@
+//
+//
+
+//Quantize.cpp
+
+#include "Quantize.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+const double kDegreesPerRadian = 57.29577951308232;
+
+
+bool normalize(float* v)
+{
+  const float length = sqrtf(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+  if (0.0f == length) {
+    return false;
+  }
+  v[0] /= length;
+  v[1] /= length;
+  v[2] /= length;
+  return true;
+}
+
+
+template <class Snorm>
+double octahedralAngleError(const Float3Stream& vectors, const Snorm* uv, float range)
+//Summary:	largest angle between a vector and its decoded octahedral
+//			encoding, in degrees
+{
+  double maxAngle = 0.0;
+  size_t i;
+  for (i = 0; i < vectors.length(); i++) {
+    float original[3] = { vectors.x[i], vectors.y[i], vectors.z[i] };
+    if (!normalize(original)) {
+      continue;
+    }
+    float decoded[3];
+    decodeOctahedral(uv[2 * i] / range, uv[2 * i + 1] / range, decoded);
+
+    //atan2 of the sine and cosine, since acos loses small angles to rounding
+    //
+    const double a[3] = { original[0], original[1], original[2] };
+    const double b[3] = { decoded[0], decoded[1], decoded[2] };
+    const double cx = a[1] * b[2] - a[2] * b[1];
+    const double cy = a[2] * b[0] - a[0] * b[2];
+    const double cz = a[0] * b[1] - a[1] * b[0];
+    const double angle = atan2(sqrt(cx * cx + cy * cy + cz * cz),
+                               a[0] * b[0] + a[1] * b[1] + a[2] * b[2]) * kDegreesPerRadian;
+    maxAngle = angle > maxAngle ? angle : maxAngle;
+  }
+  return maxAngle;
+}
+
+}
+
+
+float halfToFloat(uint16_t half)
+//Summary:	converts an IEEE half float to float
+{
+  const uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+  const uint32_t exponent = (half >> 10) & 0x1F;
+  const uint32_t mantissa = half & 0x3FF;
+
+  uint32_t bits;
+  if (0x1F == exponent) {
+    bits = sign | 0x7F800000u | (mantissa << 13);
+  }
+  else if (0 != exponent) {
+    bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+  }
+  else {
+    //zero or denormal: mantissa * 2^-24
+    //
+    const float magnitude = static_cast<float>(mantissa) * (1.0f / 16777216.0f);
+    memcpy(&bits, &magnitude, sizeof(bits));
+    bits |= sign;
+  }
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+
+void decodeOctahedral(float u, float v, float* vector)
+//Summary:	decodes octahedral coordinates, see Quantize.h
+//Args   :	u, v - the coordinates, in [-1, 1]
+//			vector - set to the unit vector (x, y, z)
+{
+  vector[0] = u;
+  vector[1] = v;
+  vector[2] = 1.0f - fabsf(u) - fabsf(v);
+  if (vector[2] < 0.0f) {
+    vector[0] = (1.0f - fabsf(v)) * (u < 0.0f ? -1.0f : 1.0f);
+    vector[1] = (1.0f - fabsf(u)) * (v < 0.0f ? -1.0f : 1.0f);
+  }
+  normalize(vector);
+}
+
+
+void positionBounds(const Float3Stream& positions, float* low, float* high)
+//Summary:	computes the axis aligned bounding box of the positions
+//Args   :	low, high - set to its corners; (0, 0, 0) if there are none
+{
+  const FloatStream* axes[3] = { &positions.x, &positions.y, &positions.z };
+  int axis;
+  for (axis = 0; axis < 3; axis++) {
+    const FloatStream& values = *axes[axis];
+    low[axis] = values.empty() ? 0.0f : values[0];
+    high[axis] = low[axis];
+    size_t i;
+    for (i = 1; i < values.size(); i++) {
+      low[axis] = values[i] < low[axis] ? values[i] : low[axis];
+      high[axis] = values[i] > high[axis] ? values[i] : high[axis];
+    }
+  }
+}
+
+
+void positionScale(const float* low, const float* high, float* scale)
+//Summary:	computes the factors that map the box low, high onto unorm16
+//Args   :	scale - set to kPositionSteps / extent per axis, 0 for a flat
+//			axis
+{
+  int axis;
+  for (axis = 0; axis < 3; axis++) {
+    const float extent = high[axis] - low[axis];
+    scale[axis] = extent > 0.0f ? kPositionSteps / extent : 0.0f;
+  }
+}
+
+
+double positionError(const Float3Stream& positions, const uint16_t* xyzw,
+                     const float* low, const float* high)
+//Summary:	largest distance between a position and its decoded unorm16
+//			encoding against the box low, high
+{
+  double step[3];
+  int axis;
+  for (axis = 0; axis < 3; axis++) {
+    step[axis] = (static_cast<double>(high[axis]) - low[axis]) / kPositionSteps;
+  }
+
+  double maxSquared = 0.0;
+  size_t i;
+  for (i = 0; i < positions.length(); i++) {
+    const double dx = low[0] + xyzw[4 * i] * step[0] - positions.x[i];
+    const double dy = low[1] + xyzw[4 * i + 1] * step[1] - positions.y[i];
+    const double dz = low[2] + xyzw[4 * i + 2] * step[2] - positions.z[i];
+    const double squared = dx * dx + dy * dy + dz * dz;
+    maxSquared = squared > maxSquared ? squared : maxSquared;
+  }
+  return sqrt(maxSquared);
+}
+
+
+double octahedralError(const Float3Stream& vectors, const int16_t* uv)
+//Summary:	largest angle error of snorm16 octahedral vectors, in degrees
+{
+  return octahedralAngleError(vectors, uv, 32767.0f);
+}
+
+
+double octahedralError(const Float3Stream& vectors, const int8_t* uv)
+//Summary:	largest angle error of snorm8 octahedral vectors, in degrees
+{
+  return octahedralAngleError(vectors, uv, 127.0f);
+}
+
+
+double halfError(const float* values, const uint16_t* halves, size_t count)
+//Summary:	largest absolute difference between count values and their halves
+{
+  double maxError = 0.0;
+  size_t i;
+  for (i = 0; i < count; i++) {
+    const double error = fabs(static_cast<double>(halfToFloat(halves[i])) - values[i]);
+    maxError = error > maxError ? error : maxError;
+  }
+  return maxError;
+}
@@ -0,0 +1,124 @@
+//
+//
+
+//ShaderCache.cpp
+
+#include <maya/MGlobal.h>
+#include <maya/MFnDependencyNode.h>
+#include <maya/MItDependencyGraph.h>
+#include <maya/MObjectHandle.h>
+#include <maya/MPlug.h>
+#include <maya/MPlugArray.h>
+
+#include "ShaderCache.h"
+
+
+const ShaderCache::Entry& ShaderCache::lookup(const MObject& shadingGroup)
+//Summary:	returns the shader result of a shading group, resolving it on
+//			the first lookup only
+//Args   :	shadingGroup - the shading group set node
+{
+  const unsigned int hash = MObjectHandle(shadingGroup).hashCode();
+
+  auto range = fSlots.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second.node == shadingGroup) {
+      return it->second.entry;
+    }
+  }
+
+  Slot slot;
+  slot.node = shadingGroup;
+  slot.entry = resolve(shadingGroup);
+  return fSlots.insert(std::make_pair(hash, slot))->second.entry;
+}
+
+
+void ShaderCache::clear()
+//Summary:	forgets every shading group, at the end of an export
+{
+  fSlots.clear();
+}
+
+
+ShaderCache::Entry ShaderCache::resolve(const MObject& shadingGroup)
+//Summary:	finds the texture that is applied through a shading group.
+//			First, get the shading node connected to the set.  Then, if
+//			there is an input attribute called "color", search upstream from
+//			it for a texture file node.
+//Args   :	shadingGroup - the shading group set node
+{
+  MStatus status;
+  Entry entry;
+  entry.resolved = false;
+
+  MObject shaderNode = findShader(shadingGroup);
+  if (MObject::kNullObj == shaderNode) {
+    return entry;
+  }
+
+  MPlug colorPlug = MFnDependencyNode(shaderNode).findPlug("color", true, &status);
+  if (MS::kFailure == status) {
+    MGlobal::displayError("MFnDependencyNode::findPlug");
+    return entry;
+  }
+
+  MItDependencyGraph itDG(colorPlug, MFn::kFileTexture,
+    MItDependencyGraph::kUpstream,
+    MItDependencyGraph::kBreadthFirst,
+    MItDependencyGraph::kNodeLevel,
+    &status);
+
+  if (MS::kFailure == status) {
+    MGlobal::displayError("MItDependencyGraph::MItDependencyGraph");
+    return entry;
+  }
+
+  //disable automatic pruning so that we can locate a specific plug
+  itDG.disablePruningOnFilter();
+
+  //If no texture file node was found, the texture name stays empty so that
+  //color information is outputted instead
+  //
+  entry.resolved = true;
+  if (!itDG.isDone()) {
+    MObject textureNode = itDG.currentItem();
+    MPlug filenamePlug = MFnDependencyNode(textureNode).findPlug("fileTextureName", true);
+    filenamePlug.getValue(entry.texture);
+  }
+  return entry;
+}
+
+
+MObject ShaderCache::findShader(const MObject& shadingGroup)
+//Summary:	finds the shading node for the given shading group set node
+//Args   :	shadingGroup - the shading group set node
+//Returns:  the shader node for shadingGroup if found;
+//			MObject::kNullObj otherwise
+{
+  MFnDependencyNode fnNode(shadingGroup);
+  MPlug shaderPlug = fnNode.findPlug("surfaceShader", true);
+
+  if (!shaderPlug.isNull()) {
+    MPlugArray connectedPlugs;
+
+    //get all the plugs that are connected as the destination of this
+    //surfaceShader plug so we can find the surface shaderNode
+    //
+    MStatus status;
+    shaderPlug.connectedTo(connectedPlugs, true, false, &status);
+    if (MStatus::kFailure == status) {
+      MGlobal::displayError("MPlug::connectedTo");
+      return MObject::kNullObj;
+    }
+
+    if (1 != connectedPlugs.length()) {
+      MGlobal::displayError("Error getting shader for: " + fnNode.name());
+    }
+    else {
+      return connectedPlugs[0].node();
+    }
+  }
+
+  return MObject::kNullObj;
+}
@@ -0,0 +1,123 @@
+//
+//
+
+//SliceEncoder.cpp
+
+#include "SliceEncoder.h"
+#include "WorkerPool.h"
+#include "OutputSink.h"
+
+#include <ostream>
+#include <string>
+
+
+SliceEncoder::SliceEncoder(WorkerPool* pool, size_t itemCount, size_t minSliceItems) :
+  fPool(pool),
+  fItemCount(itemCount),
+  fSliceCount(1)
+  //Summary:	divides [0, itemCount) into slices
+  //Args   :	pool - the threads to run slices on; NULL runs everything on
+  //				   the calling thread
+  //			itemCount - number of items, e.g. faces
+  //			minSliceItems - the smallest slice worth a thread of its own
+{
+  if (NULL == pool || 0 == pool->threadCount() || 0 == minSliceItems) {
+    return;
+  }
+
+  //a few slices per thread, so that threads that are already busy encoding
+  //other meshes do not hold up the others
+  //
+  const size_t maxSlices = 4 * (static_cast<size_t>(pool->threadCount()) + 1);
+  size_t slices = itemCount / minSliceItems;
+  if (slices > maxSlices) {
+    slices = maxSlices;
+  }
+  if (slices > 1) {
+    fSliceCount = slices;
+  }
+}
+
+
+size_t SliceEncoder::sliceCount() const
+//Summary:	returns the number of slices, at least 1
+{
+  return fSliceCount;
+}
+
+
+size_t SliceEncoder::sliceBegin(size_t slice) const
+//Summary:	returns the first item of the given slice
+{
+  return fItemCount / fSliceCount * slice + (slice < fItemCount % fSliceCount ? slice : fItemCount % fSliceCount);
+}
+
+
+size_t SliceEncoder::sliceEnd(size_t slice) const
+//Summary:	returns one past the last item of the given slice
+{
+  return sliceBegin(slice + 1);
+}
+
+
+void SliceEncoder::forEachSlice(const std::function<void(size_t slice)>& body) const
+//Summary:	calls body once for every slice, in parallel
+//Args   :	body - the work for one slice; must not call into Maya
+{
+  if (1 == fSliceCount) {
+    body(0);
+    return;
+  }
+  fPool->parallelFor(fSliceCount, body);
+}
+
+
+bool SliceEncoder::encode(std::ostream& os,
+                          const std::function<bool(size_t slice, std::ostream& os)>& encodeSlice) const
+//Summary:	formats every slice into its own buffer, in parallel, and writes
+//			the buffers to os in slice order
+//Args   :	os - the stream to write to
+//			encodeSlice - formats one slice; must not call into Maya
+//Returns:	true if every slice succeeded and was written
+{
+  if (1 == fSliceCount) {
+    return encodeSlice(0, os) && !!os;
+  }
+
+  std::vector<std::string> buffers(fSliceCount);
+  std::vector<char> succeeded(fSliceCount, 0);
+
+  forEachSlice([&](size_t slice) {
+    MemoryOutputSink sink(buffers[slice]);
+    SinkStreamBuf buffer(sink);
+    std::ostream sliceStream(&buffer);
+    sliceStream.copyfmt(os);
+    const bool encoded = encodeSlice(slice, sliceStream);
+    sliceStream.flush();
+    succeeded[slice] = encoded && !!sliceStream;
+  });
+
+  size_t slice;
+  for (slice = 0; slice < fSliceCount; slice++) {
+    if (!succeeded[slice]) {
+      return false;
+    }
+    os.write(buffers[slice].data(), static_cast<std::streamsize>(buffers[slice].size()));
+  }
+  return !!os;
+}
+
+
+size_t SliceEncoder::prefixSum(std::vector<size_t>& counts)
+//Summary:	replaces every count by the sum of the counts before it
+//Returns:	the sum of all counts
+{
+  size_t sum = 0;
+  size_t i;
+  for (i = 0; i < counts.size(); i++) {
+    const size_t count = counts[i];
+    counts[i] = sum;
+    sum += count;
+  }
+  return sum;
+}
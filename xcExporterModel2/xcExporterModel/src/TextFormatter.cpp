@@ -0,0 +1,134 @@
+//
+//
+
+//TextFormatter.cpp
+
+#include "TextFormatter.h"
+
+#include <charconv>
+#include <cstring>
+#include <ostream>
+
+
+TextFormatter::TextFormatter(std::ostream& os, int precision) :
+  fOut(os),
+  fPrecision(precision < 0 ? kShortest : (precision > kMaxPrecision ? kMaxPrecision : precision)),
+  fBuffer(kBufferSize),
+  fUsed(0)
+  //Summary:	creates a formatter writing to os
+  //Args   :	os - the stream the formatted text ends up in
+  //			precision - kShortest for shortest round-trip output, otherwise
+  //						the number of digits after the point
+{
+}
+
+
+TextFormatter::~TextFormatter()
+//Summary:	hands any text still buffered to the stream
+{
+  flush();
+}
+
+
+TextFormatter& TextFormatter::operator<<(double value)
+//Summary:	appends a double
+{
+  char* first = reserve(kMaxNumberSize);
+  std::to_chars_result result = kShortest == fPrecision ?
+    std::to_chars(first, first + kMaxNumberSize, value) :
+    std::to_chars(first, first + kMaxNumberSize, value, std::chars_format::fixed, fPrecision);
+  fUsed += static_cast<size_t>(result.ptr - first);
+  return *this;
+}
+
+
+TextFormatter& TextFormatter::operator<<(float value)
+//Summary:	appends a float; in shortest mode this is the shortest text that
+//			reads back to the same float, not to the same double
+{
+  char* first = reserve(kMaxNumberSize);
+  std::to_chars_result result = kShortest == fPrecision ?
+    std::to_chars(first, first + kMaxNumberSize, value) :
+    std::to_chars(first, first + kMaxNumberSize, value, std::chars_format::fixed, fPrecision);
+  fUsed += static_cast<size_t>(result.ptr - first);
+  return *this;
+}
+
+
+TextFormatter& TextFormatter::operator<<(int value)
+//Summary:	appends an int
+{
+  char* first = reserve(16);
+  fUsed += static_cast<size_t>(std::to_chars(first, first + 16, value).ptr - first);
+  return *this;
+}
+
+
+TextFormatter& TextFormatter::operator<<(unsigned int value)
+//Summary:	appends an unsigned int
+{
+  char* first = reserve(16);
+  fUsed += static_cast<size_t>(std::to_chars(first, first + 16, value).ptr - first);
+  return *this;
+}
+
+
+TextFormatter& TextFormatter::operator<<(char value)
+//Summary:	appends a single character
+{
+  *reserve(1) = value;
+  fUsed++;
+  return *this;
+}
+
+
+TextFormatter& TextFormatter::operator<<(const char* text)
+//Summary:	appends a null terminated string
+{
+  append(text, strlen(text));
+  return *this;
+}
+
+
+TextFormatter& TextFormatter::operator<<(const std::string& text)
+//Summary:	appends a string
+{
+  append(text.data(), text.size());
+  return *this;
+}
+
+
+void TextFormatter::append(const char* text, size_t size)
+//Summary:	appends size bytes of text; long text bypasses the buffer
+{
+  if (size > kBufferSize / 2) {
+    flush();
+    fOut.write(text, static_cast<std::streamsize>(size));
+    return;
+  }
+  memcpy(reserve(size), text, size);
+  fUsed += size;
+}
+
+
+bool TextFormatter::flush()
+//Summary:	hands the buffered text to the stream
+//Returns:	true if the stream is still good
+{
+  if (0 != fUsed) {
+    fOut.write(&fBuffer[0], static_cast<std::streamsize>(fUsed));
+    fUsed = 0;
+  }
+  return !!fOut;
+}
+
+
+char* TextFormatter::reserve(size_t size)
+//Summary:	makes room for size more bytes, flushing if needed
+//Returns:	where those bytes go; the caller advances fUsed
+{
+  if (size > fBuffer.size() - fUsed) {
+    flush();
+  }
+  return &fBuffer[fUsed];
+}
@@ -0,0 +1,270 @@
+//
+//
+
+//VertexCache.cpp
+
+#include "VertexCache.h"
+
+#include <cmath>
+
+namespace {
+
+//the tuning of Forsyth's article
+//
+const int   kCacheSize = 32;
+const float kCacheDecayPower = 1.5f;
+const float kLastTriangleScore = 0.75f;
+const float kValenceBoostScale = 2.0f;
+const float kValenceBoostPower = 0.5f;
+
+//valences up to this many triangles get their boost from a table
+//
+const unsigned int kValenceTableSize = 64;
+
+const uint32_t kNotUsed = 0xFFFFFFFFu;
+
+
+class VertexScores {
+
+public:
+  VertexScores()
+  //Summary:	tabulates the score of every cache position and valence
+  {
+    int i;
+    for (i = 0; i < kCacheSize; i++) {
+      if (i < 3) {
+        //the vertices of the triangle just emitted are scored low on
+        //purpose, so the next triangle does not simply reuse its edge
+        //
+        fCache[i] = kLastTriangleScore;
+      }
+      else {
+        const float scale = 1.0f / (kCacheSize - 3);
+        fCache[i] = powf(1.0f - (i - 3) * scale, kCacheDecayPower);
+      }
+    }
+    unsigned int valence;
+    fValence[0] = 0.0f;
+    for (valence = 1; valence < kValenceTableSize; valence++) {
+      fValence[valence] = kValenceBoostScale * powf(static_cast<float>(valence), -kValenceBoostPower);
+    }
+  }
+
+  float score(int cachePosition, unsigned int remaining) const
+  //Summary:	score of a vertex at cachePosition (-1 if not in the cache)
+  //			that still has remaining triangles to be emitted
+  {
+    if (0 == remaining) {
+      return -1.0f;
+    }
+    float result = cachePosition < 0 ? 0.0f : fCache[cachePosition];
+    result += remaining < kValenceTableSize ? fValence[remaining] :
+      kValenceBoostScale * powf(static_cast<float>(remaining), -kValenceBoostPower);
+    return result;
+  }
+
+private:
+  float fCache[kCacheSize];
+  float fValence[kValenceTableSize];
+};
+
+}
+
+
+void vertexCacheOrder(const uint32_t* indices, size_t triangleCount,
+                      size_t vertexCount, std::vector<uint32_t>& order)
+//Summary:	computes the Forsyth order of the triangles of an index buffer
+//Args   :	indices - 3 * triangleCount vertex indices, all below vertexCount
+//			triangleCount - number of triangles
+//			vertexCount - number of vertices the indices refer to
+//			order - set to the original index of every triangle, in the
+//			order the triangles should be drawn
+{
+  static const VertexScores scores;
+
+  order.clear();
+  order.reserve(triangleCount);
+  if (0 == triangleCount) {
+    return;
+  }
+
+  //the triangles of every vertex, as one array; the first remaining[v]
+  //entries of a vertex are the triangles it still has to be emitted with
+  //
+  std::vector<uint32_t> firstTriangle(vertexCount + 1, 0);
+  size_t i;
+  for (i = 0; i < 3 * triangleCount; i++) {
+    firstTriangle[indices[i] + 1]++;
+  }
+  for (i = 0; i < vertexCount; i++) {
+    firstTriangle[i + 1] += firstTriangle[i];
+  }
+
+  std::vector<uint32_t> remaining(vertexCount, 0);
+  std::vector<uint32_t> triangles(3 * triangleCount);
+  for (i = 0; i < 3 * triangleCount; i++) {
+    const uint32_t vertex = indices[i];
+    triangles[firstTriangle[vertex] + remaining[vertex]++] = static_cast<uint32_t>(i / 3);
+  }
+
+  std::vector<int> cachePosition(vertexCount, -1);
+  std::vector<float> vertexScore(vertexCount);
+  for (i = 0; i < vertexCount; i++) {
+    vertexScore[i] = scores.score(-1, remaining[i]);
+  }
+
+  std::vector<float> triangleScore(triangleCount);
+  std::vector<char> emitted(triangleCount, 0);
+  for (i = 0; i < triangleCount; i++) {
+    triangleScore[i] = vertexScore[indices[3 * i]] + vertexScore[indices[3 * i + 1]] +
+      vertexScore[indices[3 * i + 2]];
+  }
+
+  uint32_t cache[kCacheSize + 3];
+  int cacheUsed = 0;
+  size_t scan = 0;
+  size_t best = 0;
+
+  while (true) {
+    emitted[best] = 1;
+    order.push_back(static_cast<uint32_t>(best));
+    if (order.size() == triangleCount) {
+      break;
+    }
+
+    //drop the triangle from the lists of its vertices, and put them in
+    //front of the cache
+    //
+    uint32_t newCache[kCacheSize + 3];
+    int newUsed = 0;
+    int corner;
+    for (corner = 0; corner < 3; corner++) {
+      const uint32_t vertex = indices[3 * best + corner];
+      uint32_t* list = &triangles[firstTriangle[vertex]];
+      const uint32_t last = --remaining[vertex];
+      uint32_t k;
+      for (k = 0; k < last && list[k] != best; k++) {
+      }
+      list[k] = list[last];
+      list[last] = static_cast<uint32_t>(best);
+
+      int j;
+      for (j = 0; j < newUsed && newCache[j] != vertex; j++) {
+      }
+      if (j == newUsed) {
+        newCache[newUsed++] = vertex;
+      }
+    }
+    const int front = newUsed;
+    int j;
+    for (j = 0; j < cacheUsed; j++) {
+      int k;
+      for (k = 0; k < front && newCache[k] != cache[j]; k++) {
+      }
+      if (k == front) {
+        newCache[newUsed++] = cache[j];
+      }
+    }
+
+    //rescore every vertex whose position changed, including the ones that
+    //just fell out of the cache, and pass the change on to their triangles
+    //
+    for (j = 0; j < newUsed; j++) {
+      const uint32_t vertex = newCache[j];
+      const int position = j < kCacheSize ? j : -1;
+      cachePosition[vertex] = position;
+      const float score = scores.score(position, remaining[vertex]);
+      const float delta = score - vertexScore[vertex];
+      vertexScore[vertex] = score;
+
+      const uint32_t* list = &triangles[firstTriangle[vertex]];
+      uint32_t k;
+      for (k = 0; k < remaining[vertex]; k++) {
+        triangleScore[list[k]] += delta;
+      }
+    }
+    cacheUsed = newUsed < kCacheSize ? newUsed : kCacheSize;
+    for (j = 0; j < cacheUsed; j++) {
+      cache[j] = newCache[j];
+    }
+
+    //the next triangle is the best one touching the cache; if there is
+    //none, continue with the first one not emitted yet
+    //
+    float bestScore = -1.0f;
+    bool found = false;
+    for (j = 0; j < cacheUsed; j++) {
+      const uint32_t vertex = cache[j];
+      const uint32_t* list = &triangles[firstTriangle[vertex]];
+      uint32_t k;
+      for (k = 0; k < remaining[vertex]; k++) {
+        if (triangleScore[list[k]] > bestScore) {
+          bestScore = triangleScore[list[k]];
+          best = list[k];
+          found = true;
+        }
+      }
+    }
+    if (!found) {
+      while (emitted[scan]) {
+        scan++;
+      }
+      best = scan;
+    }
+  }
+}
+
+
+void firstUseOrder(const uint32_t* indices, size_t indexCount,
+                   size_t vertexCount, std::vector<uint32_t>& remap)
+//Summary:	numbers the vertices in the order the indices first use them
+//Args   :	indices - the index buffer, all below vertexCount
+//			indexCount - number of indices
+//			vertexCount - number of vertices
+//			remap - set to the new index of every vertex
+{
+  remap.assign(vertexCount, kNotUsed);
+  uint32_t next = 0;
+  size_t i;
+  for (i = 0; i < indexCount; i++) {
+    if (kNotUsed == remap[indices[i]]) {
+      remap[indices[i]] = next++;
+    }
+  }
+  for (i = 0; i < vertexCount; i++) {
+    if (kNotUsed == remap[i]) {
+      remap[i] = next++;
+    }
+  }
+}
+
+
+VertexCacheStats measureVertexCache(const uint32_t* indices, size_t triangleCount,
+                                    size_t vertexCount, size_t cacheSize)
+//Summary:	simulates a FIFO vertex cache over an index buffer
+//Args   :	indices - 3 * triangleCount vertex indices, all below vertexCount
+//			cacheSize - number of entries of the FIFO
+//Returns:	ACMR and ATVR of the index buffer, see VertexCache.h
+{
+  //a vertex is in the FIFO if it was transformed less than cacheSize
+  //transforms ago
+  //
+  std::vector<size_t> transformedAt(vertexCount, 0);
+  size_t transforms = 0;
+  size_t used = 0;
+  size_t i;
+  for (i = 0; i < 3 * triangleCount; i++) {
+    const uint32_t vertex = indices[i];
+    if (0 == transformedAt[vertex]) {
+      used++;
+    }
+    if (0 == transformedAt[vertex] || transforms + 1 - transformedAt[vertex] > cacheSize) {
+      transformedAt[vertex] = ++transforms;
+    }
+  }
+
+  VertexCacheStats stats;
+  stats.acmr = 0 == triangleCount ? 0.0 : static_cast<double>(transforms) / triangleCount;
+  stats.atvr = 0 == used ? 0.0 : static_cast<double>(transforms) / used;
+  return stats;
+}
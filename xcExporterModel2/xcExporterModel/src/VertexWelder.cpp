@@ -0,0 +1,112 @@
+//
+//
+
+//VertexWelder.cpp
+
+#include "VertexWelder.h"
+#include "ExportKernels.h"
+
+#include <cstring>
+
+const uint32_t VertexWelder::kEmptySlot;
+
+
+VertexWelder::VertexWelder(unsigned int stride, size_t expectedTuples) :
+  fHash(exportKernels().hashFloats),
+  fStride(stride),
+  fVertexCount(0),
+  fMask(0)
+  //Summary:	creates an empty welder
+  //Args   :	stride - number of floats per vertex
+  //			expectedTuples - number of tuples that will be welded; used to
+  //			size the hash table so that it rarely has to grow
+{
+  size_t capacity = 16;
+  while (capacity < 2 * expectedTuples) {
+    capacity *= 2;
+  }
+  fSlots.assign(capacity, kEmptySlot);
+  fMask = capacity - 1;
+
+  fVertices.reserve(expectedTuples * fStride);
+  fHashes.reserve(expectedTuples);
+}
+
+
+uint32_t VertexWelder::weld(const float* attributes)
+//Summary:	looks up a vertex tuple, adding it to the vertex table if it has not
+//			been seen before
+//Args   :	attributes - stride() floats describing the vertex
+//Returns:	the index of the vertex in the vertex table
+{
+  const uint32_t h = fHash(attributes, fStride);
+
+  size_t slot = h & fMask;
+  while (kEmptySlot != fSlots[slot]) {
+    const uint32_t vertex = fSlots[slot];
+    if (fHashes[vertex] == h && matches(vertex, attributes)) {
+      return vertex;
+    }
+    slot = (slot + 1) & fMask;
+  }
+
+  const uint32_t vertex = fVertexCount++;
+  fVertices.insert(fVertices.end(), attributes, attributes + fStride);
+  fHashes.push_back(h);
+  fSlots[slot] = vertex;
+
+  //keep the load factor at or below one half
+  //
+  if (2 * static_cast<size_t>(fVertexCount) > fSlots.size()) {
+    grow();
+  }
+  return vertex;
+}
+
+
+unsigned int VertexWelder::stride() const
+//Summary:	returns the number of floats per vertex
+{
+  return fStride;
+}
+
+
+uint32_t VertexWelder::vertexCount() const
+//Summary:	returns the number of unique vertices
+{
+  return fVertexCount;
+}
+
+
+const std::vector<float>& VertexWelder::vertices() const
+//Summary:	returns the unique vertices, stride() floats each
+{
+  return fVertices;
+}
+
+
+bool VertexWelder::matches(uint32_t vertex, const float* attributes) const
+//Summary:	compares a stored vertex with a tuple bit for bit
+{
+  return 0 == memcmp(&fVertices[static_cast<size_t>(vertex) * fStride],
+                     attributes, fStride * sizeof(float));
+}
+
+
+void VertexWelder::grow()
+//Summary:	doubles the hash table and reinserts every vertex using the stored
+//			hashes
+{
+  const size_t capacity = 2 * fSlots.size();
+  fSlots.assign(capacity, kEmptySlot);
+  fMask = capacity - 1;
+
+  uint32_t vertex;
+  for (vertex = 0; vertex < fVertexCount; vertex++) {
+    size_t slot = fHashes[vertex] & fMask;
+    while (kEmptySlot != fSlots[slot]) {
+      slot = (slot + 1) & fMask;
+    }
+    fSlots[slot] = vertex;
+  }
+}
@@ -0,0 +1,151 @@
+//
+//
+
+//WorkerPool.cpp
+
+#include "WorkerPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+
+WorkerPool::WorkerPool(unsigned int threadCount) :
+  fStopping(false)
+  //Summary:	starts the worker threads
+  //Args   :	threadCount - number of threads to start
+{
+  unsigned int i;
+  for (i = 0; i < threadCount; i++) {
+    fThreads.push_back(std::thread(&WorkerPool::workerLoop, this));
+  }
+}
+
+
+WorkerPool::~WorkerPool()
+//Summary:	runs every task still queued, then joins the worker threads
+{
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    fStopping = true;
+  }
+  fTaskReady.notify_all();
+
+  size_t i;
+  for (i = 0; i < fThreads.size(); i++) {
+    fThreads[i].join();
+  }
+}
+
+
+void WorkerPool::submit(std::function<void()> task)
+//Summary:	queues a task for the next free worker
+//Args   :	task - the work to run; must not call into Maya
+{
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    fTasks.push_back(std::move(task));
+  }
+  fTaskReady.notify_one();
+}
+
+
+void WorkerPool::parallelFor(size_t count, const std::function<void(size_t)>& body)
+//Summary:	calls body(i) for every i in [0, count), spread over the calling
+//			thread and the workers; returns once every call has returned
+//Args   :	count - number of indices
+//			body - the loop body; must not call into Maya
+{
+  if (count < 2 || fThreads.empty()) {
+    size_t i;
+    for (i = 0; i < count; i++) {
+      body(i);
+    }
+    return;
+  }
+
+  //indices are claimed one at a time from a shared counter.  Helpers that
+  //only start once every index is claimed return without touching body, so
+  //the state they share with this call is kept alive by reference counting
+  //rather than by this stack frame
+  //
+  struct Loop {
+    std::atomic<size_t>     next;
+    size_t                  count;
+    size_t                  finished;
+    std::mutex              mutex;
+    std::condition_variable allFinished;
+    const std::function<void(size_t)>* body;
+  };
+  std::shared_ptr<Loop> loop(new Loop);
+  loop->next = 0;
+  loop->count = count;
+  loop->finished = 0;
+  loop->body = &body;
+
+  std::function<void()> run = [loop]() {
+    size_t ran = 0;
+    size_t i;
+    while ((i = loop->next++) < loop->count) {
+      (*loop->body)(i);
+      ran++;
+    }
+    if (0 != ran) {
+      std::lock_guard<std::mutex> lock(loop->mutex);
+      loop->finished += ran;
+      if (loop->finished == loop->count) {
+        loop->allFinished.notify_all();
+      }
+    }
+  };
+
+  const size_t helpers = std::min(count - 1, fThreads.size());
+  size_t h;
+  for (h = 0; h < helpers; h++) {
+    submit(run);
+  }
+  run();
+
+  std::unique_lock<std::mutex> lock(loop->mutex);
+  while (loop->finished != loop->count) {
+    loop->allFinished.wait(lock);
+  }
+}
+
+
+unsigned int WorkerPool::threadCount() const
+//Summary:	returns the number of worker threads
+{
+  return static_cast<unsigned int>(fThreads.size());
+}
+
+
+unsigned int WorkerPool::hardwareThreads()
+//Summary:	returns the number of threads the machine can run concurrently,
+//			at least 1
+{
+  const unsigned int count = std::thread::hardware_concurrency();
+  return 0 == count ? 1 : count;
+}
+
+
+void WorkerPool::workerLoop()
+//Summary:	body of every worker thread; runs tasks until the pool is
+//			destroyed and the queue is empty
+{
+  for (;;) {
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(fMutex);
+      while (fTasks.empty() && !fStopping) {
+        fTaskReady.wait(lock);
+      }
+      if (fTasks.empty()) {
+        return;
+      }
+      task = std::move(fTasks.front());
+      fTasks.pop_front();
+    }
+    task();
+  }
+}
@@ -18,29 +18,99 @@
 //
 #include <maya/MIOStream.h>
 #include <maya/MGlobal.h>
-#include <maya/MFnSet.h>
 #include <maya/MDagPath.h>
-#include <maya/MItDependencyGraph.h>
-#include <maya/MPlug.h>
-
-//Iterator Includes
-//
-#include <maya/MItMeshPolygon.h>
+#include <maya/MFnMesh.h>
 
 //Header File
 //
 #include "WriterModel.h"
 
-
-WriterModel::WriterModel(MDagPath dagPath, MStatus& status)
-//Summary:	Constructor - creates the MDagPath and MFnMesh objects necessary
-//			for extracting the data
-//Args   :	dagPath - the dagPath where the mesh is located=
-//			status - will be set to MStatus::kSuccess if the creation of the 
-//			MFnMesh is successful; MStatus::kFailure otherwise
+#include <algorithm>
+#include <cstring>
+
+
+WriterModel::WriterModel(const MDagPath& dagPath, const ExportOptions& options, MStatus& status) :
+	fOptions(options),
+	fSlicePool(NULL),
+	fTrace(NULL),
+	fReport(NULL),
+	fCapture(NULL),
+	fMesh(NULL),
+	fShaderCache(&fOwnShaderCache)
+//Summary:	Constructor - keeps the MDagPath the data is extracted from; the
+//			MFnMesh is created by extractGeometry()
+//Args   :	dagPath - the dagPath where the mesh is located
+//			options - the settings of the current export
+//			status - set to MStatus::kSuccess
 {
 	fDagPath = new MDagPath(dagPath);
-	fMesh = new MFnMesh(*fDagPath, &status);
+	status = MStatus::kSuccess;
+}
+
+
+WriterModel::WriterModel(const MeshCapture& capture, const ExportOptions& options) :
+	fOptions(options),
+	fSlicePool(NULL),
+	fTrace(NULL),
+	fReport(NULL),
+	fCapture(NULL),
+	fShapeName(capture.shape),
+	fCurrentUVSetName(capture.currentUVSetName),
+	fMesh(NULL),
+	fDagPath(NULL),
+	fShaderCache(&fOwnShaderCache)
+//Summary:	Constructor - restores what extractGeometry() gathered from a
+//			capture, so that writeToFile() can run without Maya.  The space
+//			of the capture overrides the localSpace option, and channels
+//			the capture does not hold are switched off.  extractGeometry()
+//			must not be called.
+//Args   :	capture - a capture of the mesh, see captureGeometry()
+//			options - the settings to encode with
+{
+	const MeshSnapshot& snapshot = capture.snapshot;
+	fOptions.localSpace = capture.localSpace;
+	fOptions.normals = fOptions.normals && !capture.faceNormalIds.empty();
+	fOptions.uvs = fOptions.uvs && !capture.uvSets.empty();
+	fOptions.tangents = fOptions.tangents && 0 != snapshot.tangents.length();
+	fOptions.binormals = fOptions.binormals && 0 != snapshot.binormals.length();
+	fOptions.sets = fOptions.sets && !capture.sets.empty();
+
+	std::memcpy(fWorldMatrix, capture.worldMatrix, sizeof(fWorldMatrix));
+	fSnapshot.positions = snapshot.positions;
+	if (fOptions.normals) {
+		fSnapshot.normals = snapshot.normals;
+		fFaceNormalIds = capture.faceNormalIds;
+	}
+	if (fOptions.tangents) {
+		fSnapshot.tangents = snapshot.tangents;
+	}
+	if (fOptions.binormals) {
+		fSnapshot.binormals = snapshot.binormals;
+	}
+
+	fFaceVertexCounts = capture.faceVertexCounts;
+	fFaceVertexIds = capture.faceVertexIds;
+	fTriangleCounts = capture.triangleCounts;
+	fTriangleVertices = capture.triangleVertices;
+
+	size_t i;
+	if (fOptions.uvs) {
+		fUVSets.resize(capture.uvSets.size());
+		for (i = 0; i < fUVSets.size(); i++) {
+			fUVSets[i].name = capture.uvSets[i].name;
+			fUVSets[i].uArray = capture.uvSets[i].u;
+			fUVSets[i].vArray = capture.uvSets[i].v;
+			fUVSets[i].faceUVIds = capture.uvSets[i].faceUVIds;
+		}
+	}
+
+	if (fOptions.sets) {
+		for (i = 0; i < capture.sets.size(); i++) {
+			fSetNames.push_back(capture.sets[i].name);
+			fSetFaceRanges.push_back(capture.sets[i].faceRanges);
+			fSetTextures.push_back(capture.sets[i].texture);
+		}
+	}
 }
 
 
@@ -51,70 +121,150 @@ WriterModel::~WriterModel()
 	if (NULL != fMesh) delete fMesh;
 }
 
-MStatus WriterModel::extractGeometry()
-//Summary:	extracts the main geometry (vertices, vertex colours, vertex normals) 
-//			of this polygonal mesh.  
-//Returns:  MStatus::kSuccess if the method succeeds
-//			MStatus::kFailure if the method fails
+
+void WriterModel::setShaderCache(ShaderCache* cache)
+//Summary:	shares the shading group lookups of the whole export; must be
+//			called before extractGeometry().  Without it every writer
+//			resolves its shading groups itself.
+//Args   :	cache - the export's cache, which must outlive extractGeometry()
 {
+	fShaderCache = cache;
+}
 
-	if (MStatus::kFailure == fMesh->getPoints(fVertexArray, MSpace::kWorld)) {
-		MGlobal::displayError("MFnMesh::getPoints");
-		return MStatus::kFailure;
-	}
 
-	/*if (MStatus::kFailure == fMesh->getFaceVertexColors(fColorArray)) {
-		MGlobal::displayError("MFnMesh::getFaceVertexColors");
-		return MStatus::kFailure;
-	}*/
+void WriterModel::setTrace(ExportTrace* trace)
+//Summary:	times the phases of this writer into the export's trace; must be
+//			called before extractGeometry()
+//Args   :	trace - the export's trace, or NULL to time nothing
+{
+	fTrace = trace;
+}
 
-  /*if (MStatus::kFailure == fMesh->getVertexNormals(true, fNormalArray, MSpace::kWorld)) {
-    MGlobal::displayError("MFnMesh::getVertexNormals ");
-    return MStatus::kFailure;
-  }*/
 
-	if (MStatus::kFailure == fMesh->getNormals(fNormalArray, MSpace::kWorld)) {
-		MGlobal::displayError("MFnMesh::getNormals"); 
-		return MStatus::kFailure;
-	}
+void WriterModel::setReport(ExportReport* report)
+//Summary:	accounts the bytes and buffer memory of this writer in the
+//			export's report; must be called before extractGeometry()
+//Args   :	report - the export's report, or NULL to account nothing
+{
+	fReport = report;
+}
 
-	if (MStatus::kFailure == fMesh->getCurrentUVSetName(fCurrentUVSetName)) {
-		MGlobal::displayError("MFnMesh::getCurrentUVSetName");
-		return MStatus::kFailure;
+
+void WriterModel::setCapture(CaptureWriter* capture)
+//Summary:	has extractGeometry() write what it gathered to the export's
+//			capture file; must be called before extractGeometry()
+//Args   :	capture - the export's capture file, or NULL to capture nothing
+{
+	fCapture = capture;
+}
+
+
+void WriterModel::captureGeometry(MeshCapture& capture) const
+//Summary:	copies everything extractGeometry() gathered into capture; the
+//			capture constructor restores it
+//Args   :	capture - set to the extracted data of this mesh
+{
+	size_t i;
+	capture.shape = fShapeName;
+	capture.localSpace = fOptions.localSpace;
+	std::memcpy(capture.worldMatrix, fWorldMatrix, sizeof(fWorldMatrix));
+	capture.snapshot = fSnapshot;
+
+	capture.faceVertexCounts = fFaceVertexCounts;
+	capture.faceVertexIds = fFaceVertexIds;
+	capture.faceNormalIds = fFaceNormalIds;
+	capture.triangleCounts = fTriangleCounts;
+	capture.triangleVertices = fTriangleVertices;
+	capture.currentUVSetName = fCurrentUVSetName;
+
+	capture.uvSets.resize(fUVSets.size());
+	for (i = 0; i < fUVSets.size(); i++) {
+		capture.uvSets[i].name = fUVSets[i].name;
+		capture.uvSets[i].u = fUVSets[i].uArray;
+		capture.uvSets[i].v = fUVSets[i].vArray;
+		capture.uvSets[i].faceUVIds = fUVSets[i].faceUVIds;
 	}
 
-	if (MStatus::kFailure == fMesh->getTangents(fTangentArray, MSpace::kWorld, &fCurrentUVSetName)) {
-		MGlobal::displayError("MFnMesh::getTangents");
-		return MStatus::kFailure;
+	capture.sets.resize(fSetNames.size());
+	for (i = 0; i < capture.sets.size(); i++) {
+		capture.sets[i].name = fSetNames[i];
+		capture.sets[i].texture = fSetTextures[i];
+		capture.sets[i].faceRanges = fSetFaceRanges[i];
 	}
+}
 
-	if (MStatus::kFailure == fMesh->getBinormals(fBinormalArray, MSpace::kWorld, &fCurrentUVSetName)) {
-		MGlobal::displayError("MFnMesh::getBinormals");
-		return MStatus::kFailure;
+
+void WriterModel::getTriangleFaces(std::vector<int>& triangleFaces) const
+//Summary:	maps every triangle of the triangulation in fTriangleVertices back
+//			to the face it was cut from.  Must be called after
+//			extractGeometry().
+//Args   :	triangleFaces - set to the face index of every triangle
+{
+	const unsigned int faceCount = static_cast<unsigned int>(fTriangleCounts.size());
+	triangleFaces.resize(fTriangleVertices.size() / 3);
+
+	unsigned int triangle = 0;
+	unsigned int i;
+	int j;
+	for (i = 0; i < faceCount; i++) {
+		for (j = 0; j < fTriangleCounts[i]; j++) {
+			triangleFaces[triangle++] = static_cast<int>(i);
+		}
 	}
+}
 
-	//Have to make the path include the shape below it so that
-	//we can determine if the underlying shape node is instanced.
-	//By default, dag paths only include transform nodes.
-	//
-	fDagPath->extendToShape();
 
-	//If the shape is instanced then we need to determine which
-	//instance this path refers to.
+void WriterModel::batchTrianglesBySet()
+//Summary:	orders the triangles of fTriangleVertices set after set into
+//			fTriangleOrder and records the range of every set in
+//			fSetTriangleRanges.  A face in several sets is drawn with the
+//			first of them; the triangles of faces in no set come last.
+//			Within a set the triangles keep their original order.  Must be
+//			called after extractGeometry().
+{
+	const unsigned int faceCount = static_cast<unsigned int>(fFaceVertexCounts.size());
+	const unsigned int setCount = static_cast<unsigned int>(fSetNames.size());
+
+	//the set every face is drawn with, setCount for none; the sets are
+	//walked backwards so the first set a face is in wins
 	//
-	int instanceNum = 0;
-	if (fDagPath->isInstanced())
-		instanceNum = fDagPath->instanceNumber();
+	std::vector<uint32_t> faceSet(faceCount, setCount);
+	unsigned int set;
+	for (set = setCount; set-- > 0;) {
+		const std::vector<uint32_t>& ranges = fSetFaceRanges[set];
+		size_t r;
+		for (r = 0; r < ranges.size(); r += 2) {
+			const uint32_t start = std::min(ranges[r], faceCount);
+			const uint32_t end = std::min(ranges[r] + ranges[r + 1], faceCount);
+			std::fill(faceSet.begin() + start, faceSet.begin() + end, set);
+		}
+	}
+
+	std::vector<int> triangleFaces;
+	getTriangleFaces(triangleFaces);
+	const unsigned int triangleCount = static_cast<unsigned int>(triangleFaces.size());
 
-	//Get the connected sets and members - these will be used to determine texturing of different
-	//faces
+	//a stable counting sort of the triangles by set
 	//
-	if (!fMesh->getConnectedSetsAndMembers(instanceNum, fPolygonSets, fPolygonComponents, true)) {
-		MGlobal::displayError("MFnMesh::getConnectedSetsAndMembers");
-		return MStatus::kFailure;
+	std::vector<uint32_t> first(setCount + 2, 0);
+	unsigned int t;
+	for (t = 0; t < triangleCount; t++) {
+		first[faceSet[triangleFaces[t]] + 1]++;
+	}
+	for (set = 0; set <= setCount; set++) {
+		first[set + 1] += first[set];
 	}
 
-	return MStatus::kSuccess;
+	fSetTriangleRanges.resize(2 * (setCount + 1));
+	for (set = 0; set <= setCount; set++) {
+		fSetTriangleRanges[2 * set] = first[set];
+		fSetTriangleRanges[2 * set + 1] = first[set + 1] - first[set];
+	}
+
+	fTriangleOrder.resize(triangleCount);
+	for (t = 0; t < triangleCount; t++) {
+		fTriangleOrder[first[faceSet[triangleFaces[t]]]++] = t;
+	}
 }
 
 
@@ -133,139 +283,153 @@ void WriterModel::outputTabs(ostream& os, unsigned int tabCount)
 
 
 
-MObject WriterModel::findShader(const MObject& setNode)
-//Summary:	finds the shading node for the given shading group set node
-//Args   :	setNode - the shading group set node
-//Returns:  the shader node for setNode if found;
-//			MObject::kNullObj otherwise
+
+MStatus WriterModel::outputSets(ostream& os)
+//Summary:	outputs this mesh's sets and each sets face components, and any 
+//			associated texture, as resolved by extractSets()
+//Args   :	os - an output stream to write to
+//Returns:	MStatus::kSuccess if set information was outputted
+//			MStatus::kFailure otherwise
 {
+	TraceScope scope(fTrace, "outputSets", fShapeName.c_str());
+	unsigned int i;
+	for (i = 0; i < fSetNames.size(); i++) {
+		if (MStatus::kFailure == outputSingleSet(os, i)) {
+			return MStatus::kFailure;
+		}
+	}
+	return MStatus::kSuccess;
+}
 
-	MFnDependencyNode fnNode(setNode);
-	MPlug shaderPlug = fnNode.findPlug("surfaceShader", true);
 
-	if (!shaderPlug.isNull()) {
-		MPlugArray connectedPlugs;
+bool WriterModel::encode(std::ostream& os, WorkerPool* pool)
+//Summary:	EncodeJob entry point; runs writeToFile(), possibly on a worker
+//			thread, letting it split its loops over pool
+{
+	TraceScope scope(fTrace, "encode", fShapeName.c_str());
+	if (NULL != fReport) {
+		fShapeReport.peakBufferBytes = heldBytes();
+	}
 
-		//get all the plugs that are connected as the destination of this 
-		//surfaceShader plug so we can find the surface shaderNode
-		//
-		MStatus status;
-		shaderPlug.connectedTo(connectedPlugs, true, false, &status);
-		if (MStatus::kFailure == status) {
-			MGlobal::displayError("MPlug::connectedTo");
-			return MObject::kNullObj;
-		}
+	fSlicePool = pool;
+	const bool succeeded = MStatus::kSuccess == writeToFile(os);
+	fSlicePool = NULL;
 
-		if (1 != connectedPlugs.length()) {
-			MGlobal::displayError("Error getting shader for: " + fMesh->partialPathName());
-		}
-		else {
-			return connectedPlugs[0].node();
-		}
+	//the buffers only grow while encoding, so with the extracted data this
+	//brackets the most they held
+	//
+	if (NULL != fReport) {
+		fShapeReport.peakBufferBytes = std::max<uint64_t>(fShapeReport.peakBufferBytes, heldBytes());
 	}
-
-	return MObject::kNullObj;
+	return succeeded;
 }
 
 
-
-
-MStatus WriterModel::outputSets(ostream& os)
-//Summary:	outputs this mesh's sets and each sets face components, and any 
-//			associated texture
-//Args   :	os - an output stream to write to
-//Returns:	MStatus::kSuccess if set information was outputted
-//			MStatus::kFailure otherwise
+void WriterModel::committed(bool succeeded)
+//Summary:	called on the main thread once this mesh's output was committed;
+//			shows the statistics and errors writeToFile() reported and adds
+//			this shape to the export's report
 {
-	MStatus status;
+	if (NULL != fReport && succeeded) {
+		fShapeReport.shape = fShapeName;
+		fReport->add(fShapeReport);
+	}
 
-	//if there is more than one set, the last set simply consists of all 
-	//polygons, so we won't include it
-	//
-	unsigned int setCount = fPolygonSets.length();
-	if (setCount > 1) {
-		setCount--;
+	size_t i;
+	for (i = 0; i < fInfos.size(); i++) {
+		MGlobal::displayInfo(MString(fInfos[i].c_str()));
+	}
+	for (i = 0; i < fErrors.size(); i++) {
+		MGlobal::displayError(MString(fErrors[i].c_str()));
 	}
+}
 
-	MIntArray faces;
 
-	unsigned int i;
-	for (i = 0; i < setCount; i++) {
-		MObject set = fPolygonSets[i];
-		MObject comp = fPolygonComponents[i];
-		MFnSet fnSet(set, &status);
-		if (MS::kFailure == status) {
-			MGlobal::displayError("MFnSet::MFnSet");
-			continue;
-		}
+void WriterModel::reportChannel(const std::string& name, std::ostream& os, std::streamoff start,
+	size_t elements, size_t rawBytes)
+//Summary:	accounts the bytes written to os since start to a channel of
+//			this shape's report; calls for the same channel add up.  Does
+//			nothing if the export has no report or nothing was written.
+//Args   :	name - the channel, e.g. "positions" or "uvs:map1"
+//			os - the stream the channel was written to
+//			start - os.tellp() before the channel was written
+//			elements - the number of values (vectors, indices, ...) written
+//			rawBytes - the size of those values as float32 / uint32 arrays
+{
+	if (NULL == fReport) {
+		return;
+	}
 
-		//Make sure the set is a polygonal set.  If not, continue.
-		MItMeshPolygon itMeshPolygon(*fDagPath, comp, &status);
+	const std::streamoff end = os.tellp();
+	const uint64_t bytes = start < 0 || end < start ? 0 : static_cast<uint64_t>(end - start);
+	if (0 == elements && 0 == bytes) {
+		return;    //a channel the export left out
+	}
 
-		if ((MS::kFailure == status)) {
-			MGlobal::displayError("MItMeshPolygon::MItMeshPolygon");
-			continue;
-		}
+	std::vector<ChannelReport>& channels = fShapeReport.channels;
+	size_t i = 0;
+	while (i < channels.size() && channels[i].name != name) {
+		i++;
+	}
+	if (i == channels.size()) {
+		ChannelReport channel;
+		channel.name = name;
+		channel.elements = 0;
+		channel.bytes = 0;
+		channel.rawBytes = 0;
+		channels.push_back(channel);
+	}
+	channels[i].elements += elements;
+	channels[i].bytes += bytes;
+	channels[i].rawBytes += rawBytes;
+}
 
-		//add the current set's face indices to the faces array
-		//
-		faces.setLength(itMeshPolygon.count());
 
-		unsigned int j = 0;
-		for (itMeshPolygon.reset(); !itMeshPolygon.isDone(); itMeshPolygon.next()) {
-			faces[j++] = itMeshPolygon.index();
-		}
+size_t WriterModel::heldBytes() const
+//Summary:	returns the bytes held by this writer's mesh buffers: the
+//			snapshot, the uv sets, the topology arrays and the sets.
+//			Writers with buffers of their own add theirs.
+{
+	size_t bytes = 0;
+	const Float3Stream* streams[] = { &fSnapshot.positions, &fSnapshot.normals,
+		&fSnapshot.tangents, &fSnapshot.binormals };
+	size_t i;
+	for (i = 0; i < sizeof(streams) / sizeof(streams[0]); i++) {
+		bytes += (streams[i]->x.capacity() + streams[i]->y.capacity() +
+			streams[i]->z.capacity()) * sizeof(float);
+	}
+	for (i = 0; i < fUVSets.size(); i++) {
+		bytes += (fUVSets[i].uArray.capacity() + fUVSets[i].vArray.capacity()) * sizeof(float);
+		bytes += fUVSets[i].faceUVIds.capacity() * sizeof(int);
+	}
 
-		//Find the texture that is applied to this set.  First, get the
-		//shading node connected to the set.  Then, if there is an input
-		//attribute called "color", search upstream from it for a texture
-		//file node.
-		//
-		MObject shaderNode = findShader(set);
-		if (MObject::kNullObj == shaderNode) {
-			continue;
-		}
+	bytes += (fFaceVertexCounts.capacity() + fFaceVertexIds.capacity() + fFaceNormalIds.capacity() +
+		fTriangleCounts.capacity() + fTriangleVertices.capacity()) * sizeof(int);
 
-		MPlug colorPlug = MFnDependencyNode(shaderNode).findPlug("color", true, &status);
-		if (MS::kFailure == status) {
-			MGlobal::displayError("MFnDependencyNode::findPlug");
-			continue;
-		}
+	for (i = 0; i < fSetFaceRanges.size(); i++) {
+		bytes += fSetFaceRanges[i].capacity() * sizeof(uint32_t);
+	}
+	bytes += (fTriangleOrder.capacity() + fSetTriangleRanges.capacity()) * sizeof(uint32_t);
+	return bytes;
+}
 
-		MItDependencyGraph itDG(colorPlug, MFn::kFileTexture,
-			MItDependencyGraph::kUpstream,
-			MItDependencyGraph::kBreadthFirst,
-			MItDependencyGraph::kNodeLevel,
-			&status);
 
-		if (MS::kFailure == status) {
-			MGlobal::displayError("MItDependencyGraph::MItDependencyGraph");
-			continue;
-		}
+void WriterModel::reportError(const std::string& message)
+//Summary:	records an error found while writing; it is displayed on the main
+//			thread once the output is committed, since writeToFile() may run
+//			on a worker thread where MGlobal must not be used.  May be called
+//			from several slices of one writer at once.
+{
+	std::lock_guard<std::mutex> lock(fMessageMutex);
+	fErrors.push_back(message);
+}
 
-		//disable automatic pruning so that we can locate a specific plug 
-		itDG.disablePruningOnFilter();
-
-		//If no texture file node was found, pass in an empty string as the texture filename 
-		//so that color information is outputted instead
-		//
-		MString textureName("");
-		if (itDG.isDone()) {
-			if (MStatus::kFailure == outputSingleSet(os, MString(fnSet.name()), faces, textureName)) {
-				return MStatus::kFailure;
-			}
-			//otherwise retrieve the filename and pass it in to output texture information
-			//
-		}
-		else {
-			MObject textureNode = itDG.currentItem();
-			MPlug filenamePlug = MFnDependencyNode(textureNode).findPlug("fileTextureName", true);
-			filenamePlug.getValue(textureName);
-			if (MStatus::kFailure == outputSingleSet(os, MString(fnSet.name()), faces, textureName)) {
-				return MStatus::kFailure;
-			}
 
-		}
-	}
-	return MStatus::kSuccess;
+void WriterModel::reportInfo(const std::string& message)
+//Summary:	records a message for the export log, such as statistics of the
+//			encoded data; like reportError() it is displayed on the main
+//			thread once the output is committed
+{
+	std::lock_guard<std::mutex> lock(fMessageMutex);
+	fInfos.push_back(message);
 }
@@ -0,0 +1,411 @@
+//-
+// ==========================================================================
+// Copyright 1995,2006,2008 Autodesk, Inc. All rights reserved.
+//
+// Use of this software is subject to the terms of the Autodesk
+// license agreement provided at the time of installation or download,
+// or which otherwise accompanies this software in either electronic
+// or hard copy form.
+// ==========================================================================
+//+
+
+//
+//
+
+//WriterModelMaya.cpp
+
+//The extraction half of polyWriter.cpp: every WriterModel method that calls
+//into Maya lives here, so that WriterModel.cpp and the encoders build
+//without it, see MeshCapture.h
+//
+
+//General Includes
+//
+#include <maya/MGlobal.h>
+#include <maya/MFnSet.h>
+#include <maya/MDagPath.h>
+#include <maya/MFnMesh.h>
+#include <maya/MMatrix.h>
+#include <maya/MPointArray.h>
+#include <maya/MFloatVectorArray.h>
+#include <maya/MFloatArray.h>
+#include <maya/MIntArray.h>
+#include <maya/MStringArray.h>
+#include <maya/MFnSingleIndexedComponent.h>
+
+//Header File
+//
+#include "WriterModel.h"
+
+#include <algorithm>
+
+
+namespace {
+
+void copyInts(const MIntArray& array, std::vector<int>& values)
+//Summary:	copies a Maya array into a plain buffer writeToFile() may read
+//			on a worker thread
+{
+	values.resize(array.length());
+	if (!values.empty()) {
+		array.get(&values[0]);
+	}
+}
+
+
+void appendFaceRanges(std::vector<int>& faces, std::vector<uint32_t>& ranges)
+//Summary:	sorts face indices and appends them as (start, count) runs of
+//			consecutive faces
+{
+	std::sort(faces.begin(), faces.end());
+	faces.erase(std::unique(faces.begin(), faces.end()), faces.end());
+
+	size_t i = 0;
+	while (i < faces.size()) {
+		size_t j = i + 1;
+		while (j < faces.size() && faces[j] == faces[j - 1] + 1) {
+			j++;
+		}
+		ranges.push_back(static_cast<uint32_t>(faces[i]));
+		ranges.push_back(static_cast<uint32_t>(j - i));
+		i = j;
+	}
+}
+
+}
+
+
+MStatus WriterModel::extractGeometry()
+//Summary:	extracts the main geometry (vertices, vertex colours, vertex normals) 
+//			of this polygonal mesh into fSnapshot, and its face topology with
+//			whole-mesh calls so that writers never have to query the mesh per
+//			face.
+//			Channels switched off in fOptions are not extracted; with the
+//			uvs option every UV set is extracted as well.  If a capture was
+//			set, the extracted data is written to it at the end.
+//			Runs on the main thread; everything writeToFile() needs must be
+//			gathered here.
+//Returns:  MStatus::kSuccess if the method succeeds
+//			MStatus::kFailure if the method fails, or if this writer was
+//			created from a capture
+{
+	if (NULL == fDagPath) {
+		return MStatus::kFailure;
+	}
+
+	MStatus status;
+	fMesh = new MFnMesh(*fDagPath, &status);
+	if (MStatus::kFailure == status) {
+		MGlobal::displayError("MFnMesh::MFnMesh");
+		return MStatus::kFailure;
+	}
+
+	fShapeName = fMesh->partialPathName().asChar();
+	MGlobal::displayInfo(MString("Exporting ") + fShapeName.c_str());
+	TraceScope scope(fTrace, "extractGeometry", fShapeName.c_str());
+
+	//Maya hands out object space data only, which is what the localSpace
+	//option writes; otherwise the world matrix is baked in by the transform
+	//kernels while the data is converted into fSnapshot, rather than by
+	//Maya one element at a time
+	//
+	const MMatrix worldMatrix = fDagPath->inclusiveMatrix();
+	worldMatrix.get(fWorldMatrix);
+	const bool bake = !fOptions.localSpace;
+
+	//the Maya arrays only live until they are converted into fSnapshot
+	//
+	MPointArray points;
+	if (MStatus::kFailure == fMesh->getPoints(points, MSpace::kObject)) {
+		MGlobal::displayError("MFnMesh::getPoints");
+		return MStatus::kFailure;
+	}
+	if (bake) {
+		snapshotPoints(points, worldMatrix, fSnapshot.positions);
+	}
+	else {
+		snapshotPoints(points, fSnapshot.positions);
+	}
+	points.clear();
+
+	/*if (MStatus::kFailure == fMesh->getFaceVertexColors(fColorArray)) {
+		MGlobal::displayError("MFnMesh::getFaceVertexColors");
+		return MStatus::kFailure;
+	}*/
+
+  /*if (MStatus::kFailure == fMesh->getVertexNormals(true, fNormalArray, MSpace::kWorld)) {
+    MGlobal::displayError("MFnMesh::getVertexNormals ");
+    return MStatus::kFailure;
+  }*/
+
+	//like the channels, the topology is copied out of the Maya arrays, which
+	//are not to be read on the worker writeToFile() may run on
+	//
+	MIntArray counts;
+	MIntArray ids;
+	if (MStatus::kFailure == fMesh->getVertices(counts, ids)) {
+		MGlobal::displayError("MFnMesh::getVertices");
+		return MStatus::kFailure;
+	}
+	copyInts(counts, fFaceVertexCounts);
+	copyInts(ids, fFaceVertexIds);
+
+	if (MStatus::kFailure == fMesh->getTriangleOffsets(counts, ids)) {
+		MGlobal::displayError("MFnMesh::getTriangleOffsets");
+		return MStatus::kFailure;
+	}
+	copyInts(counts, fTriangleCounts);
+	copyInts(ids, fTriangleVertices);
+
+	//every other channel is only extracted if the export asks for it
+	//
+	if (fOptions.normals) {
+		MFloatVectorArray normals;
+		if (MStatus::kFailure == fMesh->getNormals(normals, MSpace::kObject)) {
+			MGlobal::displayError("MFnMesh::getNormals");
+			return MStatus::kFailure;
+		}
+		snapshotVectors(normals, fSnapshot.normals);
+		if (bake) {
+			transformStream(fSnapshot.normals, worldMatrix.inverse().transpose());
+		}
+
+		if (MStatus::kFailure == fMesh->getNormalIds(counts, ids)) {
+			MGlobal::displayError("MFnMesh::getNormalIds");
+			return MStatus::kFailure;
+		}
+		copyInts(ids, fFaceNormalIds);
+
+		if (fFaceNormalIds.size() != fFaceVertexIds.size()) {
+			MGlobal::displayError("Face-vertex count mismatch for: " + fMesh->partialPathName());
+			return MStatus::kFailure;
+		}
+	}
+
+	MString currentUVSetName;
+	if (fOptions.uvs || fOptions.tangents || fOptions.binormals) {
+		if (MStatus::kFailure == fMesh->getCurrentUVSetName(currentUVSetName)) {
+			MGlobal::displayError("MFnMesh::getCurrentUVSetName");
+			return MStatus::kFailure;
+		}
+		fCurrentUVSetName = currentUVSetName.asChar();
+	}
+
+	if (fOptions.tangents) {
+		MFloatVectorArray tangents;
+		if (MStatus::kFailure == fMesh->getTangents(tangents, MSpace::kObject, &currentUVSetName)) {
+			MGlobal::displayError("MFnMesh::getTangents");
+			return MStatus::kFailure;
+		}
+		snapshotVectors(tangents, fSnapshot.tangents);
+		if (bake) {
+			transformStream(fSnapshot.tangents, worldMatrix);
+		}
+	}
+
+	if (fOptions.binormals) {
+		MFloatVectorArray binormals;
+		if (MStatus::kFailure == fMesh->getBinormals(binormals, MSpace::kObject, &currentUVSetName)) {
+			MGlobal::displayError("MFnMesh::getBinormals");
+			return MStatus::kFailure;
+		}
+		snapshotVectors(binormals, fSnapshot.binormals);
+		if (bake) {
+			transformStream(fSnapshot.binormals, worldMatrix);
+		}
+	}
+
+	//Have to make the path include the shape below it so that
+	//we can determine if the underlying shape node is instanced.
+	//By default, dag paths only include transform nodes.
+	//
+	fDagPath->extendToShape();
+
+	//If the shape is instanced then we need to determine which
+	//instance this path refers to.
+	//
+	int instanceNum = 0;
+	if (fDagPath->isInstanced())
+		instanceNum = fDagPath->instanceNumber();
+
+	//Get the connected sets and members - these will be used to determine texturing of different
+	//faces
+	//
+	if (fOptions.sets) {
+		if (!fMesh->getConnectedSetsAndMembers(instanceNum, fPolygonSets, fPolygonComponents, true)) {
+			MGlobal::displayError("MFnMesh::getConnectedSetsAndMembers");
+			return MStatus::kFailure;
+		}
+
+		if (MStatus::kFailure == extractSets()) {
+			return MStatus::kFailure;
+		}
+	}
+
+	if (fOptions.uvs && MStatus::kFailure == extractUVSets()) {
+		return MStatus::kFailure;
+	}
+
+	if (NULL != fCapture) {
+		MeshCapture capture;
+		captureGeometry(capture);
+		fCapture->write(capture);
+	}
+
+	return MStatus::kSuccess;
+}
+
+
+MStatus WriterModel::extractUVSets()
+//Summary:	extracts every UV set of the mesh into fUVSets: its coordinates
+//			and the uv index of every face-vertex.  Called by
+//			extractGeometry() once the topology is known.
+//Returns:  MStatus::kSuccess if the method succeeds
+//			MStatus::kFailure if the method fails
+{
+	TraceScope scope(fTrace, "extractUVSets", fShapeName.c_str());
+	MStringArray uvSetNames;
+	if (MStatus::kFailure == fMesh->getUVSetNames(uvSetNames)) {
+		MGlobal::displayError("MFnMesh::getUVSetNames");
+		return MStatus::kFailure;
+	}
+
+	unsigned int uvSetCount = uvSetNames.length();
+	fUVSets.resize(uvSetCount);
+
+	unsigned int i;
+	for (i = 0; i < uvSetCount; i++) {
+		UVSet& uvSet = fUVSets[i];
+		uvSet.name = uvSetNames[i].asChar();
+
+		MFloatArray uArray;
+		MFloatArray vArray;
+		if (MStatus::kFailure == fMesh->getUVs(uArray, vArray, &uvSetNames[i])) {
+			MGlobal::displayError("MFnMesh::getUVs");
+			return MStatus::kFailure;
+		}
+		snapshotFloats(uArray, uvSet.uArray);
+		snapshotFloats(vArray, uvSet.vArray);
+
+		if (MStatus::kFailure == getFaceVertexUVIds(uvSetNames[i], uvSet.faceUVIds)) {
+			return MStatus::kFailure;
+		}
+	}
+
+	return MStatus::kSuccess;
+}
+
+
+MStatus WriterModel::getFaceVertexUVIds(const MString& uvSetName, std::vector<int>& faceUVIds)
+//Summary:	retrieves the uv index of every face-vertex in the given UV set with
+//			a single MFnMesh::getAssignedUVs call.  Must be called once
+//			the face topology was extracted.
+//Args   :	uvSetName - the UV set to query
+//			faceUVIds - set to one uv index per face-vertex; -1 for
+//			face-vertices on faces that have no uvs in this set
+//Returns:  MStatus::kSuccess if the method succeeds
+//			MStatus::kFailure if the method fails
+{
+	MIntArray uvCounts;
+	MIntArray uvIds;
+	if (MStatus::kFailure == fMesh->getAssignedUVs(uvCounts, uvIds, &uvSetName)) {
+		MGlobal::displayError("MFnMesh::getAssignedUVs");
+		return MStatus::kFailure;
+	}
+
+	//getAssignedUVs only lists uvs for faces that have them, so expand it to
+	//one entry per face-vertex
+	//
+	const unsigned int faceCount = static_cast<unsigned int>(fFaceVertexCounts.size());
+	faceUVIds.resize(fFaceVertexIds.size());
+
+	unsigned int faceVertex = 0;
+	unsigned int uvId = 0;
+	unsigned int i, j;
+	for (i = 0; i < faceCount; i++) {
+		const int vertexCount = fFaceVertexCounts[i];
+		const bool assigned = uvCounts[i] == vertexCount;
+		for (j = 0; j < static_cast<unsigned int>(vertexCount); j++) {
+			faceUVIds[faceVertex++] = assigned ? uvIds[uvId++] : -1;
+		}
+		if (!assigned) {
+			uvId += uvCounts[i];
+		}
+	}
+
+	return MStatus::kSuccess;
+}
+
+MStatus WriterModel::extractSets()
+//Summary:	resolves this mesh's sets into their face components and any
+//			associated texture, so that outputSets() does not need Maya
+//Returns:	MStatus::kSuccess if set information was extracted
+//			MStatus::kFailure otherwise
+{
+	TraceScope scope(fTrace, "extractSets", fShapeName.c_str());
+	MStatus status;
+
+	//if there is more than one set, the last set simply consists of all 
+	//polygons, so we won't include it
+	//
+	unsigned int setCount = fPolygonSets.length();
+	if (setCount > 1) {
+		setCount--;
+	}
+
+	unsigned int i;
+	for (i = 0; i < setCount; i++) {
+		MObject set = fPolygonSets[i];
+		MObject comp = fPolygonComponents[i];
+		MFnSet fnSet(set, &status);
+		if (MS::kFailure == status) {
+			MGlobal::displayError("MFnSet::MFnSet");
+			continue;
+		}
+
+		//the texture of the shading group is looked up once per export, see
+		//ShaderCache
+		//
+		const ShaderCache::Entry& shader = fShaderCache->lookup(set);
+		if (!shader.resolved) {
+			continue;
+		}
+
+		//collect the set's faces in one call; a null or complete component
+		//stands for every face of the mesh.  Make sure the set is a
+		//polygonal set.  If not, continue.
+		//
+		MFnSingleIndexedComponent fnComponent;
+		if (!comp.isNull()) {
+			if (MS::kFailure == fnComponent.setObject(comp) ||
+				MFn::kMeshPolygonComponent != fnComponent.componentType()) {
+				continue;
+			}
+		}
+
+		std::vector<int> faces;
+		if (comp.isNull() || fnComponent.isComplete()) {
+			faces.resize(fFaceVertexCounts.size());
+			size_t j;
+			for (j = 0; j < faces.size(); j++) {
+				faces[j] = static_cast<int>(j);
+			}
+		}
+		else {
+			MIntArray elements;
+			if (MS::kFailure == fnComponent.getElements(elements)) {
+				MGlobal::displayError("MFnSingleIndexedComponent::getElements");
+				continue;
+			}
+			copyInts(elements, faces);
+		}
+
+		std::vector<uint32_t> ranges;
+		appendFaceRanges(faces, ranges);
+
+		fSetNames.push_back(fnSet.name().asChar());
+		fSetFaceRanges.push_back(ranges);
+		fSetTextures.push_back(shader.texture.asChar());
+	}
+	return MStatus::kSuccess;
+}
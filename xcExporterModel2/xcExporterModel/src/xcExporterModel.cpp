@@ -15,9 +15,14 @@
 //polyRawExporter.cpp
 #include <maya/MFnPlugin.h>
 #include <maya/MDagPath.h>
+#include <maya/MGlobal.h>
 
 #include "xcExporterModel.h"
 #include "xcWriterModel.h"
+#include "xcFormat.h"
+#include "xcbExporterModel.h"
+#include "TextFormatter.h"
+#include "ExportKernels.h"
 
 #include <sstream>
 
@@ -56,13 +61,33 @@ MStatus initializePlugin(MObject obj)
   MStatus status;
   MFnPlugin plugin(obj, PLUGIN_COMPANY, "4.5", "Any");
 
+  // Install the kernels built for the best instruction set this machine
+  // supports
+  //
+  bool forced;
+  const CpuLevel level = chooseCpuLevel(forced);
+  selectExportKernels(level);
+  MGlobal::displayInfo(MString("xcExporter: using ") + cpuLevelName(level) +
+    (forced ? " kernels (forced by XC_CPU_LEVEL)" : " kernels"));
+
   // Register the translator with the system
   //
   status = plugin.registerFileTranslator("xcExporter",
     "",
     xcExporterModel::creator,
     "",
-    "option1=1",
+    "normals=1;uvs=1;tangents=0;binormals=0;sets=1;triangulate=0;localSpace=0;instances=1;trace=0;report=0;capture=0;threads=-1;precision=-1",
+    true);
+  if (!status) {
+    status.perror("registerFileTranslator");
+    return status;
+  }
+
+  status = plugin.registerFileTranslator("xcbExporter",
+    "",
+    xcbExporterModel::creator,
+    "",
+    "normals=1;uvs=1;tangents=0;binormals=0;sets=1;triangulate=1;indexed=1;vertexCache=0;meshlets=0;quantize=0;localSpace=0;instances=1;trace=0;report=0;capture=0;threads=-1",
     true);
   if (!status) {
     status.perror("registerFileTranslator");
@@ -88,6 +113,12 @@ MStatus uninitializePlugin(MObject obj)
     return status;
   }
 
+  status = plugin.deregisterFileTranslator("xcbExporter");
+  if (!status) {
+    status.perror("deregisterFileTranslator");
+    return status;
+  }
+
   return status;
 }
 
@@ -111,5 +142,37 @@ WriterModel* xcExporterModel::createPolyWriter(const MDagPath dagPath, MStatus&
 //					 created successfully;  MStatus::kFailure otherwise
 //Returns:	pointer to the new polyWriter object
 {
-  return new xcWriterModel(dagPath, status);
+  return new xcWriterModel(dagPath, fOptions, status);
+}
+
+
+bool xcExporterModel::writeInstance(std::ostream& os, const InstanceRecord& instance) const
+//Summary:	outputs an instance as the name of the shape it instances and its
+//			world matrix, plus the matrix that takes the world space
+//			positions written for that shape onto this instance
+//Args   :	os - an output stream to write to
+//			instance - the instance to write
+//Returns:	true if the stream is still good
+{
+  TextFormatter out(os, fOptions.precision);
+  out << SHAPE_DIVIDER;
+  out << "Instance:  " << instance.name << "\n";
+  out << "Of:  " << instance.sourceName << "\n";
+  out << SHAPE_DIVIDER;
+
+  unsigned int i, j;
+  out << "World matrix:\n";
+  for (i = 0; i < 4; i++) {
+    for (j = 0; j < 4; j++) {
+      out << instance.worldMatrix[i][j] << (3 == j ? '\n' : '\t');
+    }
+  }
+  out << "Relative matrix:\n";
+  for (i = 0; i < 4; i++) {
+    for (j = 0; j < 4; j++) {
+      out << instance.relativeMatrix[i][j] << (3 == j ? '\n' : '\t');
+    }
+  }
+  out << "\n\n";
+  return out.flush();
 }
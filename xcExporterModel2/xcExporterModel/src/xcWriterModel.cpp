@@ -17,92 +17,51 @@
 //General Includes
 //
 #include <maya/MIOStream.h>
-#include <maya/MGlobal.h>
-#include <maya/MIntArray.h>
-#include <maya/MFnSet.h>
-#include <maya/MItDependencyGraph.h>
-#include <maya/MDagPath.h>
-#include <maya/MFnMesh.h>
-#include <maya/MPlug.h>
-#include <maya/MIOStream.h>
 #include <time.h>
 
-//Iterator Includes
-//
-#include <maya/MItMeshPolygon.h>
-
-
 //Header File
 //
 #include "xcWriterModel.h"
+#include "xcFormat.h"
+#include "SliceEncoder.h"
+#include "TextFormatter.h"
+
+#include <vector>
 
 //Macros
 //
 #define DELIMITER "\t"
-#define SHAPE_DIVIDER "*******************************************************************************\n"
 #define HEADER_LINE "===============================================================================\n"
 #define LINE "-------------------------------------------------------------------------------\n"
 
+//smallest number of faces, triangles or vectors formatted by one thread
+//
+#define MIN_SLICE_ITEMS 16384
+
 
-xcWriterModel::xcWriterModel(const MDagPath& dagPath, MStatus& status) :
-	WriterModel(dagPath, status),
-	fHeadUVSet(NULL)
+xcWriterModel::xcWriterModel(const MDagPath& dagPath, const ExportOptions& options, MStatus& status) :
+	WriterModel(dagPath, options, status)
 	//Summary:	creates and initializes an object of this class
 	//Args   :	dagPath - the DAG path of the current node
+	//			options - the settings of the current export
 	//			status - will be set to MStatus::kSuccess if the constructor was
 	//					 successful;  MStatus::kFailure otherwise
 {
 }
 
 
-xcWriterModel::~xcWriterModel()
-//Summary:  deletes the objects created by this class
+xcWriterModel::xcWriterModel(const MeshCapture& capture, const ExportOptions& options) :
+	WriterModel(capture, options)
+	//Summary:	creates a writer encoding a captured mesh
+	//Args   :	capture - the mesh, see WriterModel::captureGeometry()
+	//			options - the settings to encode with
 {
-	if (NULL != fHeadUVSet) delete fHeadUVSet;
 }
 
 
-MStatus xcWriterModel::extractGeometry()
-//Summary:	extracts main geometry as well as all UV sets and each set's
-//			coordinates
+xcWriterModel::~xcWriterModel()
+//Summary:  deletes the objects created by this class
 {
-
-	if (MStatus::kFailure == WriterModel::extractGeometry()) {
-		return MStatus::kFailure;
-	}
-
-	MStringArray uvSetNames;
-	if (MStatus::kFailure == fMesh->getUVSetNames(uvSetNames)) {
-		MGlobal::displayError("MFnMesh::getUVSetNames");
-		return MStatus::kFailure;
-	}
-
-	unsigned int uvSetCount = uvSetNames.length();
-	unsigned int i;
-
-	UVSet* currUVSet = NULL;
-
-	for (i = 0; i < uvSetCount; i++) {
-		if (0 == i) {
-			currUVSet = new UVSet;
-			fHeadUVSet = currUVSet;
-		}
-		else {
-			currUVSet->next = new UVSet;
-			currUVSet = currUVSet->next;
-		}
-
-		currUVSet->name = uvSetNames[i];
-		currUVSet->next = NULL;
-
-		// Retrieve the UV values
-		//
-		if (MStatus::kFailure == fMesh->getUVs(currUVSet->uArray, currUVSet->vArray, &currUVSet->name)) {
-			return MStatus::kFailure;
-		}
-	}
-
-	return MStatus::kSuccess;
 }
 
 
@@ -112,16 +71,25 @@ MStatus xcWriterModel::writeToFile(ostream& os)
 //Returns:  MStatus::kSuccess if the method succeeds
 //			MStatus::kFailure if the method fails
 {
-	MGlobal::displayInfo("Exporting " + fMesh->partialPathName());
-
 	os << SHAPE_DIVIDER;
-	os << "Shape:  " << fMesh->partialPathName() << "\n";
+	os << "Shape:  " << fShapeName << "\n";
 	os << SHAPE_DIVIDER;
 	os << "\n";
 
+	if (fOptions.localSpace && MStatus::kFailure == outputWorldMatrix(os)) {
+		return MStatus::kFailure;
+	}
+
+	//the bytes of every section are accounted for the export report; the
+	//Mesh_info rows interleave positions, normals and uvs, so they are one
+	//channel here
+	//
+	const size_t triangleCount = fOptions.triangulate ? fTriangleVertices.size() / 3 : 0;
+	std::streamoff start = os.tellp();
 	if (MStatus::kFailure == outputFaces(os)) {
 		return MStatus::kFailure;
 	}
+	reportChannel("indices", os, start, 4 * triangleCount, 4 * triangleCount * sizeof(uint32_t));
 
 	if (MStatus::kFailure == outputVertices(os)) {
 		return MStatus::kFailure;
@@ -135,59 +103,119 @@ MStatus xcWriterModel::writeToFile(ostream& os)
     return MStatus::kFailure;
   }
 
+  const size_t faceVertexCount = fFaceVertexIds.size();
+  const size_t faceVertexFloats = 3 + (fOptions.normals ? 3 : 0) + 2 * fUVSets.size();
+  start = os.tellp();
   if (MStatus::kFailure == outputVertexInfo(os)) {
     return MStatus::kFailure;
   }
+  reportChannel("faceVertices", os, start, faceVertexCount,
+    faceVertexCount * faceVertexFloats * sizeof(float));
 
-  /*if (MStatus::kFailure == outputTangents(os)) {
+  const size_t tangentCount = fSnapshot.tangents.length();
+  start = os.tellp();
+  if (fOptions.tangents && MStatus::kFailure == outputTangents(os)) {
     return MStatus::kFailure;
   }
+  reportChannel("tangents", os, start, tangentCount, 3 * tangentCount * sizeof(float));
 
-  if (MStatus::kFailure == outputBinormals(os)) {
+  const size_t binormalCount = fSnapshot.binormals.length();
+  start = os.tellp();
+  if (fOptions.binormals && MStatus::kFailure == outputBinormals(os)) {
     return MStatus::kFailure;
-  }*/
+  }
+  reportChannel("binormals", os, start, binormalCount, 3 * binormalCount * sizeof(float));
 
 	/*if (MStatus::kFailure == outputColors(os)) {
 		return MStatus::kFailure;
 	}*/
 
 
+	//the sets are compared with the face index lists their ranges replace
+	//
+	size_t setFaceCount = 0;
+	size_t set, r;
+	for (set = 0; set < fSetFaceRanges.size(); set++) {
+		for (r = 1; r < fSetFaceRanges[set].size(); r += 2) {
+			setFaceCount += fSetFaceRanges[set][r];
+		}
+	}
+	start = os.tellp();
 	if (MStatus::kFailure == outputSets(os)) {
 		return MStatus::kFailure;
 	}
+	reportChannel("sets", os, start, fSetNames.size(), setFaceCount * sizeof(uint32_t));
 	os << "\n\n";
 
 	return MStatus::kSuccess;
 }
 
 
-MStatus xcWriterModel::outputFaces(ostream& os)
-//Summary:	outputs the vertex indices that comprise each face
+MStatus xcWriterModel::outputWorldMatrix(ostream& os)
+//Summary:	outputs the world matrix of the shape, which the object space
+//			data of the localSpace option is relative to
 //Args   :	os - an output stream to write to
-//Returns:	MStatus::kSuccess if all faces were outputted
+//Returns:	MStatus::kSuccess if the matrix was outputted
 //			MStatus::kFailure otherwise
 {
+	TraceScope scope(fTrace, "outputWorldMatrix", fShapeName.c_str());
+	TextFormatter out(os, fOptions.precision);
+	out << "World matrix:\n";
+	unsigned int i, j;
+	for (i = 0; i < 4; i++) {
+		for (j = 0; j < 4; j++) {
+			out << fWorldMatrix[i][j] << (3 == j ? '\n' : '\t');
+		}
+	}
+	out << "\n";
+	return out.flush() ? MStatus::kSuccess : MStatus::kFailure;
+}
 
-  MIntArray triangleCounts;
-  
 
-  if (MStatus::kFailure == fMesh->getTriangles(triangleCounts, idexes)) {
-    return MStatus::kFailure;
+MStatus xcWriterModel::outputFaces(ostream& os)
+//Summary:	in triangulated mode, outputs the triangulation of every face as a
+//			compact triangle index list; each index is the row of the
+//			face-vertex in the Mesh_info section (counting from 0), and each
+//			triangle is followed by the face it was cut from.  The triangles
+//			are batched set after set, see batchTrianglesBySet().
+//Args   :	os - an output stream to write to
+//Returns:	MStatus::kSuccess if all faces were outputted
+//			MStatus::kFailure otherwise
+{
+  TraceScope scope(fTrace, "outputFaces", fShapeName.c_str());
+  if (!fOptions.triangulate) {
+    return MStatus::kSuccess;
   }
 
-  /*unsigned int tidexes = idexes.length();
+  batchTrianglesBySet();
 
-  MIntArray indexArray;
+  std::vector<int> triangleFaces;
+  getTriangleFaces(triangleFaces);
 
-  os << "Indices:  " << tidexes << "\n";
-  os << HEADER_LINE;
+  unsigned int triangleCount = static_cast<unsigned int>(triangleFaces.size());
 
-  for (unsigned int i = 0; i < tidexes; i += 3) {
-    os <<"I:" << DELIMITER <<  "(" << idexes[i] << ", "
-      << idexes[i + 1] << ", "
-      << idexes[i + 2] << ")" << "\n";
+  os << "Triangles:  " << triangleCount << "\n";
+  os << HEADER_LINE;
+  os << "Format: Triangle (a, b, c) | Face";
+  os << "\n";
+
+  SliceEncoder slices(fSlicePool, triangleCount, MIN_SLICE_ITEMS);
+  bool encoded = slices.encode(os, [&](size_t slice, std::ostream& sliceOs) {
+    unsigned int i;
+    for (i = static_cast<unsigned int>(slices.sliceBegin(slice));
+         i < slices.sliceEnd(slice); i++) {
+      const unsigned int triangle = fTriangleOrder[i];
+      sliceOs << "T:" << DELIMITER << "(" << fTriangleVertices[3 * triangle] << ", "
+        << fTriangleVertices[3 * triangle + 1] << ", "
+        << fTriangleVertices[3 * triangle + 2] << ")" << DELIMITER
+        << triangleFaces[triangle] << "\n";
+    }
+    return true;
+  });
+  if (!encoded) {
+    return MStatus::kFailure;
   }
-  os << "\n\n";*/
+  os << "\n\n";
 
 	return MStatus::kSuccess;
 }
@@ -199,7 +227,8 @@ MStatus xcWriterModel::outputVertices(ostream& os)
 //Returns:	MStatus::kSuccess if all vertex coordinates were outputted
 //			MStatus::kFailure otherwise
 {
-	unsigned int vertexCount = fVertexArray.length();
+	TraceScope scope(fTrace, "outputVertices", fShapeName.c_str());
+	unsigned int vertexCount = static_cast<unsigned int>(fSnapshot.positions.length());
 	unsigned i;
 
 	if (0 == vertexCount) {
@@ -212,9 +241,9 @@ MStatus xcWriterModel::outputVertices(ostream& os)
 	////os << LINE;
 	//for (i = 0; i < vertexCount; i++) {
 	//	os << "V:" << DELIMITER << "("
-	//		<< fVertexArray[i].x << ", "
-	//		<< fVertexArray[i].y << ", "
-	//		<< fVertexArray[i].z << ")\n";
+	//		<< fSnapshot.positions.x[i] << ", "
+	//		<< fSnapshot.positions.y[i] << ", "
+	//		<< fSnapshot.positions.z[i] << ")\n";
 	//}
 	//os << "\n\n";
 
@@ -229,11 +258,8 @@ MStatus xcWriterModel::outputVertexInfo(ostream& os)
 //Returns:	MStatus::kSuccess if all per face per vertex information was outputted
 //			MStatus::kFailure otherwise
 {
-	unsigned int faceCount = fMesh->numPolygons();
-	unsigned i, j, indexCount;
-
-	MStatus status;
-	MIntArray indexArray;
+	TraceScope scope(fTrace, "outputVertexInfo", fShapeName.c_str());
+	unsigned int faceCount = static_cast<unsigned int>(fFaceVertexCounts.size());
 
 	//output the header
 	os << "Mesh_info";
@@ -242,73 +268,97 @@ MStatus xcWriterModel::outputVertexInfo(ostream& os)
   os << "Faces:  " << faceCount << "\n";
 	os << HEADER_LINE;
 	/*os << "Format:  Face|faceVertexIndex|vertexIndex|normalIndex|colorIndex|";*/
-	os << "Format: Vertex (x, y, z) | Normal (x, y, z) | UV (x, y)";
+	os << "Format: Vertex (x, y, z)";
+	if (fOptions.normals) {
+		os << " | Normal (x, y, z)";
+	}
+	if (!fUVSets.empty()) {
+		os << " | UV (x, y)";
+	}
 	os << "\n";
 
 	//Add each uv set to the header
-	UVSet* currUVSet;
-	/*for (currUVSet = fHeadUVSet; currUVSet != NULL; currUVSet = currUVSet->next) {
-		os << "| UV_" << currUVSet->name;
+	/*for (s = 0; s < fUVSets.size(); s++) {
+		os << "| UV_" << fUVSets[s].name;
 	}
 	os << "\n";*/
 
 	//os << LINE;
 
-	MIntArray normalIndexArray;
-	int colorIndex, uvID;
+	//all per face-vertex data was extracted up front, so this loop only reads
+	//the flat arrays and never calls back into the API.  That lets the faces
+	//be cut into slices formatted by separate threads; the first face-vertex
+	//of every slice is the prefix sum of the face sizes of the slices before
+	//it
+	//
+	SliceEncoder slices(fSlicePool, faceCount, MIN_SLICE_ITEMS);
+
+	std::vector<size_t> firstFaceVertex(slices.sliceCount());
+	slices.forEachSlice([&](size_t slice) {
+		size_t faceVertexCount = 0;
+		unsigned int face;
+		for (face = static_cast<unsigned int>(slices.sliceBegin(slice));
+			face < slices.sliceEnd(slice); face++) {
+			faceVertexCount += fFaceVertexCounts[face];
+		}
+		firstFaceVertex[slice] = faceVertexCount;
+	});
+	SliceEncoder::prefixSum(firstFaceVertex);
 
-	for (i = 0; i < faceCount; i++) {
+	const Float3Stream& positions = fSnapshot.positions;
+	const Float3Stream& normals = fSnapshot.normals;
+	const UVSet* uvSets = fUVSets.empty() ? NULL : &fUVSets[0];
+	const size_t uvSetCount = fUVSets.size();
 
-		indexCount = fMesh->polygonVertexCount(i, &status);
-		if (MStatus::kFailure == status) {
-			MGlobal::displayError("MFnMesh::polygonVertexCount");
-			return MStatus::kFailure;
-		}
+	bool encoded = slices.encode(os, [&](size_t slice, std::ostream& sliceOs) {
+		TextFormatter out(sliceOs, fOptions.precision);
+		unsigned int faceVertex = static_cast<unsigned int>(firstFaceVertex[slice]);
+		unsigned int i, j, indexCount;
+		int uvID;
+		size_t s;
 
-		status = fMesh->getPolygonVertices(i, indexArray);
-		if (MStatus::kFailure == status) {
-			MGlobal::displayError("MFnMesh::getPolygonVertices");
-			return MStatus::kFailure;
-		}
+		for (i = static_cast<unsigned int>(slices.sliceBegin(slice)); i < slices.sliceEnd(slice); i++) {
 
-		status = fMesh->getFaceNormalIds(i, normalIndexArray);
-		if (MStatus::kFailure == status) {
-			MGlobal::displayError("MFnMesh::getFaceNormalIds");
-			return MStatus::kFailure;
-		}
+			indexCount = fFaceVertexCounts[i];
+
+			for (j = 0; j < indexCount; j++, faceVertex++) {
 
-		for (j = 0; j < indexCount; j++) {
-			status = fMesh->getFaceVertexColorIndex(i, j, colorIndex);
-
-			//output the face, face vertex index, vertex index, normal index, color index
-			//for the current vertex on the current face
-
-			
-      os << "(" << fVertexArray[indexArray[j]].x << ", " //Vertex
-         << fVertexArray[indexArray[j]].y << ", "
-         << fVertexArray[indexArray[j]].z << ")" << DELIMITER
-         << "(" << fNormalArray[i].x << ", " //Normals
-         << fNormalArray[i].y << ", "
-         << fNormalArray[i].z << ")" << DELIMITER;
-
-			/*os << i << DELIMITER << j << DELIMITER << indexArray[j] << DELIMITER
-				<< normalIndexArray[j] << DELIMITER << colorIndex << DELIMITER;*/
-
-			//output each uv set index for the current vertex on the current face
-			for (currUVSet = fHeadUVSet; currUVSet != NULL; currUVSet = currUVSet->next) {
-				status = fMesh->getPolygonUVid(i, j, uvID, &currUVSet->name);
-				if (MStatus::kFailure == status) {
-					MGlobal::displayError("MFnMesh::getPolygonUVid");
-					return MStatus::kFailure;
+				//output the face, face vertex index, vertex index, normal index, color index
+				//for the current vertex on the current face
+
+				const int vertex = fFaceVertexIds[faceVertex];
+
+				out << "(" << positions.x[vertex] << ", " //Vertex
+					<< positions.y[vertex] << ", "
+					<< positions.z[vertex] << ")" << DELIMITER;
+
+				if (fOptions.normals) {
+					const int normal = fFaceNormalIds[faceVertex];
+					out << "(" << normals.x[normal] << ", " //Normals
+						<< normals.y[normal] << ", "
+						<< normals.z[normal] << ")" << DELIMITER;
+				}
+
+				//output each uv set index for the current vertex on the current face
+				for (s = 0; s < uvSetCount; s++) {
+					const UVSet& uvSet = uvSets[s];
+					uvID = uvSet.faceUVIds[faceVertex];
+					if (uvID < 0) {
+						reportError("No uv in set " + uvSet.name + " for: " + fShapeName);
+						return false;
+					}
+					out << "(" << uvSet.uArray[uvID] << ", " << uvSet.vArray[uvID] << ")"
+						<< DELIMITER;
 				}
-				//os << DELIMITER << uvID;
-        os << "(" << currUVSet->uArray[uvID] << ", " << currUVSet->vArray[uvID] << ")"
-					 << DELIMITER;
+				out << "\n";
 			}
-			os << "\n";
-		}
 
-		os << "\n";
+			out << "\n";
+		}
+		return out.flush();
+	});
+	if (!encoded) {
+		return MStatus::kFailure;
 	}
 	os << "\n";
 
@@ -322,7 +372,12 @@ MStatus xcWriterModel::outputNormals(ostream& os)
 //Returns:	MStatus::kSuccess if all normals were outputted
 //			MStatus::kFailure otherwise
 {
-	unsigned int normalCount = fNormalArray.length();
+	TraceScope scope(fTrace, "outputNormals", fShapeName.c_str());
+	if (!fOptions.normals) {
+		return MStatus::kSuccess;
+	}
+
+	unsigned int normalCount = static_cast<unsigned int>(fSnapshot.normals.length());
 	if (0 == normalCount) {
 		return MStatus::kFailure;
 	}
@@ -335,9 +390,9 @@ MStatus xcWriterModel::outputNormals(ostream& os)
 	//unsigned int i;
 	//for (i = 0; i < normalCount; i++) {
 	//	os << "N:" << DELIMITER << "("
-	//		<< fNormalArray[i].x << ", "
-	//		<< fNormalArray[i].y << ", "
-	//		<< fNormalArray[i].z << ")\n";
+	//		<< fSnapshot.normals.x[i] << ", "
+	//		<< fSnapshot.normals.y[i] << ", "
+	//		<< fSnapshot.normals.z[i] << ")\n";
 	//}
 	//os << "\n\n";
 
@@ -350,7 +405,9 @@ MStatus xcWriterModel::outputTangents(ostream& os)
 //Returns:	MStatus::kSuccess if all normals were outputted
 //			MStatus::kFailure otherwise
 {
-	unsigned int tangentCount = fTangentArray.length();
+	TraceScope scope(fTrace, "outputTangents", fShapeName.c_str());
+	const Float3Stream& tangents = fSnapshot.tangents;
+	unsigned int tangentCount = static_cast<unsigned int>(tangents.length());
 	if (0 == tangentCount) {
 		return MStatus::kFailure;
 	}
@@ -360,12 +417,20 @@ MStatus xcWriterModel::outputTangents(ostream& os)
 	os << "Format:  Index|[x, y, z]\n";
 	os << LINE;
 
-	unsigned int i;
-	for (i = 0; i < tangentCount; i++) {
-		os << i << DELIMITER << "["
-			<< fTangentArray[i].x << ", "
-			<< fTangentArray[i].y << ", "
-			<< fTangentArray[i].z << "]\n";
+	SliceEncoder slices(fSlicePool, tangentCount, MIN_SLICE_ITEMS);
+	bool encoded = slices.encode(os, [&](size_t slice, std::ostream& sliceOs) {
+		TextFormatter out(sliceOs, fOptions.precision);
+		unsigned int i;
+		for (i = static_cast<unsigned int>(slices.sliceBegin(slice)); i < slices.sliceEnd(slice); i++) {
+			out << i << DELIMITER << "["
+				<< tangents.x[i] << ", "
+				<< tangents.y[i] << ", "
+				<< tangents.z[i] << "]\n";
+		}
+		return out.flush();
+	});
+	if (!encoded) {
+		return MStatus::kFailure;
 	}
 	os << "\n\n";
 
@@ -378,7 +443,9 @@ MStatus xcWriterModel::outputBinormals(ostream& os)
 //Returns:	MStatus::kSuccess if all normals were outputted
 //			MStatus::kFailure otherwise
 {
-	unsigned int binormalCount = fBinormalArray.length();
+	TraceScope scope(fTrace, "outputBinormals", fShapeName.c_str());
+	const Float3Stream& binormals = fSnapshot.binormals;
+	unsigned int binormalCount = static_cast<unsigned int>(binormals.length());
 	if (0 == binormalCount) {
 		return MStatus::kFailure;
 	}
@@ -388,12 +455,20 @@ MStatus xcWriterModel::outputBinormals(ostream& os)
 	os << "Format:  Index|[x, y, z]\n";
 	os << LINE;
 
-	unsigned int i;
-	for (i = 0; i < binormalCount; i++) {
-		os << i << DELIMITER << "["
-			<< fBinormalArray[i].x << ", "
-			<< fBinormalArray[i].y << ", "
-			<< fBinormalArray[i].z << "]\n";
+	SliceEncoder slices(fSlicePool, binormalCount, MIN_SLICE_ITEMS);
+	bool encoded = slices.encode(os, [&](size_t slice, std::ostream& sliceOs) {
+		TextFormatter out(sliceOs, fOptions.precision);
+		unsigned int i;
+		for (i = static_cast<unsigned int>(slices.sliceBegin(slice)); i < slices.sliceEnd(slice); i++) {
+			out << i << DELIMITER << "["
+				<< binormals.x[i] << ", "
+				<< binormals.y[i] << ", "
+				<< binormals.z[i] << "]\n";
+		}
+		return out.flush();
+	});
+	if (!encoded) {
+		return MStatus::kFailure;
 	}
 	os << "\n\n";
 
@@ -436,22 +511,24 @@ MStatus xcWriterModel::outputUVs(ostream& os)
 //Returns:	MStatus::kSuccess if UV coordinates for all UV sets were outputted
 //			MStatus::kFailure otherwise
 {
-  /*UVSet* currUVSet;
+  TraceScope scope(fTrace, "outputUVs", fShapeName.c_str());
+  /*size_t s;
   unsigned int i, uvCount;
-  for (currUVSet = fHeadUVSet; currUVSet != NULL; currUVSet = currUVSet->next) {
-    if (currUVSet->name == fCurrentUVSetName) {
+  for (s = 0; s < fUVSets.size(); s++) {
+    const UVSet& uvSet = fUVSets[s];
+    if (uvSet.name == fCurrentUVSetName) {
       os << "Current ";
     }
 
-    os << "UV Set:  " << currUVSet->name << "\n";
-    uvCount = currUVSet->uArray.length();
+    os << "UV Set:  " << uvSet.name << "\n";
+    uvCount = static_cast<unsigned int>(uvSet.uArray.size());
     os << "UV Count:  " << uvCount << "\n";
     os << HEADER_LINE;
     os << "Format:  Index|(u, v)\n";
     os << LINE;
     for (i = 0; i < uvCount; i++) {
-      os << "UV:" << DELIMITER << "(" << currUVSet->uArray[i] << ", "
-          << currUVSet->vArray[i] << ")\n";
+      os << "UV:" << DELIMITER << "(" << uvSet.uArray[i] << ", "
+          << uvSet.vArray[i] << ")\n";
     }
     os << "\n";
   }
@@ -460,27 +537,32 @@ MStatus xcWriterModel::outputUVs(ostream& os)
 }
 
 
-MStatus xcWriterModel::outputSingleSet(ostream& os, MString setName, MIntArray faces, MString textureName)
-//Summary:	outputs this mesh's sets and each sets face components, and any 
-//			associated texture
+MStatus xcWriterModel::outputSingleSet(ostream& os, unsigned int set)
+//Summary:	outputs one of this mesh's sets: its faces as (start, count)
+//			ranges, in triangulated mode the range of its rows in the
+//			Triangles section, and any associated texture
 //Args   :	os - an output stream to write to
+//			set - index of the set in fSetNames
 //Returns:	MStatus::kSuccess if set information was outputted
 //			MStatus::kFailure otherwise
 {
-	unsigned int i;
-	unsigned int faceCount = faces.length();
-
-	//os << "Set:  " << setName << "\n";
-	os << HEADER_LINE;
-	os << "Faces:  ";
-	for (i = 0; i < faceCount; i++) {
-		os << faces[i] << " ";
+	const std::vector<uint32_t>& faceRanges = fSetFaceRanges[set];
+	const std::string& textureName = fSetTextures[set];
+	TextFormatter out(os, fOptions.precision);
+
+	//out << "Set:  " << fSetNames[set] << "\n";
+	out << HEADER_LINE;
+	out << "Face ranges (start, count):  ";
+	size_t i;
+	for (i = 0; i < faceRanges.size(); i += 2) {
+		out << '(' << faceRanges[i] << ", " << faceRanges[i + 1] << ") ";
 	}
-	os << "\n";
-	if (textureName == "") {
-		textureName = "none";
+	out << '\n';
+	if (fOptions.triangulate) {
+		out << "Triangles (start, count):  (" << fSetTriangleRanges[2 * set] << ", "
+			<< fSetTriangleRanges[2 * set + 1] << ")\n";
 	}
-	os << "Texture File: " << textureName << "\n";
-	os << "\n\n";
-	return MStatus::kSuccess;
+	out << "Texture File: " << (textureName.empty() ? "none" : textureName.c_str()) << "\n";
+	out << "\n\n";
+	return out.flush() ? MStatus::kSuccess : MStatus::kFailure;
 }
@@ -0,0 +1,96 @@
+//
+//
+
+//xcbExporterModel.cpp
+#include <maya/MDagPath.h>
+
+#include "xcbExporterModel.h"
+#include "xcbWriterModel.h"
+#include "xcbFormat.h"
+
+#include <ostream>
+
+xcbExporterModel::~xcbExporterModel()
+{
+  //Summary:  destructor method; does nothing
+  //
+}
+
+
+void* xcbExporterModel::creator()
+//Summary:  allows Maya to allocate an instance of this object
+{
+  return new xcbExporterModel();
+}
+
+
+MString xcbExporterModel::defaultExtension() const
+//Summary:	called when Maya needs to know the preferred extension of this file
+//			format.  Note that the period should *not* be included in the
+//			extension.
+//Returns:  "xcb"
+{
+  return MString("xcb");
+}
+
+
+ExportOptions xcbExporterModel::defaultOptions() const
+//Summary:	the binary container is meant for GPU loaders, so it carries the
+//			triangulation unless told otherwise
+{
+  ExportOptions options;
+  options.triangulate = true;
+  return options;
+}
+
+
+bool xcbExporterModel::isBinary() const
+//Summary:	the xcb container must be written without newline translation
+//Returns:  true
+{
+  return true;
+}
+
+
+void xcbExporterModel::writeHeader(std::ostream& os)
+//Summary:	outputs the xcb file header
+//Args   :	os - an output stream to write to
+{
+  xcb::writeFileHeader(os);
+}
+
+
+void xcbExporterModel::writeFooter(std::ostream& os)
+//Summary:	outputs the chunk that terminates the xcb file
+//Args   :	os - an output stream to write to
+{
+  xcb::writeChunk(os, xcb::kEnd, 0, NULL, 0);
+}
+
+
+WriterModel* xcbExporterModel::createPolyWriter(const MDagPath dagPath, MStatus& status)
+//Summary:	creates a polyWriter for the xcb export file type
+//Args   :	dagPath - the current polygon dag path
+//			status - will be set to MStatus::kSuccess if the polyWriter was
+//					 created successfully;  MStatus::kFailure otherwise
+//Returns:	pointer to the new polyWriter object
+{
+  return new xcbWriterModel(dagPath, fOptions, status);
+}
+
+
+bool xcbExporterModel::writeInstance(std::ostream& os, const InstanceRecord& instance) const
+//Summary:	outputs an instance as a reference to the exported shape and its
+//			matrices
+//Args   :	os - an output stream to write to
+//			instance - the instance to write
+//Returns:	true if the stream is still good
+{
+  xcb::writeStringChunk(os, xcb::kInstance, instance.name.c_str(), instance.name.size());
+  xcb::writeStringChunk(os, xcb::kInstanceOf, instance.sourceName.c_str(), instance.sourceName.size());
+  xcb::writeChunk(os, xcb::kWorldMatrix, 16,
+    instance.worldMatrix, sizeof(instance.worldMatrix));
+  xcb::writeChunk(os, xcb::kRelativeMatrix, 16,
+    instance.relativeMatrix, sizeof(instance.relativeMatrix));
+  return !!os;
+}
@@ -0,0 +1,60 @@
+//
+//
+
+//xcbFormat.cpp
+
+#include "xcbFormat.h"
+
+#include <ostream>
+
+namespace xcb {
+
+void writeFileHeader(std::ostream& os)
+//Summary:	writes the file header; must be the first thing in the file
+//Args   :	os - an output stream to write to
+{
+  FileHeader header;
+  header.magic = kMagic;
+  header.version = kVersion;
+  header.alignment = kAlignment;
+  header.reserved = 0;
+  os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+
+void writeChunk(std::ostream& os, uint32_t id, uint32_t count,
+                const void* data, uint64_t size)
+//Summary:	writes a chunk header followed by its payload, padded so that the
+//			next chunk starts on a kAlignment boundary
+//Args   :	os - an output stream to write to
+//			id - one of the ChunkId values
+//			count - number of elements in the payload
+//			data - the payload
+//			size - payload size in bytes
+{
+  static const char padding[kAlignment] = {};
+
+  ChunkHeader header;
+  header.id = id;
+  header.count = count;
+  header.size = size;
+  os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  if (0 != size) {
+    os.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+  }
+
+  const uint64_t remainder = size % kAlignment;
+  if (0 != remainder) {
+    os.write(padding, static_cast<std::streamsize>(kAlignment - remainder));
+  }
+}
+
+
+void writeStringChunk(std::ostream& os, uint32_t id, const char* str, size_t length)
+//Summary:	writes a chunk holding a string, without a terminating null
+{
+  writeChunk(os, id, static_cast<uint32_t>(length), str, length);
+}
+
+}
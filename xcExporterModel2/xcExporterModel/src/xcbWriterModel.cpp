@@ -0,0 +1,822 @@
+//
+//
+
+//xcbWriterModel.cpp
+
+//Header File
+//
+#include "xcbWriterModel.h"
+#include "xcbFormat.h"
+#include "VertexWelder.h"
+#include "ExportKernels.h"
+#include "VertexCache.h"
+#include "MeshletBuilder.h"
+#include "Quantize.h"
+
+#include <algorithm>
+#include <cstring>
+#include <ostream>
+#include <sstream>
+#include <string>
+
+
+xcbWriterModel::xcbWriterModel(const MDagPath& dagPath, const ExportOptions& options, MStatus& status) :
+	WriterModel(dagPath, options, status),
+	fVertexStride(0),
+	fPositionLow(),
+	fPositionHigh(),
+	fQuantization()
+	//Summary:	creates and initializes an object of this class
+	//Args   :	dagPath - the DAG path of the current node
+	//			options - the settings of the current export
+	//			status - will be set to MStatus::kSuccess if the constructor was
+	//					 successful;  MStatus::kFailure otherwise
+{
+}
+
+
+xcbWriterModel::xcbWriterModel(const MeshCapture& capture, const ExportOptions& options) :
+	WriterModel(capture, options),
+	fVertexStride(0),
+	fPositionLow(),
+	fPositionHigh(),
+	fQuantization()
+	//Summary:	creates a writer encoding a captured mesh
+	//Args   :	capture - the mesh, see WriterModel::captureGeometry()
+	//			options - the settings to encode with
+{
+}
+
+
+xcbWriterModel::~xcbWriterModel()
+//Summary:  deletes the objects created by this class
+{
+}
+
+
+MStatus xcbWriterModel::writeToFile(std::ostream& os)
+//Summary:	outputs the geometry of this polygonal mesh as xcb chunks
+//Args   :	os - an output stream to write to
+//Returns:  MStatus::kSuccess if the method succeeds
+//			MStatus::kFailure if the method fails
+{
+	xcb::writeStringChunk(os, xcb::kShape, fShapeName.c_str(), fShapeName.size());
+	if (fOptions.localSpace) {
+		xcb::writeChunk(os, xcb::kWorldMatrix, 16, fWorldMatrix, sizeof(fWorldMatrix));
+	}
+
+	//the bytes of every channel are accounted for the export report; uv
+	//sets, the welded vertices and the meshlets account themselves.  With
+	//the welded vertex table, positions, normals and uvs only go out as
+	//part of it.
+	//
+	const bool vertexTable = writesVertexTable();
+	const size_t positionCount = vertexTable ? 0 : fSnapshot.positions.length();
+	std::streamoff start = os.tellp();
+	if (MStatus::kFailure == outputPositions(os)) {
+		return MStatus::kFailure;
+	}
+	reportChannel("positions", os, start, positionCount, 3 * positionCount * sizeof(float));
+
+	const size_t normalCount = vertexTable || !fOptions.normals ? 0 : fSnapshot.normals.length();
+	start = os.tellp();
+	if (MStatus::kFailure == outputNormals(os)) {
+		return MStatus::kFailure;
+	}
+	reportChannel("normals", os, start, normalCount, 3 * normalCount * sizeof(float));
+
+	const size_t tangentCount = fSnapshot.tangents.length() + fSnapshot.binormals.length();
+	start = os.tellp();
+	if (MStatus::kFailure == outputTangents(os)) {
+		return MStatus::kFailure;
+	}
+	reportChannel("tangents", os, start, tangentCount, 3 * tangentCount * sizeof(float));
+
+	const size_t faceIndexCount = fFaceVertexCounts.size() + (vertexTable ? 0 :
+		fFaceVertexIds.size() + (fOptions.normals ? fFaceNormalIds.size() : 0));
+	start = os.tellp();
+	if (MStatus::kFailure == outputFaces(os)) {
+		return MStatus::kFailure;
+	}
+	reportChannel("indices", os, start, faceIndexCount, faceIndexCount * sizeof(uint32_t));
+
+	if (MStatus::kFailure == outputUVs(os)) {
+		return MStatus::kFailure;
+	}
+
+	if (MStatus::kFailure == outputIndexedVertices(os)) {
+		return MStatus::kFailure;
+	}
+
+	start = os.tellp();
+	if (MStatus::kFailure == outputTriangles(os)) {
+		return MStatus::kFailure;
+	}
+	reportChannel("indices", os, start, fTriangles.size() + fTriangleFaces.size(),
+		(fTriangles.size() + fTriangleFaces.size()) * sizeof(uint32_t));
+
+	if (MStatus::kFailure == outputMeshlets(os)) {
+		return MStatus::kFailure;
+	}
+
+	//the sets are compared with the face index lists their ranges replace
+	//
+	size_t setFaceCount = 0;
+	size_t set, r;
+	for (set = 0; set < fSetFaceRanges.size(); set++) {
+		for (r = 1; r < fSetFaceRanges[set].size(); r += 2) {
+			setFaceCount += fSetFaceRanges[set][r];
+		}
+	}
+	start = os.tellp();
+	if (MStatus::kFailure == outputSets(os)) {
+		return MStatus::kFailure;
+	}
+	reportChannel("sets", os, start, fSetNames.size(), setFaceCount * sizeof(uint32_t));
+
+	if (fOptions.quantize) {
+		reportQuantization();
+	}
+
+	return os ? MStatus::kSuccess : MStatus::kFailure;
+}
+
+
+MStatus xcbWriterModel::outputPositions(std::ostream& os)
+//Summary:	outputs all vertex positions as float32 (x, y, z) triples, or
+//			quantized in their bounding box with the quantize option.  With
+//			the welded vertex table only that box is written here, for the
+//			table to be quantized in.
+//Args   :	os - an output stream to write to
+//Returns:	MStatus::kSuccess if all vertex positions were outputted
+//			MStatus::kFailure otherwise
+{
+	TraceScope scope(fTrace, "outputPositions", fShapeName.c_str());
+	const Float3Stream& positions = fSnapshot.positions;
+	const size_t count = positions.length();
+	if (0 == count) {
+		return MStatus::kFailure;
+	}
+
+	const bool vertexTable = writesVertexTable();
+	if (!fOptions.quantize) {
+		if (!vertexTable) {
+			outputVectorArray(os, xcb::kPositions, positions);
+		}
+		return MStatus::kSuccess;
+	}
+
+	positionBounds(positions, fPositionLow, fPositionHigh);
+	const float bounds[6] = { fPositionLow[0], fPositionLow[1], fPositionLow[2],
+		fPositionHigh[0], fPositionHigh[1], fPositionHigh[2] };
+	xcb::writeChunk(os, xcb::kPositionBounds, 2, bounds, sizeof(bounds));
+	fQuantization.quantizedBytes += sizeof(bounds);
+	if (vertexTable) {
+		return MStatus::kSuccess;
+	}
+
+	float scale[3];
+	positionScale(fPositionLow, fPositionHigh, scale);
+	std::vector<uint16_t> xyzw(4 * count);
+	exportKernels().quantizePositions(&positions.x[0], &positions.y[0], &positions.z[0], count,
+		fPositionLow, scale, &xyzw[0]);
+	xcb::writeChunk(os, xcb::kPositionsQ, static_cast<uint32_t>(count),
+		&xyzw[0], xyzw.size() * sizeof(uint16_t));
+
+	fQuantization.position = positionError(positions, &xyzw[0], fPositionLow, fPositionHigh);
+	fQuantization.floatBytes += 3 * count * sizeof(float);
+	fQuantization.quantizedBytes += xyzw.size() * sizeof(uint16_t);
+	return MStatus::kSuccess;
+}
+
+
+MStatus xcbWriterModel::outputNormals(std::ostream& os)
+//Summary:	outputs all normals as float32 (x, y, z) triples, unless they
+//			go out in the welded vertex table
+//Args   :	os - an output stream to write to
+//Returns:	MStatus::kSuccess if all normals were outputted
+//			MStatus::kFailure otherwise
+{
+	TraceScope scope(fTrace, "outputNormals", fShapeName.c_str());
+	if (!fOptions.normals) {
+		return MStatus::kSuccess;
+	}
+
+	if (0 == fSnapshot.normals.length()) {
+		return MStatus::kFailure;
+	}
+	if (writesVertexTable()) {
+		return MStatus::kSuccess;
+	}
+
+	if (fOptions.quantize) {
+		fQuantization.normal = outputOctahedralArray(os, xcb::kNormalsQ, fSnapshot.normals, false);
+	}
+	else {
+		outputVectorArray(os, xcb::kNormals, fSnapshot.normals);
+	}
+	return MStatus::kSuccess;
+}
+
+
+MStatus xcbWriterModel::outputTangents(std::ostream& os)
+//Summary:	outputs the tangents and binormals of the current uv set as float32
+//			(x, y, z) triples, if the export asks for them
+//Args   :	os - an output stream to write to
+//Returns:	MStatus::kSuccess if the requested arrays were outputted
+//			MStatus::kFailure otherwise
+{
+	TraceScope scope(fTrace, "outputTangents", fShapeName.c_str());
+	if (fOptions.quantize) {
+		if (fOptions.tangents) {
+			fQuantization.tangent = outputOctahedralArray(os, xcb::kTangentsQ, fSnapshot.tangents, true);
+		}
+		if (fOptions.binormals) {
+			fQuantization.binormal = outputOctahedralArray(os, xcb::kBinormalsQ, fSnapshot.binormals, true);
+		}
+		return MStatus::kSuccess;
+	}
+
+	if (fOptions.tangents) {
+		outputVectorArray(os, xcb::kTangents, fSnapshot.tangents);
+	}
+	if (fOptions.binormals) {
+		outputVectorArray(os, xcb::kBinormals, fSnapshot.binormals);
+	}
+	return MStatus::kSuccess;
+}
+
+
+MStatus xcbWriterModel::outputFaces(std::ostream& os)
+//Summary:	outputs the vertex count of every face and, unless the welded
+//			vertex table indexes them, the position and normal index of every
+//			face-vertex
+//Args   :	os - an output stream to write to
+//Returns:	MStatus::kSuccess if all faces were outputted
+//			MStatus::kFailure otherwise
+{
+	TraceScope scope(fTrace, "outputFaces", fShapeName.c_str());
+	outputIntArray(os, xcb::kFaceCounts, fFaceVertexCounts);
+	if (writesVertexTable()) {
+		return MStatus::kSuccess;
+	}
+	outputIntArray(os, xcb::kFacePositions, fFaceVertexIds);
+	if (fOptions.normals) {
+		outputIntArray(os, xcb::kFaceNormals, fFaceNormalIds);
+	}
+	return MStatus::kSuccess;
+}
+
+
+MStatus xcbWriterModel::outputUVs(std::ostream& os)
+//Summary:	for each UV Set, outputs its name, its (u, v) coordinates and the uv
+//			index of every face-vertex; face-vertices without a uv in that set
+//			get xcb::kUnassigned.  With the quantize option the coordinates
+//			are written as half floats.  With the welded vertex table only
+//			the names are written, in the order of the uv columns of the
+//			table.
+//Args   :	os - an output stream to write to
+//Returns:	MStatus::kSuccess if all UV sets were outputted
+//			MStatus::kFailure otherwise
+{
+	TraceScope scope(fTrace, "outputUVs", fShapeName.c_str());
+	std::vector<float> uvs;
+	std::vector<uint16_t> halves;
+
+	size_t s;
+	for (s = 0; s < fUVSets.size(); s++) {
+		const UVSet& uvSet = fUVSets[s];
+		const std::streamoff start = os.tellp();
+		xcb::writeStringChunk(os, xcb::kUVSetName, uvSet.name.c_str(), uvSet.name.size());
+		if (writesVertexTable()) {
+			continue;
+		}
+
+		unsigned int uvCount = static_cast<unsigned int>(uvSet.uArray.size());
+		uvs.resize(2 * uvCount);
+		if (0 != uvCount) {
+			exportKernels().interleaveUVs(&uvSet.uArray[0], &uvSet.vArray[0], &uvs[0], uvCount);
+		}
+		if (fOptions.quantize) {
+			halves.resize(uvs.size());
+			if (0 != uvCount) {
+				exportKernels().floatsToHalves(&uvs[0], &halves[0], uvs.size());
+				const double error = halfError(&uvs[0], &halves[0], uvs.size());
+				fQuantization.uv = error > fQuantization.uv ? error : fQuantization.uv;
+			}
+			xcb::writeChunk(os, xcb::kUVsQ, uvCount,
+				halves.empty() ? NULL : &halves[0], halves.size() * sizeof(uint16_t));
+			fQuantization.floatBytes += uvs.size() * sizeof(float);
+			fQuantization.quantizedBytes += halves.size() * sizeof(uint16_t);
+		}
+		else {
+			xcb::writeChunk(os, xcb::kUVs, uvCount,
+				uvs.empty() ? NULL : &uvs[0], uvs.size() * sizeof(float));
+		}
+
+		outputIntArray(os, xcb::kFaceUVs, uvSet.faceUVIds);
+		reportChannel("uvs:" + uvSet.name, os, start,
+			uvCount, uvs.size() * sizeof(float) + uvSet.faceUVIds.size() * sizeof(uint32_t));
+	}
+
+	return MStatus::kSuccess;
+}
+
+
+MStatus xcbWriterModel::outputIndexedVertices(std::ostream& os)
+//Summary:	welds the (position, normal, uv per set) tuple of every face-vertex
+//			into a table of unique vertices and outputs that table together
+//			with the vertex index of each face-vertex.  Unassigned uvs are
+//			written as (0, 0).  In triangulated mode the triangles are built
+//			here as well, since the vertex cache pass renumbers the table.
+//			With the quantize option the table is written quantized.  Does
+//			nothing unless writesVertexTable().
+//Args   :	os - an output stream to write to
+//Returns:	MStatus::kSuccess if the vertex table and indices were outputted
+//			MStatus::kFailure otherwise
+{
+	TraceScope scope(fTrace, "outputIndexedVertices", fShapeName.c_str());
+	if (!writesVertexTable()) {
+		return MStatus::kSuccess;
+	}
+
+	const unsigned int faceVertexCount = static_cast<unsigned int>(fFaceVertexIds.size());
+	const unsigned int normalFloats = fOptions.normals ? 3 : 0;
+	const unsigned int stride = 3 + normalFloats + 2 * static_cast<unsigned int>(fUVSets.size());
+
+	VertexWelder welder(stride, faceVertexCount);
+	std::vector<uint32_t>& indices = fVertexIndices;
+	indices.resize(faceVertexCount);
+	std::vector<float> tuple(stride);
+	const Float3Stream& positions = fSnapshot.positions;
+	const Float3Stream& normals = fSnapshot.normals;
+
+	unsigned int i;
+	for (i = 0; i < faceVertexCount; i++) {
+		const int position = fFaceVertexIds[i];
+		tuple[0] = positions.x[position];
+		tuple[1] = positions.y[position];
+		tuple[2] = positions.z[position];
+		if (fOptions.normals) {
+			const int normal = fFaceNormalIds[i];
+			tuple[3] = normals.x[normal];
+			tuple[4] = normals.y[normal];
+			tuple[5] = normals.z[normal];
+		}
+
+		float* uv = &tuple[3 + normalFloats];
+		size_t s;
+		for (s = 0; s < fUVSets.size(); s++, uv += 2) {
+			const int uvId = fUVSets[s].faceUVIds[i];
+			uv[0] = uvId < 0 ? 0.0f : fUVSets[s].uArray[uvId];
+			uv[1] = uvId < 0 ? 0.0f : fUVSets[s].vArray[uvId];
+		}
+
+		indices[i] = welder.weld(&tuple[0]);
+	}
+
+	fVertices = welder.vertices();
+	fVertexStride = stride;
+
+	if (fOptions.triangulate) {
+		buildTriangles();
+		if (fOptions.vertexCache) {
+			optimizeVertexCache();
+		}
+	}
+
+	std::streamoff start = os.tellp();
+	if (fOptions.quantize) {
+		outputQuantizedVertices(os);
+	}
+	else {
+		xcb::writeChunk(os, xcb::kVertices, welder.vertexCount(),
+			fVertices.empty() ? NULL : &fVertices[0], fVertices.size() * sizeof(float));
+	}
+	reportChannel("vertices", os, start, welder.vertexCount(), fVertices.size() * sizeof(float));
+
+	start = os.tellp();
+	xcb::writeChunk(os, xcb::kVertexIndices, faceVertexCount,
+		indices.empty() ? NULL : &indices[0], indices.size() * sizeof(uint32_t));
+	reportChannel("indices", os, start, faceVertexCount, indices.size() * sizeof(uint32_t));
+	return MStatus::kSuccess;
+}
+
+
+MStatus xcbWriterModel::outputTriangles(std::ostream& os)
+//Summary:	in triangulated mode, outputs the triangle list built by
+//			outputIndexedVertices and the face each triangle was cut from
+//Args   :	os - an output stream to write to
+//Returns:	MStatus::kSuccess if the triangles were outputted
+//			MStatus::kFailure otherwise
+{
+	TraceScope scope(fTrace, "outputTriangles", fShapeName.c_str());
+	if (!fOptions.triangulate) {
+		return MStatus::kSuccess;
+	}
+
+	const uint32_t triangleCount = static_cast<uint32_t>(fTriangleFaces.size());
+	xcb::writeChunk(os, xcb::kTriangles, triangleCount,
+		fTriangles.empty() ? NULL : &fTriangles[0], fTriangles.size() * sizeof(uint32_t));
+	xcb::writeChunk(os, xcb::kTriangleFaces, triangleCount,
+		fTriangleFaces.empty() ? NULL : &fTriangleFaces[0], fTriangleFaces.size() * sizeof(uint32_t));
+	return MStatus::kSuccess;
+}
+
+
+MStatus xcbWriterModel::outputMeshlets(std::ostream& os)
+//Summary:	in triangulated mode, if the export asks for them, cuts the
+//			triangle list into meshlets and outputs them with the meshlet
+//			vertex and triangle arrays.  Every mesh is encoded by its own job,
+//			so meshes are clustered in parallel.
+//Args   :	os - an output stream to write to
+//Returns:	MStatus::kSuccess if the meshlets were outputted
+//			MStatus::kFailure otherwise
+{
+	TraceScope scope(fTrace, "outputMeshlets", fShapeName.c_str());
+	if (!fOptions.triangulate || !fOptions.meshlets) {
+		return MStatus::kSuccess;
+	}
+
+	const size_t triangleCount = fTriangleFaces.size();
+	const size_t vertexCount = 0 == fVertexStride ? 0 : fVertices.size() / fVertexStride;
+
+	//no meshlet spans two set batches, so every set is drawn by a
+	//contiguous range of meshlets
+	//
+	std::vector<uint32_t> breaks;
+	size_t r;
+	for (r = 0; r < fSetTriangleRanges.size(); r += 2) {
+		breaks.push_back(fSetTriangleRanges[r]);
+	}
+
+	Meshlets meshlets;
+	buildMeshlets(fTriangles.empty() ? NULL : &fTriangles[0], triangleCount,
+		fVertices.empty() ? NULL : &fVertices[0], fVertexStride, vertexCount,
+		breaks.empty() ? NULL : &breaks[0], breaks.size(), meshlets);
+
+	fSetMeshletRanges.resize(fSetTriangleRanges.size());
+	for (r = 0; r < fSetTriangleRanges.size(); r += 2) {
+		const uint32_t first = fSetTriangleRanges[r];
+		const uint32_t end = first + fSetTriangleRanges[r + 1];
+		size_t m = 0;
+		while (m < meshlets.meshlets.size() && meshlets.meshlets[m].triangleOffset < first) {
+			m++;
+		}
+		size_t n = m;
+		while (n < meshlets.meshlets.size() && meshlets.meshlets[n].triangleOffset < end) {
+			n++;
+		}
+		fSetMeshletRanges[r] = static_cast<uint32_t>(m);
+		fSetMeshletRanges[r + 1] = static_cast<uint32_t>(n - m);
+	}
+
+	const uint32_t meshletCount = static_cast<uint32_t>(meshlets.meshlets.size());
+	const std::streamoff start = os.tellp();
+	xcb::writeChunk(os, xcb::kMeshlets, meshletCount,
+		meshlets.meshlets.empty() ? NULL : &meshlets.meshlets[0],
+		meshlets.meshlets.size() * sizeof(xcb::Meshlet));
+	xcb::writeChunk(os, xcb::kMeshletVertices, static_cast<uint32_t>(meshlets.vertices.size()),
+		meshlets.vertices.empty() ? NULL : &meshlets.vertices[0],
+		meshlets.vertices.size() * sizeof(uint32_t));
+	xcb::writeChunk(os, xcb::kMeshletTriangles, static_cast<uint32_t>(triangleCount),
+		meshlets.triangles.empty() ? NULL : &meshlets.triangles[0], meshlets.triangles.size());
+	reportChannel("meshlets", os, start, meshletCount,
+		meshlets.meshlets.size() * sizeof(xcb::Meshlet) + meshlets.vertices.size() * sizeof(uint32_t) +
+		meshlets.triangles.size() * sizeof(uint32_t));
+
+	if (0 != meshletCount) {
+		std::ostringstream message;
+		message << "Meshlets of " << fShapeName << ": " << meshletCount << ", "
+			<< static_cast<double>(meshlets.vertices.size()) / meshletCount << " vertices and "
+			<< static_cast<double>(triangleCount) / meshletCount << " triangles on average";
+		reportInfo(message.str());
+	}
+	return MStatus::kSuccess;
+}
+
+
+void xcbWriterModel::buildTriangles()
+//Summary:	maps the triangulation of every face onto the welded vertex table,
+//			batched set after set (see batchTrianglesBySet), and records the
+//			face each triangle was cut from
+{
+	batchTrianglesBySet();
+
+	std::vector<int> triangleFaces;
+	getTriangleFaces(triangleFaces);
+
+	const size_t triangleCount = fTriangleOrder.size();
+	fTriangles.resize(3 * triangleCount);
+	fTriangleFaces.resize(triangleCount);
+
+	size_t i;
+	for (i = 0; i < triangleCount; i++) {
+		const unsigned int triangle = fTriangleOrder[i];
+		fTriangles[3 * i] = fVertexIndices[fTriangleVertices[3 * triangle]];
+		fTriangles[3 * i + 1] = fVertexIndices[fTriangleVertices[3 * triangle + 1]];
+		fTriangles[3 * i + 2] = fVertexIndices[fTriangleVertices[3 * triangle + 2]];
+		fTriangleFaces[i] = static_cast<uint32_t>(triangleFaces[triangle]);
+	}
+}
+
+
+void xcbWriterModel::optimizeVertexCache()
+//Summary:	reorders the triangles of every set batch for the post-transform
+//			vertex cache, then renumbers the welded vertices in first-use
+//			order and applies that numbering to the vertex table, the
+//			face-vertex indices and the triangles.  Reports ACMR and ATVR
+//			before and after.
+{
+	TraceScope scope(fTrace, "optimizeVertexCache", fShapeName.c_str());
+	const size_t triangleCount = fTriangleFaces.size();
+	const size_t vertexCount = 0 == fVertexStride ? 0 : fVertices.size() / fVertexStride;
+	const VertexCacheStats before = measureVertexCache(
+		fTriangles.empty() ? NULL : &fTriangles[0], triangleCount, vertexCount, kReportedCacheSize);
+
+	//every batch is ordered on its own, over its vertices renumbered from
+	//0, so that the batches stay contiguous and each costs time linear in
+	//its own size
+	//
+	std::vector<uint32_t> order(triangleCount);
+	std::vector<uint32_t> localIndex(vertexCount, xcb::kUnassigned);
+	std::vector<uint32_t> localVertices;
+	std::vector<uint32_t> localTriangles;
+	std::vector<uint32_t> localOrder;
+	size_t i;
+	size_t r;
+	for (r = 0; r < fSetTriangleRanges.size(); r += 2) {
+		const size_t first = fSetTriangleRanges[r];
+		const size_t count = fSetTriangleRanges[r + 1];
+		if (0 == count) {
+			continue;
+		}
+
+		localVertices.clear();
+		localTriangles.resize(3 * count);
+		for (i = 0; i < 3 * count; i++) {
+			const uint32_t vertex = fTriangles[3 * first + i];
+			if (xcb::kUnassigned == localIndex[vertex]) {
+				localIndex[vertex] = static_cast<uint32_t>(localVertices.size());
+				localVertices.push_back(vertex);
+			}
+			localTriangles[i] = localIndex[vertex];
+		}
+
+		vertexCacheOrder(&localTriangles[0], count, localVertices.size(), localOrder);
+		for (i = 0; i < count; i++) {
+			order[first + i] = static_cast<uint32_t>(first + localOrder[i]);
+		}
+
+		for (i = 0; i < localVertices.size(); i++) {
+			localIndex[localVertices[i]] = xcb::kUnassigned;
+		}
+	}
+
+	std::vector<uint32_t> triangles(fTriangles.size());
+	std::vector<uint32_t> triangleFaces(triangleCount);
+	for (i = 0; i < triangleCount; i++) {
+		triangles[3 * i] = fTriangles[3 * order[i]];
+		triangles[3 * i + 1] = fTriangles[3 * order[i] + 1];
+		triangles[3 * i + 2] = fTriangles[3 * order[i] + 2];
+		triangleFaces[i] = fTriangleFaces[order[i]];
+	}
+
+	std::vector<uint32_t> remap;
+	firstUseOrder(triangles.empty() ? NULL : &triangles[0], triangles.size(), vertexCount, remap);
+
+	std::vector<float> vertices(fVertices.size());
+	for (i = 0; i < vertexCount; i++) {
+		std::copy(&fVertices[0] + i * fVertexStride, &fVertices[0] + (i + 1) * fVertexStride,
+			&vertices[0] + remap[i] * fVertexStride);
+	}
+	for (i = 0; i < triangles.size(); i++) {
+		triangles[i] = remap[triangles[i]];
+	}
+	for (i = 0; i < fVertexIndices.size(); i++) {
+		fVertexIndices[i] = remap[fVertexIndices[i]];
+	}
+
+	fVertices.swap(vertices);
+	fTriangles.swap(triangles);
+	fTriangleFaces.swap(triangleFaces);
+
+	const VertexCacheStats after = measureVertexCache(
+		fTriangles.empty() ? NULL : &fTriangles[0], triangleCount, vertexCount, kReportedCacheSize);
+
+	std::ostringstream message;
+	message << "Vertex cache of " << fShapeName << ": ACMR " << before.acmr << " -> " << after.acmr
+		<< ", ATVR " << before.atvr << " -> " << after.atvr
+		<< " (FIFO of " << kReportedCacheSize << ")";
+	reportInfo(message.str());
+}
+
+
+void xcbWriterModel::outputQuantizedVertices(std::ostream& os)
+//Summary:	outputs the welded vertex table with every vertex packed as a
+//			unorm16 position in the bounding box of the mesh, an octahedral
+//			snorm16 normal and half float uvs, see xcbFormat.h.  The float
+//			table stays as it is for the meshlet bounds.
+//Args   :	os - an output stream to write to
+{
+	const size_t vertexCount = 0 == fVertexStride ? 0 : fVertices.size() / fVertexStride;
+	const size_t uvFloats = 2 * fUVSets.size();
+	const size_t uvOffset = fOptions.normals ? 6 : 3;
+	const size_t stride = 4 * sizeof(uint16_t) + (fOptions.normals ? 2 * sizeof(int16_t) : 0) +
+		uvFloats * sizeof(uint16_t);
+
+	std::vector<uint8_t> table(vertexCount * stride);
+	if (0 != vertexCount) {
+		//split the table into streams for the kernels
+		//
+		Float3Stream columns;
+		columns.resize(vertexCount);
+		std::vector<float> uvs(vertexCount * uvFloats);
+		size_t i;
+		for (i = 0; i < vertexCount; i++) {
+			const float* vertex = &fVertices[i * fVertexStride];
+			columns.x[i] = vertex[0];
+			columns.y[i] = vertex[1];
+			columns.z[i] = vertex[2];
+			std::copy(vertex + uvOffset, vertex + uvOffset + uvFloats, uvs.begin() + i * uvFloats);
+		}
+
+		float scale[3];
+		positionScale(fPositionLow, fPositionHigh, scale);
+		std::vector<uint16_t> positions(4 * vertexCount);
+		exportKernels().quantizePositions(&columns.x[0], &columns.y[0], &columns.z[0], vertexCount,
+			fPositionLow, scale, &positions[0]);
+		fQuantization.position = positionError(columns, &positions[0], fPositionLow, fPositionHigh);
+
+		std::vector<int16_t> normals;
+		if (fOptions.normals) {
+			for (i = 0; i < vertexCount; i++) {
+				const float* vertex = &fVertices[i * fVertexStride];
+				columns.x[i] = vertex[3];
+				columns.y[i] = vertex[4];
+				columns.z[i] = vertex[5];
+			}
+			normals.resize(2 * vertexCount);
+			exportKernels().octahedralSnorm16(&columns.x[0], &columns.y[0], &columns.z[0], vertexCount,
+				&normals[0]);
+			fQuantization.normal = octahedralError(columns, &normals[0]);
+		}
+
+		std::vector<uint16_t> halves(uvs.size());
+		if (!uvs.empty()) {
+			exportKernels().floatsToHalves(&uvs[0], &halves[0], uvs.size());
+			fQuantization.uv = halfError(&uvs[0], &halves[0], uvs.size());
+		}
+
+		for (i = 0; i < vertexCount; i++) {
+			uint8_t* vertex = &table[i * stride];
+			memcpy(vertex, &positions[4 * i], 4 * sizeof(uint16_t));
+			vertex += 4 * sizeof(uint16_t);
+			if (fOptions.normals) {
+				memcpy(vertex, &normals[2 * i], 2 * sizeof(int16_t));
+				vertex += 2 * sizeof(int16_t);
+			}
+			if (0 != uvFloats) {
+				memcpy(vertex, &halves[i * uvFloats], uvFloats * sizeof(uint16_t));
+			}
+		}
+	}
+
+	xcb::writeChunk(os, xcb::kVerticesQ, static_cast<uint32_t>(vertexCount),
+		table.empty() ? NULL : &table[0], table.size());
+	fQuantization.floatBytes += fVertices.size() * sizeof(float);
+	fQuantization.quantizedBytes += table.size();
+}
+
+
+void xcbWriterModel::reportQuantization()
+//Summary:	reports the largest error of every quantized channel and the
+//			size of the vertex data with and without quantization
+{
+	std::ostringstream message;
+	message << "Quantization of " << fShapeName << ": position error " << fQuantization.position;
+	if (fOptions.normals) {
+		message << ", normal " << fQuantization.normal << " deg";
+	}
+	if (fOptions.tangents) {
+		message << ", tangent " << fQuantization.tangent << " deg";
+	}
+	if (fOptions.binormals) {
+		message << ", binormal " << fQuantization.binormal << " deg";
+	}
+	if (!fUVSets.empty()) {
+		message << ", uv " << fQuantization.uv;
+	}
+	message << "; vertex data " << fQuantization.floatBytes << " -> "
+		<< fQuantization.quantizedBytes << " bytes";
+	reportInfo(message.str());
+}
+
+
+bool xcbWriterModel::writesVertexTable() const
+//Summary:	returns true if this shape is written as the welded vertex table
+//			rather than as separate channels with face-vertex index lists
+{
+	return fOptions.indexed || fOptions.triangulate;
+}
+
+
+MStatus xcbWriterModel::outputSingleSet(std::ostream& os, unsigned int set)
+//Summary:	outputs a set's name, its texture file, its faces as (start,
+//			count) ranges and, in triangulated mode, the range of its
+//			triangles and meshlets
+//Args   :	os - an output stream to write to
+//			set - index of the set in fSetNames
+//Returns:	MStatus::kSuccess if set information was outputted
+//			MStatus::kFailure otherwise
+{
+	const std::string& setName = fSetNames[set];
+	const std::string& textureName = fSetTextures[set];
+	const std::vector<uint32_t>& faceRanges = fSetFaceRanges[set];
+
+	xcb::writeStringChunk(os, xcb::kSetName, setName.c_str(), setName.size());
+	xcb::writeStringChunk(os, xcb::kSetTexture, textureName.c_str(), textureName.size());
+	xcb::writeChunk(os, xcb::kSetFaceRanges, static_cast<uint32_t>(faceRanges.size() / 2),
+		faceRanges.empty() ? NULL : &faceRanges[0], faceRanges.size() * sizeof(uint32_t));
+
+	if (fOptions.triangulate) {
+		xcb::writeChunk(os, xcb::kSetTriangles, 1,
+			&fSetTriangleRanges[2 * set], 2 * sizeof(uint32_t));
+		if (fOptions.meshlets) {
+			xcb::writeChunk(os, xcb::kSetMeshlets, 1,
+				&fSetMeshletRanges[2 * set], 2 * sizeof(uint32_t));
+		}
+	}
+	return MStatus::kSuccess;
+}
+
+
+size_t xcbWriterModel::heldBytes() const
+//Summary:	returns the bytes held by the mesh buffers, including the welded
+//			vertex table and the triangle list of this writer
+{
+	return WriterModel::heldBytes() + fVertices.capacity() * sizeof(float) +
+		(fVertexIndices.capacity() + fTriangles.capacity() + fTriangleFaces.capacity() +
+		fSetMeshletRanges.capacity()) * sizeof(uint32_t);
+}
+
+
+void xcbWriterModel::outputVectorArray(std::ostream& os, uint32_t id, const Float3Stream& array)
+//Summary:	writes a snapshot stream as a chunk of float32 (x, y, z) triples
+//Args   :	os - an output stream to write to
+//			id - the chunk id
+//			array - the vectors
+{
+	const size_t count = array.length();
+	std::vector<float> values;
+	array.interleave(values);
+	xcb::writeChunk(os, id, static_cast<uint32_t>(count),
+		values.empty() ? NULL : &values[0], values.size() * sizeof(float));
+}
+
+
+double xcbWriterModel::outputOctahedralArray(std::ostream& os, uint32_t id,
+	const Float3Stream& array, bool snorm8)
+//Summary:	writes a snapshot stream as a chunk of octahedral (u, v) pairs
+//Args   :	os - an output stream to write to
+//			id - the chunk id
+//			array - the vectors
+//			snorm8 - write snorm8 pairs rather than snorm16 ones
+//Returns:	the largest angle error, in degrees
+{
+	const size_t count = array.length();
+	double error = 0.0;
+	size_t bytes;
+	if (snorm8) {
+		std::vector<int8_t> uv(2 * count);
+		if (0 != count) {
+			exportKernels().octahedralSnorm8(&array.x[0], &array.y[0], &array.z[0], count, &uv[0]);
+			error = octahedralError(array, &uv[0]);
+		}
+		bytes = uv.size() * sizeof(int8_t);
+		xcb::writeChunk(os, id, static_cast<uint32_t>(count), uv.empty() ? NULL : &uv[0], bytes);
+	}
+	else {
+		std::vector<int16_t> uv(2 * count);
+		if (0 != count) {
+			exportKernels().octahedralSnorm16(&array.x[0], &array.y[0], &array.z[0], count, &uv[0]);
+			error = octahedralError(array, &uv[0]);
+		}
+		bytes = uv.size() * sizeof(int16_t);
+		xcb::writeChunk(os, id, static_cast<uint32_t>(count), uv.empty() ? NULL : &uv[0], bytes);
+	}
+	fQuantization.floatBytes += 3 * count * sizeof(float);
+	fQuantization.quantizedBytes += bytes;
+	return error;
+}
+
+
+void xcbWriterModel::outputIntArray(std::ostream& os, uint32_t id, const std::vector<int>& array)
+//Summary:	writes an int array as a uint32 chunk
+//Args   :	os - an output stream to write to
+//			id - the chunk id
+//			array - the values; negative values end up as xcb::kUnassigned
+{
+	xcb::writeChunk(os, id, static_cast<uint32_t>(array.size()),
+		array.empty() ? NULL : &array[0], array.size() * sizeof(uint32_t));
+}